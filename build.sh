@@ -1,3 +1,3 @@
 #!/bin/sh
-#clang -Wall -fsanitize=undefined -fsanitize=address -g -o sts cli.c -DSTS_GOTO_JIT -lm
-cc -Wall -g -o sts cli.c -DSTS_GOTO_JIT -lm
\ No newline at end of file
+#clang -Wall -fsanitize=undefined -fsanitize=address -g -o sts cli.c -DSTS_GOTO_JIT -lm -lpthread
+cc -Wall -g -o sts cli.c -DSTS_GOTO_JIT -lm -lpthread
\ No newline at end of file
@@ -1,2 +1,2 @@
 #!/bin/sh
-cc -Wall -fsanitize=undefined -fsanitize=address -g -o sts cli.c -DSTS_GOTO_JIT -DCLI_SYSTEM_SHELLPREFIX -lm
\ No newline at end of file
+cc -Wall -fsanitize=undefined -fsanitize=address -g -o sts cli.c -DSTS_GOTO_JIT -DCLI_SYSTEM_SHELLPREFIX -lm -lpthread
\ No newline at end of file
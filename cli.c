@@ -1,5 +1,15 @@
 /* this file is released into the public domain */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+	#define _GNU_SOURCE /* recvmmsg and sendmmsg */
+#endif
+
+/* file-map strings point into a refcounted file mapping instead of the heap */
+char *cli_map_share(char *data);
+void cli_map_release(char *data);
+#define STS_MAP_SHARE(data) cli_map_share(data)
+#define STS_UNMAP(data, size) cli_map_release(data)
+
 /* embedding the extras util is optional. The interpreter itself
 is able to run in an embedded environment without the extras, but
 it is much nicer to use with these */
@@ -14,12 +24,6 @@ it is much nicer to use with these */
 #include "ext/pdjson/pdjson.c"
 #undef init
 
-#define base64_encode base64_encode_ext
-#define base64_decode base64_decode_ext
-#include "ext/base64/base64.h"
-#include "ext/base64/base64.c"
-#undef base64_encode
-#undef base64_decode
 
 #include "ext/Monocypher/src/monocypher.h"
 #include "ext/Monocypher/src/monocypher.c"
@@ -41,6 +45,17 @@ it is much nicer to use with these */
 #include <string.h>
 #include <unistd.h>
 #include <time.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <stdint.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
 
 #if defined (_WIN64) || defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
 #include <windows.h>
@@ -48,6 +63,105 @@ it is much nicer to use with these */
 #else 
 #include <sys/types.h>
 #include <dirent.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <netinet/tcp.h>
+#include <limits.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+#ifndef IOV_MAX
+	#define IOV_MAX 1024 /* only visible with some feature macros. 1024 is what linux and the bsds use */
+#endif
+#endif
+
+#ifndef O_CLOEXEC
+	#define O_CLOEXEC 0
+#endif
+
+#if defined(CLI_WINDOWS) && !defined(CLI_NO_THREADS)
+	#define CLI_NO_THREADS
+#endif
+
+#ifndef CLI_NO_THREADS
+#define STS_PARALLEL_IMPLEMENTATION
+#include "sts_parallel.h"
+#endif
+
+#if defined(CLI_WINDOWS) && !defined(CLI_NO_COROUTINES)
+	#define CLI_NO_COROUTINES
+#endif
+
+#if (!defined(__linux__) || defined(CLI_NO_SOCKETS)) && !defined(CLI_NO_POLLER)
+	#define CLI_NO_POLLER
+#endif
+
+#ifndef CLI_NO_POLLER
+#include <sys/epoll.h>
+#endif
+
+#if defined(CLI_WINDOWS) && !defined(CLI_NO_PROCESSES)
+	#define CLI_NO_PROCESSES
+#endif
+
+#ifndef CLI_NO_PROCESSES
+#include <spawn.h>
+#if defined(__linux__) && defined(CLI_NO_POLLER)
+#include <sys/epoll.h>
+#endif
+#include <sys/wait.h>
+
+extern char **environ;
+#endif
+
+#if defined(CLI_WINDOWS) && !defined(CLI_NO_DIRECTORY_WALK)
+	#define CLI_NO_DIRECTORY_WALK
+#endif
+
+#ifndef CLI_NO_DIRECTORY_WALK
+#include <fnmatch.h>
+#endif
+
+#if !defined(__linux__) && !defined(CLI_NO_WATCH)
+	#define CLI_NO_WATCH
+#endif
+
+#ifndef CLI_NO_WATCH
+#include <sys/inotify.h>
+#endif
+
+#if (!defined(__linux__) || defined(CLI_NO_COROUTINES)) && !defined(CLI_NO_TIMERS)
+	#define CLI_NO_TIMERS
+#endif
+
+#ifndef CLI_NO_TIMERS
+#include <sys/timerfd.h>
+#endif
+
+#if (defined(CLI_WINDOWS) || defined(CLI_NO_SOCKETS)) && !defined(CLI_NO_SERVE)
+	#define CLI_NO_SERVE
+#endif
+
+#ifndef CLI_NO_SERVE
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <sys/wait.h>
+#endif
+
+#ifndef CLI_NO_COROUTINES
+#include <stdint.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+
+#ifndef CLI_COROUTINE_STACK_SIZE
+	#define CLI_COROUTINE_STACK_SIZE (1024 * 1024) /* only virtual memory. Pages are only really used once the coroutine touches them */
+#endif
+
+#ifndef CLI_COROUTINE_STACK_CACHE
+	#define CLI_COROUTINE_STACK_CACHE 64
+#endif
 #endif
 
 /* =========================================== */
@@ -67,1130 +181,7531 @@ it is much nicer to use with these */
 	#define INSTALL_DIR "/usr/local/bin/"
 #endif
 
+#ifndef CLI_SENDFILE_CHUNK
+	#define CLI_SENDFILE_CHUNK 65536 /* read size when socket-tcp-sendfile cant use sendfile */
+#endif
+
+#ifndef CLI_SOCKET_BUFFER_SIZE
+	#define CLI_SOCKET_BUFFER_SIZE 16384 /* starting size of the buffer socket-read-* uses. It grows for longer reads */
+#endif
+
+#ifndef CLI_SOCKET_BUFFER_MAX
+	#define CLI_SOCKET_BUFFER_MAX 16777216 /* the socket buffer never grows past this, so a peer that never sends the delimiter can't use up memory */
+#endif
+
+#ifndef CLI_FILE_BUFFER_SIZE
+	#define CLI_FILE_BUFFER_SIZE 262144 /* starting size of the buffer of file-open handles and stdin-read-line. It grows for longer lines */
+#endif
+
+#ifndef CLI_WRITER_BUFFER_SIZE
+	#define CLI_WRITER_BUFFER_SIZE 65536 /* default buffer of file-writer handles */
+#endif
+
+#ifndef CLI_JSON_WRITE_CHUNK
+	#define CLI_JSON_WRITE_CHUNK 65536 /* how much json-write builds up before handing it to the file-writer or socket */
+#endif
+
+#ifndef CLI_HASH_READ_SIZE
+	#define CLI_HASH_READ_SIZE 1048576 /* how much file-hash reads at a time */
+#endif
+
+#ifndef CLI_PROCESS_READ_SIZE
+	#define CLI_PROCESS_READ_SIZE 65536 /* how much process-run-parallel reads from a child at a time */
+#endif
+
+#ifndef CLI_UDP_DATAGRAM_SIZE
+	#define CLI_UDP_DATAGRAM_SIZE 65536 /* room for every datagram socket-udp-recv-batch gets. Untouched pages of it are never really used */
+#endif
+
+#ifndef CLI_UDP_BATCH_MAX
+	#define CLI_UDP_BATCH_MAX 1024 /* most datagrams one recvmmsg or sendmmsg call takes, which is what linux allows. Bigger receive batches are cut down to it */
+#endif
+
+#ifndef CLI_SERVE_RESTART_DELAY
+	#define CLI_SERVE_RESTART_DELAY 1 /* seconds a --serve worker that died less than this long after starting waits before it is started again */
+#endif
+
+#ifndef CLI_WATCH_BUFFER_SIZE
+	#define CLI_WATCH_BUFFER_SIZE 65536 /* how much of the event queue watch-wait reads at a time. Every event is 16 bytes plus its name */
+#endif
+
+#ifndef CLI_NO_COROUTINES
+enum cli_coroutine_states
+{
+	CLI_COROUTINE_READY,
+	CLI_COROUTINE_WAITING, /* in the wait queue of a coroutine or channel */
+	CLI_COROUTINE_WAITING_FD,
+	CLI_COROUTINE_DONE
+};
+
+typedef struct cli_coroutine_t cli_coroutine_t;
+
 typedef struct
+{
+	cli_coroutine_t *head, *tail;
+} cli_coroutine_queue_t;
+
+struct cli_coroutine_t
 {
 	unsigned long references;
-	zed_net_socket_t socket;
-	SSL *ssl;
-	char *name;
-} cli_socket_t;
+	cli_coroutine_t *next; /* the one queue this coroutine is in */
+	cli_coroutine_t *all_previous, *all_next;
+	cli_coroutine_queue_t awaiting;
+	ucontext_t context;
+	void *stack;
+	char state;
+	int fd;
+	short events, revents;
+	sts_value_t *function, *arguments, *result;
+	sts_script_t *script;
+};
 
-#define CLI_SOCKET(value) ((cli_socket_t *)value->external.data_ptr)
-#define IS_CLI_SOCKET(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_socket_refdec)
+typedef struct
+{
+	unsigned long references;
+	unsigned int capacity, length, start;
+	sts_value_t **values;
+	cli_coroutine_queue_t senders, receivers;
+} cli_channel_t;
 
-int cli_socket_refdec(sts_script_t *script, sts_value_t *value)
+typedef struct
+{
+	ucontext_t context; /* the interpreter that isnt inside of a coroutine */
+	cli_coroutine_t *all, *current;
+	cli_coroutine_queue_t ready, fds;
+	unsigned int count, stack_count;
+	void *stacks[CLI_COROUTINE_STACK_CACHE];
+} cli_scheduler_t;
+
+#ifndef CLI_NO_TIMERS
+/* timers sit in a hierarchical wheel of millisecond ticks. Every level has 64 slots that are 64 times as wide as the
+ones of the level below, so adding and cancelling a timer only links and unlinks it. A slot of a higher level is
+spread into the lower ones once the wheel turns to it */
+#define CLI_TIMER_LEVELS 4
+#define CLI_TIMER_BITS 6
+#define CLI_TIMER_SLOTS (1 << CLI_TIMER_BITS)
+
+typedef struct cli_timer_t
+{
+	unsigned long references; /* one for every handle and one while it is in the wheel */
+	struct cli_timer_t *previous, *next, **slot; /* the wheel slot or due list it is in. NULL when it is in neither */
+	uint64_t expires; /* the tick it fires on */
+	unsigned long period; /* ticks between firings for timer-every. 0 for timer-after */
+	char calling; /* set while its function runs, so cancelling from there stops a periodic one */
+	sts_value_t *function;
+} cli_timer_t;
+
+typedef struct
+{
+	int fd; /* timerfd, opened by the first timer */
+	char opened;
+	uint64_t now, armed; /* the tick the wheel turned to last and the tick fd is set for, which is 0 when it isnt */
+	unsigned long count; /* in the wheel or due */
+	uint64_t occupied[CLI_TIMER_LEVELS]; /* a bit for every slot that isnt empty */
+	cli_timer_t *slots[CLI_TIMER_LEVELS][CLI_TIMER_SLOTS];
+	cli_timer_t *due, *due_last; /* came due and waiting for the scheduler to call them in order */
+} cli_timers_t;
+#endif
+#endif
+
+/* a file from file-open, or stdin once stdin-read-line uses it. Lines are split out of one big buffer */
+typedef struct cli_file_t
 {
-	if(IS_CLI_SOCKET(value) && (!CLI_SOCKET(value)->references || !--CLI_SOCKET(value)->references))
+	unsigned long references;
+	int fd; /* -1 once file-close is used */
+	char pollable, borrowed; /* only pipes and terminals are worth letting other coroutines run while they wait. Stdin is borrowed, so it is never closed */
+	struct
 	{
-		zed_net_socket_close(&CLI_SOCKET(value)->socket);
-		if(CLI_SOCKET(value)->ssl)
-		{
-			SSL_shutdown(CLI_SOCKET(value)->ssl);
-			SSL_CTX_free(CLI_SOCKET(value)->ssl);
-		}
-		if(CLI_SOCKET(value)->name) free(CLI_SOCKET(value)->name);
-		free(value->external.data_ptr);
-	}
+		char *data;
+		unsigned long start, end, size; /* what is buffered is between start and end */
+	} buffer;
+} cli_file_t;
 
-	return 0;
+#define CLI_FILE(value) ((cli_file_t *)value->external.data_ptr)
+#define IS_CLI_FILE(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_file_refdec)
+
+void cli_file_close(cli_file_t *file)
+{
+	if(file->fd != -1 && !file->borrowed)
+		close(file->fd);
+	file->fd = -1;
+
+	if(file->buffer.data) free(file->buffer.data);
+	memset(&file->buffer, 0, sizeof(file->buffer));
 }
 
-void cli_socket_refinc(sts_script_t *script, sts_value_t *value)
+void cli_file_release(cli_file_t *file)
 {
-	if(IS_CLI_SOCKET(value))
-		CLI_SOCKET(value)->references++;
+	if(file->references && --file->references)
+		return;
+
+	cli_file_close(file);
+	free(file);
 }
 
-sts_value_t *cli_socket_new(sts_script_t *script)
+int cli_file_refdec(sts_script_t *script, sts_value_t *value)
 {
-	sts_value_t *ret = NULL;
+	if(IS_CLI_FILE(value))
+		cli_file_release(CLI_FILE(value));
+
+	return 0;
+}
 
+void cli_file_refinc(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_FILE(value))
+		CLI_FILE(value)->references++;
+}
 
-	if(!(ret = sts_value_create(script, STS_EXTERNAL)))
+/* a file from file-writer. Writes collect in the buffer until it fills, file-writer-flush is used, or the last reference goes away */
+typedef struct cli_writer_t
+{
+	unsigned long references;
+	int fd; /* -1 once file-writer-close is used */
+	struct
 	{
-		STS_ERROR_SIMPLE("could not create socket external value");
-		goto error;
-	}
+		char *data; /* NULL when unbuffered */
+		unsigned long length, size;
+	} buffer;
+} cli_writer_t;
 
-	ret->external.refdec = &cli_socket_refdec;
-	ret->external.refinc = &cli_socket_refinc;
+#define CLI_WRITER(value) ((cli_writer_t *)value->external.data_ptr)
+#define IS_CLI_WRITER(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_writer_refdec)
 
-	if(!(ret->external.data_ptr = calloc(1, sizeof(cli_socket_t))))
+/* writes all of data straight to the fd. Returns 0 or -1 */
+int cli_writer_write_fd(cli_writer_t *writer, char *data, unsigned long length)
+{
+	long written;
+
+
+	while(length)
 	{
-		STS_ERROR_SIMPLE("could not create socket type value");
-		goto error;
+		if((written = write(writer->fd, data, length)) == -1)
+		{
+			if(errno == EINTR)
+				continue;
+			return -1;
+		}
+
+		data += written;
+		length -= written;
 	}
 
-	CLI_SOCKET(ret)->references = 1;
+	return 0;
+}
+
+int cli_writer_flush(cli_writer_t *writer)
+{
+	int ret = 0;
+
+
+	if(writer->fd != -1 && writer->buffer.length)
+		ret = cli_writer_write_fd(writer, writer->buffer.data, writer->buffer.length);
+
+	writer->buffer.length = 0;
 
 	return ret;
-error:
-	if(ret) free(ret);
-	return NULL;
 }
 
-void debug_ast(sts_node_t *node, int level)
+int cli_writer_close(cli_writer_t *writer)
 {
-	int i;
-	
-	while(1)
+	int ret = 0;
+
+
+	if(writer->fd != -1)
 	{
-		for(i = 0; i < level; i++)
-		{
-			printf(" ");
-		}
-		
-		printf("%u:", node->line);
-		
-		switch(node->type)
-		{
-			case STS_NODE_EXPRESSION:
-				printf("expression:\n");
-				if(node->child)
-					debug_ast(node->child, level + 1);
-			break;
-			case STS_NODE_IDENTIFIER:
-				printf("ident: '%s'\n", node->value->string.data);
-			break;
-			case STS_NODE_VALUE:
-				if(node->value)
-				{
-					switch(node->value->type)
-					{
-						case STS_ARRAY:
-							printf("array(%u): \n", node->value->references);
-						break;
-						case STS_EXTERNAL:
-							printf("external(%u): \n", node->value->references);
-						break;
-						case STS_NUMBER:
-							printf("number(%u): %f\n", node->value->references, node->value->number);
-						break;
-						case STS_STRING:
-							printf("string(%u): '%s'\n", node->value->references, node->value->string.data);
-						break;
-					}
-				}
-				else
-					printf("null value\n");
-			break;
-		}
-		if(!(node = node->next))
-			break;
+		ret = cli_writer_flush(writer);
+		if(close(writer->fd))
+			ret = -1;
+		writer->fd = -1;
 	}
-}
 
-int amemcat(char **dest, unsigned long *dest_len, char *src, unsigned long src_len)
-{
-	char *temp = NULL;
+	if(writer->buffer.data) free(writer->buffer.data);
+	memset(&writer->buffer, 0, sizeof(writer->buffer));
 
+	return ret;
+}
 
-	if(!dest || !dest_len) return 1;
+void cli_writer_release(cli_writer_t *writer)
+{
+	if(writer->references && --writer->references)
+		return;
 
-	if(!(temp = realloc(*dest, *dest_len + src_len + 1)))
-		return 1;
-	
-	memcpy(&temp[*dest_len], src, src_len);
-	temp[*dest_len + src_len] = 0;
+	if(cli_writer_close(writer))
+		fprintf(stderr, "could not flush a file-writer before it was freed\n");
+	free(writer);
+}
 
-	*dest = temp;
-	*dest_len += src_len;
+int cli_writer_refdec(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_WRITER(value))
+		cli_writer_release(CLI_WRITER(value));
 
 	return 0;
 }
 
-int equal_open_close(char *input)
+void cli_writer_refinc(sts_script_t *script, sts_value_t *value)
 {
-	unsigned int i = 0, open = 0, close = 0, instring = 0;
+	if(IS_CLI_WRITER(value))
+		CLI_WRITER(value)->references++;
+}
 
+#ifndef CLI_NO_PROCESSES
+/* a child from process-spawn. Its stdout and stderr are file handles, so file-read-line works on them */
+typedef struct cli_process_t
+{
+	unsigned long references;
+	pid_t pid;
+	int status; /* the exit code once waited is set */
+	char waited;
+	cli_file_t *out, *err;
+} cli_process_t;
 
-	if(!input) return 0;
+#define CLI_PROCESS(value) ((cli_process_t *)value->external.data_ptr)
+#define IS_CLI_PROCESS(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_process_refdec)
 
-	for(; i < strlen(input); ++i)
+/* children that were let go of before they exited. Every later release tries to reap them again */
+pid_t *cli_process_unreaped = NULL;
+unsigned int cli_process_unreaped_length = 0, cli_process_unreaped_allocated = 0;
+
+void cli_process_release(cli_process_t *process)
+{
+	pid_t *temp = NULL;
+	unsigned int i;
+
+
+	if(process->references && --process->references)
+		return;
+
+	for(i = 0; i < cli_process_unreaped_length;)
+		if(waitpid(cli_process_unreaped[i], NULL, WNOHANG) != 0)
+			cli_process_unreaped[i] = cli_process_unreaped[--cli_process_unreaped_length];
+		else
+			i++;
+
+	/* one that is still running is left for a later release rather than blocking on it */
+	if(!process->waited && waitpid(process->pid, NULL, WNOHANG) == 0)
 	{
-		switch(instring)
+		if(cli_process_unreaped_length == cli_process_unreaped_allocated && (temp = realloc(cli_process_unreaped, (cli_process_unreaped_allocated + 16) * sizeof(pid_t))))
 		{
-			case 0:
-				if(input[i] == '\"')
-					instring = 1;
-				else if(input[i] == '(' || input[i] == '{' || input[i] == '[')
-					open++;
-				else if(input[i] == ')' || input[i] == '}' || input[i] == ']')
-					close++;
-			break;
-			case 1:
-				if(input[i] == '\\' && input[i] == '\"')
-					continue;
-				else if(input[i] == '\"')
-					instring = 0;
-			break;
+			cli_process_unreaped = temp;
+			cli_process_unreaped_allocated += 16;
 		}
+
+		if(cli_process_unreaped_length < cli_process_unreaped_allocated)
+			cli_process_unreaped[cli_process_unreaped_length++] = process->pid;
 	}
 
-	return (open == close);
+	cli_file_release(process->out);
+	cli_file_release(process->err);
+	free(process);
 }
 
-/* TODO: maybe dont make this recursive */
-sts_value_t *sts_value_from_json(sts_script_t *script, json_stream *json, char *json_str, unsigned long length)
+int cli_process_refdec(sts_script_t *script, sts_value_t *value)
 {
-	sts_value_t *ret = NULL, *temp = NULL, *temp_container = NULL;
-	json_stream new_json;
-	unsigned long i = 0, str_length = 0, init_json = 0;
-	char *str = NULL;
-	int type;
-	
+	if(IS_CLI_PROCESS(value))
+		cli_process_release(CLI_PROCESS(value));
 
-	/* initialize stream */
-	if(!json)
-	{
-		json_open_string(&new_json, json_str);
-		json = &new_json;
-		init_json = 1;
-	}
+	return 0;
+}
 
-	type = json_next(json);
+void cli_process_refinc(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_PROCESS(value))
+		CLI_PROCESS(value)->references++;
+}
+#endif
 
-	switch(type)
-	{
-		case JSON_NULL:
-			if(!(ret = sts_value_create(script, STS_NIL)))
-			{
-				fprintf(stderr, "could not create nil value\n");
-				return NULL;
-			}
+/* a json-open-* handle. pdjson reads it one token at a time, so only what json-get and json-each return is ever built */
+typedef struct cli_json_t
+{
+	unsigned long references;
+	json_stream stream;
+	sts_script_t *script; /* for the waits of the file or socket being read */
+	cli_file_t *file;
+	#ifndef CLI_NO_SOCKETS
+	struct cli_socket_t *socket;
+	#endif
+	char *data; /* the string from json-open-string */
+	char mapped, lines, each; /* each is set while json-each is partway through an array */
+} cli_json_t;
 
-			return ret;
-		break;
-		case JSON_TRUE:
-			if(!(ret = sts_value_from_boolean(script, 1)))
-			{
-				fprintf(stderr, "could not create true value\n");
-				return NULL;
-			}
+#define CLI_JSON(value) ((cli_json_t *)value->external.data_ptr)
+#define IS_CLI_JSON(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_json_refdec)
 
-			return ret;
-		break;
-		case JSON_FALSE:
-			if(!(ret = sts_value_from_boolean(script, 0)))
-			{
-				fprintf(stderr, "could not create false value\n");
-				return NULL;
-			}
+void cli_json_release(cli_json_t *json);
 
-			return ret;
-		break;
-		case JSON_NUMBER:
-			if(!(ret = sts_value_from_number(script, json_get_number(json))))
-			{
-				fprintf(stderr, "could not create true value\n");
-				return NULL;
-			}
+int cli_json_refdec(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_JSON(value))
+		cli_json_release(CLI_JSON(value));
 
-			return ret;
-		break;
-		case JSON_STRING:
-			str = json_get_string(json, &str_length);
+	return 0;
+}
 
-			/* NOTE: pdjson likes to include \0 in the string length. No idea why */
-			if(!(ret = sts_value_from_nstring(script, str, str_length - 1)))
-			{
-				fprintf(stderr, "could not create true value");
-				return NULL;
-			}
+void cli_json_refinc(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_JSON(value))
+		CLI_JSON(value)->references++;
+}
 
-			return ret;
-		break;
-		case JSON_ARRAY:
-			if(!(ret = sts_value_create(script, STS_ARRAY)))
-			{
-				fprintf(stderr, "could not create array value\n");
-				return NULL;
-			}
+/* a crypto-hash-init context. crypto-hash-final sets finished, after which the context can't be used again */
+typedef struct
+{
+	unsigned long references;
+	crypto_blake2b_ctx context;
+	char finished;
+} cli_hash_t;
 
-			while((type = json_peek(json)) != JSON_DONE && type != JSON_ERROR && type != JSON_ARRAY_END)
-			{
-				if(!(temp = sts_value_from_json(script, json, json_str, length)))
-				{
-					fprintf(stderr, "could not add member to array\n");
-					sts_value_reference_decrement(script, ret);
-					return NULL;
-				}
+#define CLI_HASH(value) ((cli_hash_t *)value->external.data_ptr)
+#define IS_CLI_HASH(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_hash_refdec)
 
-				STS_ARRAY_APPEND_INSERT(ret, temp, i);
-				++i;
-			}
+int cli_hash_refdec(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_HASH(value) && !(CLI_HASH(value)->references && --CLI_HASH(value)->references))
+	{
+		crypto_wipe(CLI_HASH(value), sizeof(cli_hash_t));
+		free(CLI_HASH(value));
+	}
 
-			json_next(json);
-		break;
-		case JSON_OBJECT:
-			if(!(ret = sts_value_create(script, STS_ARRAY)))
-			{
-				fprintf(stderr, "could not create hashmap array value\n");
-				return NULL;
-			}
+	return 0;
+}
 
-			while((type = json_peek(json)) != JSON_DONE && type != JSON_ERROR && type != JSON_OBJECT_END)
-			{
-				/* create the key */
+void cli_hash_refinc(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_HASH(value))
+		CLI_HASH(value)->references++;
+}
 
-				/* NOTE: this would be more compact but gcc has really weird behavior. Works perfectly fine on clang */
-				str = json_get_string(json, &str_length);
-				str = sts_memdup(str, str_length);
+/* XXH64, kept to the parts fast-hash and file-hash need. It takes 32 bytes a step in four independent lanes */
+#define CLI_XXH_PRIME1 11400714785074694791ULL
+#define CLI_XXH_PRIME2 14029467366897019727ULL
+#define CLI_XXH_PRIME3 1609587929392839161ULL
+#define CLI_XXH_PRIME4 9650029242287828579ULL
+#define CLI_XXH_PRIME5 2870177450012600261ULL
+#define CLI_XXH_ROTATE(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
 
-				json_next(json);
+typedef struct
+{
+	uint64_t total, lanes[4], seed;
+	unsigned char stored[32];
+	unsigned int stored_length;
+} cli_xxh64_t;
 
-				if(!(temp = sts_value_from_json(script, json, json_str, length)))
-				{
-					fprintf(stderr, "could not add member to object\n");
-					sts_value_reference_decrement(script, ret);
-					free(str);
-					return NULL;
-				}
+uint64_t cli_xxh64_read64(const unsigned char *data)
+{
+	uint64_t ret;
 
-				if(sts_hashmap_set(script, ret, str, str_length, temp))
-				{
-					fprintf(stderr, "could not add '%.*s' to hashmap\n", str_length, str);
-					sts_value_reference_decrement(script, ret);
-					free(str);
-					return NULL;
-				}
 
-				free(str);
-			}
+	memcpy(&ret, data, sizeof(ret));
 
-			json_next(json);
-		break;
-		case JSON_ERROR:
-			fprintf(stderr, "json parse error on line %ld: '%s'\n", json_get_lineno(json), json_get_error(json));
-			return NULL;
-		break;
-	}
+	#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	ret = __builtin_bswap64(ret);
+	#endif
 
-	if(init_json)
-		json_close(json);
+	return ret;
+}
 
+uint64_t cli_xxh64_round(uint64_t lane, uint64_t input)
+{
+	lane += input * CLI_XXH_PRIME2;
+	lane = CLI_XXH_ROTATE(lane, 31);
 
-	return ret;
+	return lane * CLI_XXH_PRIME1;
 }
 
-int sts_hashmap_verify(sts_script_t *script, sts_value_t *value)
+void cli_xxh64_init(cli_xxh64_t *state, uint64_t seed)
 {
-	unsigned long i;
+	memset(state, 0, sizeof(cli_xxh64_t));
 
-	/* hashmaps are only a concept of the stdlib itself so we can only guess if its actually a hashmap */
-	if(value->type == STS_ARRAY && 
-		value->array.length && 
-		value->array.data[0]->type == STS_ARRAY && 
-		value->array.data[0]->array.length == 3
-	)
+	state->seed = seed;
+	state->lanes[0] = seed + CLI_XXH_PRIME1 + CLI_XXH_PRIME2;
+	state->lanes[1] = seed + CLI_XXH_PRIME2;
+	state->lanes[2] = seed;
+	state->lanes[3] = seed - CLI_XXH_PRIME1;
+}
+
+void cli_xxh64_update(cli_xxh64_t *state, const unsigned char *data, unsigned long length)
+{
+	const unsigned char *end = data + length;
+	unsigned int take;
+
+
+	state->total += length;
+
+	/* finish a step that the last update started */
+	if(state->stored_length)
 	{
-		for(i = 0; i < value->array.length; ++i)
-		{
-			/* verify first hash number, then key string, and that every row has 3 values */
+		take = 32 - state->stored_length < length ? 32 - state->stored_length : length;
+		memcpy(&state->stored[state->stored_length], data, take);
+		state->stored_length += take;
+		data += take;
+
+		if(state->stored_length < 32)
+			return;
+
+		state->lanes[0] = cli_xxh64_round(state->lanes[0], cli_xxh64_read64(state->stored));
+		state->lanes[1] = cli_xxh64_round(state->lanes[1], cli_xxh64_read64(&state->stored[8]));
+		state->lanes[2] = cli_xxh64_round(state->lanes[2], cli_xxh64_read64(&state->stored[16]));
+		state->lanes[3] = cli_xxh64_round(state->lanes[3], cli_xxh64_read64(&state->stored[24]));
+		state->stored_length = 0;
+	}
 
-			if(value->array.data[i]->type != STS_ARRAY || 
-				value->array.data[i]->array.length != 3 ||
-				value->array.data[i]->array.data[0]->type != STS_NUMBER ||
-				value->array.data[i]->array.data[1]->type != STS_STRING
-			)
-			{
-				return 0;
-			}
+	for(; end - data >= 32; data += 32)
+	{
+		state->lanes[0] = cli_xxh64_round(state->lanes[0], cli_xxh64_read64(data));
+		state->lanes[1] = cli_xxh64_round(state->lanes[1], cli_xxh64_read64(&data[8]));
+		state->lanes[2] = cli_xxh64_round(state->lanes[2], cli_xxh64_read64(&data[16]));
+		state->lanes[3] = cli_xxh64_round(state->lanes[3], cli_xxh64_read64(&data[24]));
+	}
 
-			/* TODO: determine if its worth it to hash every string and see if the number is true */
+	memcpy(state->stored, data, end - data);
+	state->stored_length = end - data;
+}
+
+uint64_t cli_xxh64_digest(cli_xxh64_t *state)
+{
+	const unsigned char *data = state->stored;
+	unsigned int left = state->stored_length, i;
+	uint32_t word;
+	uint64_t ret;
+
+
+	if(state->total >= 32)
+	{
+		ret = CLI_XXH_ROTATE(state->lanes[0], 1) + CLI_XXH_ROTATE(state->lanes[1], 7) + CLI_XXH_ROTATE(state->lanes[2], 12) + CLI_XXH_ROTATE(state->lanes[3], 18);
+
+		for(i = 0; i < 4; ++i)
+		{
+			ret ^= cli_xxh64_round(0, state->lanes[i]);
+			ret = ret * CLI_XXH_PRIME1 + CLI_XXH_PRIME4;
 		}
+	}
+	else
+		ret = state->seed + CLI_XXH_PRIME5;
 
-		return 1;
+	ret += state->total;
+
+	for(; left >= 8; left -= 8, data += 8)
+	{
+		ret ^= cli_xxh64_round(0, cli_xxh64_read64(data));
+		ret = CLI_XXH_ROTATE(ret, 27) * CLI_XXH_PRIME1 + CLI_XXH_PRIME4;
 	}
 
-	return 0;
+	if(left >= 4)
+	{
+		word = (uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24;
+		ret ^= (uint64_t)word * CLI_XXH_PRIME1;
+		ret = CLI_XXH_ROTATE(ret, 23) * CLI_XXH_PRIME2 + CLI_XXH_PRIME3;
+		left -= 4;
+		data += 4;
+	}
+
+	for(; left; --left, ++data)
+	{
+		ret ^= *data * CLI_XXH_PRIME5;
+		ret = CLI_XXH_ROTATE(ret, 11) * CLI_XXH_PRIME1;
+	}
+
+	ret ^= ret >> 33;
+	ret *= CLI_XXH_PRIME2;
+	ret ^= ret >> 29;
+	ret *= CLI_XXH_PRIME3;
+	ret ^= ret >> 32;
+
+	return ret;
 }
 
-char *escape_string(char *str, unsigned long str_len, unsigned long *out_len)
+/* numbers are doubles, so fast-hash and file-hash give the top 53 bits of the hash. Those fit exactly */
+#define CLI_XXH_NUMBER(hash) ((double)((hash) >> 11))
+
+/* hashes a whole file with big sequential reads, never holding more than one read of it. blake2b goes into hash
+and XXH64 into fast when fast is set. Returns 0 or -1 if the file can't be read */
+int cli_file_hash(char *path, int fast, uint8_t *hash, uint64_t *fast_hash)
 {
-	char *ret = NULL;
-	unsigned long i;
+	crypto_blake2b_ctx context;
+	cli_xxh64_t state;
+	unsigned char *chunk = NULL;
+	long got = 0;
+	int fd;
 
-	#define ESCAPE_WITH(offset, as) do{	\
-			if(!(ret = realloc(ret, *out_len + strlen(as) + 1)))	\
-			{	\
-				fprintf(stderr, "could not resize escaped string\n");	\
-				return NULL;	\
-			}	\
-			memmove(&ret[i + strlen(as)], &ret[i + 1], (*out_len + 1) - (i + 1));	\
-			memcpy(&ret[i], as, strlen(as));	\
-			*out_len += strlen(as) - 1;	\
-			i += strlen(as) - 1;	\
-		}while(0)
 
+	if((fd = open(path, O_RDONLY | O_CLOEXEC)) == -1)
+		return -1;
 
-	if(!(ret = sts_memdup(str, str_len)))
+	if(!(chunk = malloc(CLI_HASH_READ_SIZE)))
 	{
-		fprintf(stderr, "could not duplicate string\n");
-		return NULL;
+		close(fd);
+		return -1;
 	}
 
-	/* initialize out length */
-	*out_len = str_len;
+	#ifdef POSIX_FADV_SEQUENTIAL
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	#endif
 
+	if(fast)
+		cli_xxh64_init(&state, 0);
+	else
+		crypto_blake2b_general_init(&context, 32, NULL, 0);
 
-	for(i = 0; i < *out_len; ++i)
+	while((got = read(fd, chunk, CLI_HASH_READ_SIZE)) != 0)
 	{
-		switch(ret[i])
+		if(got == -1)
 		{
-			case '\"':
-				ESCAPE_WITH(i, "\\\"");
-			break;
-			case '\\':
-				ESCAPE_WITH(i, "\\\\");
-			break;
-			case '\b':
-				ESCAPE_WITH(i, "\\b");
-			break;
-			case '\t':
-				ESCAPE_WITH(i, "\\t");
-			break;
-			case '\n':
-				ESCAPE_WITH(i, "\\n");
-			break;
-			case '\r':
-				ESCAPE_WITH(i, "\\r");
-			break;
-			case '\f':
-				ESCAPE_WITH(i, "\\f");
-			break;
-			case '/':
-				ESCAPE_WITH(i, "\\/");
+			if(errno == EINTR)
+				continue;
 			break;
 		}
+
+		if(fast)
+			cli_xxh64_update(&state, chunk, got);
+		else
+			crypto_blake2b_update(&context, chunk, got);
 	}
 
-	return ret;
+	free(chunk);
+	close(fd);
+
+	if(got == -1)
+		return -1;
 
-	#undef ESCAPE_WITH
+	if(fast)
+		*fast_hash = cli_xxh64_digest(&state);
+	else
+		crypto_blake2b_final(&context, hash);
+
+	return 0;
 }
 
-int sts_json_from_value(sts_script_t *script, char **str_buf, sts_value_t *value, int pretty, int depth, unsigned long *len)
+/* everything the cli keeps per interpreter. Scripts running on pool workers have none */
+typedef struct
 {
-	char num_buf[512], *temp_str = NULL;
-	unsigned long temp_len = 0, i;
+	#ifndef CLI_NO_THREADS
+	sts_pool_t *pool; /* started the first time something needs it */
+	#endif
+	#ifndef CLI_NO_COROUTINES
+	cli_scheduler_t scheduler;
+	#endif
+	#ifndef CLI_NO_TIMERS
+	cli_timers_t timers;
+	#endif
+	cli_file_t *input; /* stdin, once stdin-read-line buffers it */
+	char unused; /* keeps the struct valid when every feature is compiled out */
+} cli_state_t;
 
+#define CLI_STATE(script) ((cli_state_t *)(script)->userdata)
 
-	#define STS_JSON_ERR(msg) do{ fprintf(stderr, "could not concat data onto json string%s%s\n", msg ? ": " : "", msg ? msg : ""); goto error;} while(0)
-	#define STS_JSON_EMIT_INDENT(n) do{ unsigned long i; for(i = 0; i < (n); ++i){ if(amemcat(str_buf, len, "\t", 1)) STS_JSON_ERR("indent mem error"); } }while(0)
-	#define STS_JSON_EMIT(n_depth, str, str_len) do{ if(pretty) STS_JSON_EMIT_INDENT(n_depth); if(amemcat(str_buf, len, (str), (str_len))) STS_JSON_ERR("mem error"); }while(0)
-	#define STS_JSON_EMIT_ALONE(str, str_len) do{ if(amemcat(str_buf, len, (str), (str_len))) STS_JSON_ERR("mem error"); }while(0)
-	#define STS_JSON_ENDLINE do{ if(pretty) STS_JSON_EMIT_ALONE("\n", 1); }while(0)
+void cli_state_cleanup(cli_state_t *state)
+{
+	#ifndef CLI_NO_THREADS
+	if(state->pool)
+		sts_pool_destroy(state->pool);
+	#endif
 
+	if(state->input)
+		cli_file_release(state->input);
 
-	if(!value) STS_JSON_ERR("value is null in json string convert\n");
+	memset(state, 0, sizeof(cli_state_t));
+}
 
-	switch(value->type)
-	{
-		case STS_NIL:
-			STS_JSON_EMIT_ALONE("null", 4);
-		break;
-		case STS_NUMBER:
-			temp_len = snprintf(num_buf, 512, "%1.17g", value->number);
-			STS_JSON_EMIT_ALONE(num_buf, temp_len);
-		break;
-		case STS_BOOLEAN:
-			STS_JSON_EMIT_ALONE(value->boolean ? "true" : "false", value->boolean ? 4 : 5);
-		break;
-		case STS_STRING:
-			STS_JSON_EMIT_ALONE("\"", 1);
-			if(!(temp_str = escape_string(value->string.data, value->string.length, &temp_len)))
-				STS_JSON_ERR("could not escape string");
-			STS_JSON_EMIT_ALONE(temp_str, temp_len);
-			STS_JSON_EMIT_ALONE("\"", 1);
-			free(temp_str);
-		break;
-		case STS_FUNCTION:
-			/* TODO: print stringified function? */
-			STS_JSON_EMIT_ALONE("null", 4);
-		break;
-		case STS_ARRAY:
-			/* its an object */
-			if(sts_hashmap_verify(script, value))
-			{
-				STS_JSON_EMIT_ALONE("{", 1); STS_JSON_ENDLINE;
+#ifndef CLI_NO_WATCH
+/* a watch is one inotify instance. The kernel hands out watch descriptors counting up from 1, so the
+path for an event is found by indexing with its descriptor */
+typedef struct cli_watch_t
+{
+	unsigned long references;
+	int fd;
+	char **paths; /* NULL where a descriptor was removed */
+	unsigned int paths_allocated, count;
+	char *buffer; /* CLI_WATCH_BUFFER_SIZE bytes, allocated by the first watch-wait */
+	#ifndef CLI_NO_POLLER
+	struct cli_poller_t *poller; /* a watch can be registered with one poller at a time, just like a socket */
+	struct cli_watch_t *poller_previous, *poller_next;
+	#endif
+} cli_watch_t;
 
-				for(i = 0; i < value->array.length; ++i)
-				{
-					STS_JSON_EMIT(depth + 1, "\"", 1);
-					if(!(temp_str = escape_string(value->array.data[i]->array.data[1]->string.data, value->array.data[i]->array.data[1]->string.length, &temp_len)))
-						STS_JSON_ERR("could not escape string");
-					STS_JSON_EMIT_ALONE(temp_str, temp_len);
-					STS_JSON_EMIT_ALONE("\": ", 3);
+#define CLI_WATCH(value) ((cli_watch_t *)value->external.data_ptr)
+#define IS_CLI_WATCH(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_watch_refdec)
 
-					if(sts_json_from_value(script, str_buf, value->array.data[i]->array.data[2], pretty, depth + 1, len))
-						STS_JSON_ERR("could not generate json string for array in object\n");
+void cli_watch_release(cli_watch_t *watch)
+{
+	unsigned int i;
 
-					if(i != value->array.length - 1)
-						STS_JSON_EMIT_ALONE(",", 1);
-					STS_JSON_ENDLINE;
-					free(temp_str);
-				}
 
-				STS_JSON_EMIT(depth, "}", 1);
-			}
-			/* its an array */
-			else
-			{
-				STS_JSON_EMIT_ALONE("[", 1);
+	if(watch->references && --watch->references)
+		return;
 
-				for(i = 0; i < value->array.length; ++i)
-				{
-					if(sts_json_from_value(script, str_buf, value->array.data[i], pretty, depth + 1, len))
-						STS_JSON_ERR("could not generate json string for array in array\n");
+	close(watch->fd);
 
-					if(i != value->array.length - 1)
-						STS_JSON_EMIT_ALONE(",", 1);
-				}
+	for(i = 0; i < watch->paths_allocated; ++i)
+		if(watch->paths[i])
+			free(watch->paths[i]);
+	if(watch->paths) free(watch->paths);
+	if(watch->buffer) free(watch->buffer);
 
-				STS_JSON_EMIT_ALONE("]", 1);
-			}
-		break;
-	}
-	
+	free(watch);
+}
 
-	return 0;
-error:
-	if(temp_str) free(temp_str);
-	return 1;
+int cli_watch_refdec(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_WATCH(value))
+		cli_watch_release(CLI_WATCH(value));
 
-	#undef STS_JSON_ERR
-	#undef STS_JSON_EMIT_INDENT
-	#undef STS_JSON_EMIT
-	#undef STS_JSON_EMIT_ALONE
-	#undef STS_JSON_ENDLINE
+	return 0;
 }
 
-/* control simple tiny script */
+void cli_watch_refinc(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_WATCH(value))
+		CLI_WATCH(value)->references++;
+}
 
-int repl(sts_script_t *script)
+/* a new watch when watch is NULL, otherwise another value for one that already exists */
+sts_value_t *cli_watch_value(sts_script_t *script, cli_watch_t *watch)
 {
-	int quit = 0, blank = 1;
-	size_t size = 0;
-	unsigned int offset = 0, line = 0;
 	sts_value_t *ret = NULL;
-	sts_node_t *temp_node = NULL, *current_node = NULL;
-	char *current_buffer = NULL, *temp_buffer = NULL;
-	/* know if ready to parse by making sure '['s and ']'s are even */
 
-	while(!quit)
-	{
-		printf("%s ", PS1);
-		while(!equal_open_close(current_buffer) || current_buffer[strlen(current_buffer) - 2] == '\\')
-		{
-			if(current_buffer)
-				printf("> ");
-			
-			getline(&temp_buffer, &size, stdin);
 
-			if(!strcmp(temp_buffer, "exit\n")) /* exit isnt a real action but it needs to clean up in a simple way so this works */
-			{
-				free(temp_buffer);
-				free(current_buffer);
-				if(!sts_destroy(script))
-					fprintf(stderr, "problem cleaning up script");
-				return 0;
-			}
+	if(!(ret = sts_value_create(script, STS_EXTERNAL)))
+	{
+		STS_ERROR_SIMPLE("could not create watch external value");
+		return NULL;
+	}
 
-			current_buffer = realloc(current_buffer, (current_buffer ? strlen(current_buffer) : 0) + strlen(temp_buffer) + 1); /* honestly, this is a really simple and hacky repl. At this point, it really doesn't matter in this part if we check for realloc errors */
-			if(blank)
-			{
-				current_buffer[0] = 0x0;
-				blank = 0;
-			}
-			strcat(current_buffer, temp_buffer);
+	ret->external.refdec = &cli_watch_refdec;
+	ret->external.refinc = &cli_watch_refinc;
 
-			free(temp_buffer);
-			temp_buffer = NULL;
-		}
-		
-		/* parse and eval */
+	if(watch)
+	{
+		ret->external.data_ptr = watch;
+		watch->references++;
 
-		if(!(current_node = sts_parse(script, NULL, current_buffer, "repl.sts", &offset, &line)))
+		return ret;
+	}
+
+	if(!(ret->external.data_ptr = calloc(1, sizeof(cli_watch_t))))
+	{
+		STS_ERROR_SIMPLE("could not create watch type value");
+		free(ret);
+		return NULL;
+	}
+
+	CLI_WATCH(ret)->references = 1;
+
+	if((CLI_WATCH(ret)->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) == -1)
+	{
+		STS_ERROR_SIMPLE("could not create inotify instance");
+		free(ret->external.data_ptr);
+		free(ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+/* 'c' is created, 'd' is deleted, 'm' is modified, 'w' is closed after writing, 'v' is moved, and 'a' is
+metadata changes. An empty string is all of them */
+unsigned int cli_watch_events_from_string(char *string)
+{
+	unsigned int ret = 0;
+
+
+	if(strchr(string, 'c'))
+		ret |= IN_CREATE;
+	if(strchr(string, 'd'))
+		ret |= IN_DELETE | IN_DELETE_SELF;
+	if(strchr(string, 'm'))
+		ret |= IN_MODIFY;
+	if(strchr(string, 'w'))
+		ret |= IN_CLOSE_WRITE;
+	if(strchr(string, 'v'))
+		ret |= IN_MOVED_FROM | IN_MOVED_TO | IN_MOVE_SELF;
+	if(strchr(string, 'a'))
+		ret |= IN_ATTRIB;
+
+	if(!ret)
+		ret = IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_MOVE_SELF | IN_ATTRIB;
+
+	return ret;
+}
+
+char *cli_watch_event_name(unsigned int mask)
+{
+	if(mask & IN_CREATE) return "create";
+	if(mask & IN_DELETE) return "delete";
+	if(mask & IN_DELETE_SELF) return "delete-self";
+	if(mask & IN_MODIFY) return "modify";
+	if(mask & IN_CLOSE_WRITE) return "close-write";
+	if(mask & IN_MOVED_FROM) return "move-from";
+	if(mask & IN_MOVED_TO) return "move-to";
+	if(mask & IN_MOVE_SELF) return "move-self";
+	if(mask & IN_ATTRIB) return "attrib";
+
+	return "unknown";
+}
+
+/* watching a path that is already watched replaces what it is watched for. Returns nonzero on error */
+int cli_watch_add(cli_watch_t *watch, char *path, unsigned int events)
+{
+	char **paths = NULL;
+	unsigned int size;
+	int descriptor;
+
+
+	if((descriptor = inotify_add_watch(watch->fd, path, events)) == -1)
+		return 1;
+
+	if((unsigned int)descriptor >= watch->paths_allocated)
+	{
+		size = watch->paths_allocated ? watch->paths_allocated : 16;
+		while(size <= (unsigned int)descriptor)
+			size *= 2;
+
+		if(!(paths = realloc(watch->paths, sizeof(char *) * size)))
 		{
-			fprintf(stderr, "parser error\n");
+			inotify_rm_watch(watch->fd, descriptor);
+			return 1;
 		}
 
+		memset(&paths[watch->paths_allocated], 0, sizeof(char *) * (size - watch->paths_allocated));
+		watch->paths = paths;
+		watch->paths_allocated = size;
+	}
 
-		/* eval */
-		ret = sts_eval(script, current_node, NULL, NULL, 0, 0);
-		if(ret && !sts_value_reference_decrement(script, ret)) fprintf(stderr, "could not clean up returned value\n");
-		else if(!ret) fprintf(stderr, "command error\n");
+	if(watch->paths[descriptor])
+		return 0;
 
-		sts_ast_delete(script, current_node);
-		free(current_buffer);
-		current_buffer = NULL;
-		blank = 1;
-		offset = line = 0;
+	if(!(watch->paths[descriptor] = strdup(path)))
+	{
+		inotify_rm_watch(watch->fd, descriptor);
+		return 1;
 	}
+	watch->count++;
 
-	/* cleanup */
-
-	if(!sts_destroy(script))
-		fprintf(stderr, "problem cleaning up script");
-	
 	return 0;
 }
 
-char *read_file(sts_script_t *script, char *file, unsigned int *size)
+/* returns nonzero if the path isnt watched */
+int cli_watch_remove(cli_watch_t *watch, char *path)
 {
-	FILE *script_file = NULL;
-	char *ret = NULL;
+	unsigned int i;
 
 
-	if(!(script_file = fopen(file, "r")))
+	for(i = 0; i < watch->paths_allocated; ++i)
+		if(watch->paths[i] && !strcmp(watch->paths[i], path))
+		{
+			inotify_rm_watch(watch->fd, i);
+			free(watch->paths[i]);
+			watch->paths[i] = NULL;
+			watch->count--;
+
+			return 0;
+		}
+
+	return 1;
+}
+
+/* appends [path event name] to ret for every queued event without blocking. name is what changed inside of a
+watched directory, or an empty string when it was the watched path itself. Returns nonzero on error */
+int cli_watch_read(sts_script_t *script, cli_watch_t *watch, sts_value_t *ret)
+{
+	struct inotify_event *event = NULL;
+	sts_value_t *record = NULL, *temp = NULL;
+	long got = 0, offset;
+	char *path;
+
+
+	if(!watch->buffer && !(watch->buffer = malloc(CLI_WATCH_BUFFER_SIZE)))
+		return 1;
+
+	while((got = read(watch->fd, watch->buffer, CLI_WATCH_BUFFER_SIZE)) != 0)
 	{
-		return NULL;
+		if(got == -1)
+		{
+			if(errno == EINTR)
+				continue;
+			return errno != EAGAIN && errno != EWOULDBLOCK;
+		}
+
+		for(offset = 0; offset < got; offset += sizeof(struct inotify_event) + event->len)
+		{
+			event = (struct inotify_event *)&watch->buffer[offset];
+
+			/* the queue filled up and events were lost. The script has to look at everything again */
+			if(event->mask & IN_Q_OVERFLOW)
+				path = "";
+			else if(event->wd < 0 || (unsigned int)event->wd >= watch->paths_allocated || !(path = watch->paths[event->wd]))
+				continue;
+
+			/* the kernel dropped the descriptor because the path is gone or was removed */
+			if(event->mask & IN_IGNORED)
+			{
+				free(watch->paths[event->wd]);
+				watch->paths[event->wd] = NULL;
+				watch->count--;
+				continue;
+			}
+
+			if(!(record = sts_value_create(script, STS_ARRAY)))
+				return 1;
+			sts_array_append_insert(script, ret, record, ret->array.length);
+
+			if(!(temp = sts_value_from_string(script, path)))
+				return 1;
+			sts_array_append_insert(script, record, temp, record->array.length);
+
+			if(!(temp = sts_value_from_string(script, event->mask & IN_Q_OVERFLOW ? "overflow" : cli_watch_event_name(event->mask))))
+				return 1;
+			sts_array_append_insert(script, record, temp, record->array.length);
+
+			if(!(temp = sts_value_from_string(script, event->len ? event->name : "")))
+				return 1;
+			sts_array_append_insert(script, record, temp, record->array.length);
+		}
 	}
-	
-	fseek(script_file, 0, SEEK_END);
-	*size = ftell(script_file);
-	fseek(script_file, 0, SEEK_SET);
-	
-	if(!(ret = calloc((*size) + 1, sizeof(char))))
+
+	return 0;
+}
+#endif
+
+#ifndef CLI_NO_SOCKETS
+typedef struct cli_socket_t
+{
+	unsigned long references;
+	zed_net_socket_t socket;
+	SSL *ssl;
+	char *name;
+	struct
 	{
-		fprintf(stderr, "could not calloc script text buffer\n");
-		fclose(script_file);
-		return NULL;
-	}
-	
-	if(fread(ret, (*size), sizeof(char), script_file) <= 0)
+		char *data; /* allocated by the first socket-read-* call */
+		unsigned long start, end, size; /* what is buffered is between start and end */
+	} buffer;
+	struct
 	{
-		fprintf(stderr, "could not read script file\n");
-		free(ret);
-		fclose(script_file);
-		return NULL;
+		char *data; /* CLI_UDP_DATAGRAM_SIZE bytes for each datagram */
+		unsigned int allocated;
+		#ifdef __linux__
+		struct mmsghdr *headers;
+		struct iovec *pieces;
+		struct sockaddr_in *addresses;
+		unsigned int headers_allocated;
+		#endif
+	} batch; /* kept between socket-udp-*-batch calls */
+	#ifndef CLI_NO_POLLER
+	struct cli_poller_t *poller; /* a socket can be registered with one poller at a time */
+	struct cli_socket_t *poller_previous, *poller_next;
+	unsigned int events, ready_events; /* what it was registered for and what the last poller-wait found */
+	char buffered; /* counted in the buffered sockets of its poller */
+	#endif
+} cli_socket_t;
+
+#ifndef CLI_NO_POLLER
+typedef struct cli_poller_t
+{
+	unsigned long references;
+	int fd;
+	unsigned int count, events_allocated, buffered; /* buffered sockets are read registered sockets with bytes socket-read-* already has */
+	cli_socket_t *sockets;
+	#ifndef CLI_NO_WATCH
+	cli_watch_t *watches;
+	#endif
+	struct epoll_event *events;
+} cli_poller_t;
+#endif
+
+#define CLI_SOCKET(value) ((cli_socket_t *)value->external.data_ptr)
+#define IS_CLI_SOCKET(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_socket_refdec)
+
+void cli_socket_release(cli_socket_t *socket)
+{
+	if(socket->references && --socket->references)
+		return;
+
+	zed_net_socket_close(&socket->socket);
+	if(socket->ssl)
+	{
+		SSL_shutdown(socket->ssl);
+		SSL_CTX_free(socket->ssl);
 	}
-	
-	fclose(script_file);
+	if(socket->name) free(socket->name);
+	if(socket->buffer.data) free(socket->buffer.data);
+	if(socket->batch.data) free(socket->batch.data);
+	#ifdef __linux__
+	if(socket->batch.headers) free(socket->batch.headers);
+	if(socket->batch.pieces) free(socket->batch.pieces);
+	if(socket->batch.addresses) free(socket->batch.addresses);
+	#endif
+	free(socket);
+}
 
+/* zed_net checks with select, which can't hold fds past FD_SETSIZE. Servers with thousands of clients get there */
+/* only asks the fd. Bytes the socket-read-* functions buffered are not counted */
+int cli_socket_fd_would_block(cli_socket_t *socket)
+{
+	#ifdef CLI_WINDOWS
+	return zed_net_check_would_block(&socket->socket);
+	#else
+	struct pollfd single;
 
-	return ret;
+
+	single.fd = socket->socket.handle;
+	single.events = POLLIN;
+	single.revents = 0;
+
+	return poll(&single, 1, 0) == 1 ? 0 : 1;
+	#endif
 }
 
-char *import(sts_script_t *script, char *file)
+int cli_socket_would_block(cli_socket_t *socket)
 {
-	unsigned int size = 0;
-	char *ret = NULL, *assemble_string = NULL;
+	if(socket->buffer.end != socket->buffer.start)
+		return 0;
 
+	return cli_socket_fd_would_block(socket);
+}
 
-	STS_STRING_ASSEMBLE(assemble_string, size, INSTALL_DIR, strlen(INSTALL_DIR), file, strlen(file));
+/* keeps the poller count of buffered sockets current. The fd of a buffered socket may never be readable again, so
+poller-wait has to report them itself */
+void cli_socket_poller_update(cli_socket_t *socket)
+{
+	#ifndef CLI_NO_POLLER
+	char buffered = socket->poller && (socket->events & EPOLLIN) && socket->buffer.end != socket->buffer.start;
 
-	ret = read_file(script, assemble_string, &size);
 
-	STS_FREE(assemble_string);
+	if(buffered != socket->buffered)
+	{
+		if(buffered)
+			socket->poller->buffered++;
+		else
+			socket->poller->buffered--;
+		socket->buffered = buffered;
+	}
+	#endif
+}
 
-	return ret;
+int cli_socket_refdec(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_SOCKET(value))
+		cli_socket_release(CLI_SOCKET(value));
+
+	return 0;
 }
 
-sts_value_t *cli_actions(sts_script_t *script, sts_value_t *action, sts_node_t *args, sts_scope_t *locals, sts_value_t **previous)
+void cli_socket_refinc(sts_script_t *script, sts_value_t *value)
 {
-	sts_value_t *ret = NULL, *eval_value = NULL, *temp_value = NULL, *first_arg_value = NULL, *second_arg_value = NULL, *third_arg_value = NULL;
-	FILE *proc_pipe = NULL, *file = NULL;
-	zed_net_address_t address;
-	char *temp_str = NULL, *popen_buf = NULL, buf[1024];
-	unsigned int i = 0, size = 0, total = 0, temp_uint = 0;
-	unsigned long temp_ulong = 0;
-	void *work_area = NULL;
-	int temp_int = 0;
+	if(IS_CLI_SOCKET(value))
+		CLI_SOCKET(value)->references++;
+}
+
+sts_value_t *cli_socket_new(sts_script_t *script)
+{
+	sts_value_t *ret = NULL;
 
 
-	GOTO_JMP(&cli_actions);
-	if(!GOTO_ACTIVATED && action->type == STS_STRING)
+	if(!(ret = sts_value_create(script, STS_EXTERNAL)))
 	{
-		ACTION(if, "pipeout")
-		{
-			GOTO_SET(&cli_actions);
-			/* the first arg is the string that comes from stdout and
-			the remaining arguments are the command part */
-			
-			EVAL_ARG(args->next);
-			first_arg_value = eval_value;
-			STS_VALUE_EXPECT_MUTABLE(first_arg_value, return NULL);
+		STS_ERROR_SIMPLE("could not create socket external value");
+		goto error;
+	}
 
-			args = args->next;
+	ret->external.refdec = &cli_socket_refdec;
+	ret->external.refinc = &cli_socket_refinc;
 
-			ACTION_BEGIN_ARGLOOP
-				switch(eval_value->type)
-				{
-					case STS_NUMBER: STS_STRING_ASSEMBLE_FMT(temp_str, size, "%1.17g", eval_value->number, " ", 1); break;
-					case STS_BOOLEAN: STS_STRING_ASSEMBLE_FMT(temp_str, size, "%s", eval_value->boolean ? "true" : "false", " ", 1); break;
-					case STS_STRING: STS_STRING_ASSEMBLE(temp_str, size, eval_value->string.data, eval_value->string.length, " ", 1); break;
-				}
-			ACTION_END_ARGLOOP
+	if(!(ret->external.data_ptr = calloc(1, sizeof(cli_socket_t))))
+	{
+		STS_ERROR_SIMPLE("could not create socket type value");
+		goto error;
+	}
 
-			if((proc_pipe = popen(temp_str, "r")))
-			{
-				while((size = fread(buf, 1, sizeof(buf), proc_pipe)) > 0)
-				{
-					if(!(popen_buf = realloc(popen_buf, total + size + 1)))
-					{
-						fprintf(stderr, "could not resize pipe buffer\n");
-						break;
-					}
+	CLI_SOCKET(ret)->references = 1;
 
-					memmove(&popen_buf[total], buf, size);
-					total += size;
-					popen_buf[total] = 0x0;
-				}
+	return ret;
+error:
+	if(ret) free(ret);
+	return NULL;
+}
 
-				/* make string into sts value */
-				VALUE_INIT(temp_value, STS_STRING);
+#ifndef CLI_NO_POLLER
+/* a poller holds a reference to every socket registered with it, so sockets stay open until they are removed */
 
-				/* copy it to the first arg to set it to a string only */
-				if(sts_value_copy(script, first_arg_value, temp_value, 0))
-				{
-					fprintf(stderr, "could not set value to string type\n");
-				}
+#define CLI_POLLER(value) ((cli_poller_t *)value->external.data_ptr)
+#define IS_CLI_POLLER(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_poller_refdec)
+#ifndef CLI_NO_WATCH
+	#define IS_CLI_POLLABLE(value) (IS_CLI_SOCKET(value) || IS_CLI_WATCH(value))
+#else
+	#define IS_CLI_POLLABLE(value) IS_CLI_SOCKET(value)
+#endif
 
-				first_arg_value->string.data = popen_buf;
-				first_arg_value->string.length = total;
+void cli_poller_unregister(cli_socket_t *socket)
+{
+	cli_poller_t *poller = socket->poller;
 
-				/* cleanup temporary value */
 
-				if(!sts_value_reference_decrement(script, temp_value))
-					STS_ERROR_SIMPLE("could not decrement references for temporary value in pipeout action");
-				
+	epoll_ctl(poller->fd, EPOLL_CTL_DEL, socket->socket.handle, NULL);
 
-				VALUE_FROM_NUMBER(ret, (double)pclose(proc_pipe));
+	if(socket->buffered)
+		poller->buffered--;
+	socket->buffered = 0;
+
+	if(socket->poller_previous)
+		socket->poller_previous->poller_next = socket->poller_next;
+	else
+		poller->sockets = socket->poller_next;
+	if(socket->poller_next)
+		socket->poller_next->poller_previous = socket->poller_previous;
+	poller->count--;
+
+	socket->poller = NULL;
+	socket->poller_previous = socket->poller_next = NULL;
+	socket->events = socket->ready_events = 0;
+
+	cli_socket_release(socket);
+}
+
+#ifndef CLI_NO_WATCH
+/* watches share the epoll set with sockets. Their pointer is stored with the lowest bit set, which a socket
+pointer never has, so poller-wait can tell them apart */
+#define CLI_POLLER_WATCH_TAG 1
+
+void cli_poller_unregister_watch(cli_watch_t *watch)
+{
+	cli_poller_t *poller = watch->poller;
+
+
+	epoll_ctl(poller->fd, EPOLL_CTL_DEL, watch->fd, NULL);
+
+	if(watch->poller_previous)
+		watch->poller_previous->poller_next = watch->poller_next;
+	else
+		poller->watches = watch->poller_next;
+	if(watch->poller_next)
+		watch->poller_next->poller_previous = watch->poller_previous;
+	poller->count--;
+
+	watch->poller = NULL;
+	watch->poller_previous = watch->poller_next = NULL;
+
+	cli_watch_release(watch);
+}
+
+/* a watch is ready whenever it has events queued for watch-wait */
+int cli_poller_register_watch(cli_poller_t *poller, cli_watch_t *watch)
+{
+	struct epoll_event event;
+
+
+	if(watch->poller == poller)
+		return 0;
+	if(watch->poller)
+		cli_poller_unregister_watch(watch);
+
+	memset(&event, 0, sizeof(struct epoll_event));
+	event.events = EPOLLIN;
+	event.data.u64 = (uintptr_t)watch | CLI_POLLER_WATCH_TAG;
+
+	if(epoll_ctl(poller->fd, EPOLL_CTL_ADD, watch->fd, &event))
+		return 1;
+
+	if((watch->poller_next = poller->watches))
+		poller->watches->poller_previous = watch;
+	poller->watches = watch;
+	poller->count++;
+	watch->poller = poller;
+	watch->references++;
+
+	return 0;
+}
+#endif
+
+int cli_poller_register(cli_poller_t *poller, cli_socket_t *socket, unsigned int events)
+{
+	struct epoll_event event;
+
+
+	if(socket->poller && socket->poller != poller)
+		cli_poller_unregister(socket);
+
+	memset(&event, 0, sizeof(struct epoll_event));
+	event.events = events;
+	event.data.ptr = socket;
+
+	if(epoll_ctl(poller->fd, socket->poller ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, socket->socket.handle, &event))
+		return 1;
+
+	if(!socket->poller)
+	{
+		if((socket->poller_next = poller->sockets))
+			poller->sockets->poller_previous = socket;
+		poller->sockets = socket;
+		poller->count++;
+		socket->poller = poller;
+		socket->references++;
+	}
+
+	socket->events = events;
+	cli_socket_poller_update(socket);
+
+	return 0;
+}
+
+/* 'r' is readable, which includes the peer hanging up, and 'w' is writable */
+unsigned int cli_poller_events_from_string(char *string)
+{
+	unsigned int ret = 0;
+
+
+	if(strchr(string, 'r'))
+		ret |= EPOLLIN | EPOLLRDHUP;
+	if(strchr(string, 'w'))
+		ret |= EPOLLOUT;
+
+	return ret;
+}
+
+int cli_poller_refdec(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_POLLER(value) && (!CLI_POLLER(value)->references || !--CLI_POLLER(value)->references))
+	{
+		while(CLI_POLLER(value)->sockets)
+			cli_poller_unregister(CLI_POLLER(value)->sockets);
+		#ifndef CLI_NO_WATCH
+		while(CLI_POLLER(value)->watches)
+			cli_poller_unregister_watch(CLI_POLLER(value)->watches);
+		#endif
+
+		close(CLI_POLLER(value)->fd);
+		if(CLI_POLLER(value)->events) free(CLI_POLLER(value)->events);
+		free(value->external.data_ptr);
+	}
+
+	return 0;
+}
+
+void cli_poller_refinc(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_POLLER(value))
+		CLI_POLLER(value)->references++;
+}
+
+sts_value_t *cli_poller_new(sts_script_t *script)
+{
+	sts_value_t *ret = NULL;
+
+
+	if(!(ret = sts_value_create(script, STS_EXTERNAL)))
+	{
+		STS_ERROR_SIMPLE("could not create poller external value");
+		goto error;
+	}
+
+	ret->external.refdec = &cli_poller_refdec;
+	ret->external.refinc = &cli_poller_refinc;
+
+	if(!(ret->external.data_ptr = calloc(1, sizeof(cli_poller_t))))
+	{
+		STS_ERROR_SIMPLE("could not create poller type value");
+		goto error;
+	}
+
+	CLI_POLLER(ret)->references = 1;
+
+	if((CLI_POLLER(ret)->fd = epoll_create1(EPOLL_CLOEXEC)) == -1)
+	{
+		STS_ERROR_SIMPLE("could not create epoll instance");
+		free(ret->external.data_ptr);
+		goto error;
+	}
+
+	return ret;
+error:
+	if(ret) free(ret);
+	return NULL;
+}
+
+/* another value for a socket that is already open. Used to hand back registered sockets */
+sts_value_t *cli_socket_value(sts_script_t *script, cli_socket_t *socket)
+{
+	sts_value_t *ret = NULL;
+
+
+	if(!(ret = sts_value_create(script, STS_EXTERNAL)))
+	{
+		STS_ERROR_SIMPLE("could not create socket external value");
+		return NULL;
+	}
+
+	ret->external.refdec = &cli_socket_refdec;
+	ret->external.refinc = &cli_socket_refinc;
+	ret->external.data_ptr = socket;
+	socket->references++;
+
+	return ret;
+}
+#endif
+#endif /* CLI_NO_SOCKETS */
+
+#ifndef CLI_NO_COROUTINES
+/* coroutines all run on the one interpreter. Each gets its own stack and the interpreter that isnt
+inside of a coroutine is the scheduler, so it runs a round whenever it has to wait on something */
+
+#define CLI_COROUTINE(value) ((cli_coroutine_t *)value->external.data_ptr)
+#define IS_CLI_COROUTINE(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_coroutine_refdec)
+#define CLI_CHANNEL(value) ((cli_channel_t *)value->external.data_ptr)
+#define IS_CLI_CHANNEL(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_channel_refdec)
+
+void cli_coroutine_queue_push(cli_coroutine_queue_t *queue, cli_coroutine_t *coroutine)
+{
+	coroutine->next = NULL;
+
+	if(queue->tail)
+		queue->tail->next = coroutine;
+	else
+		queue->head = coroutine;
+	queue->tail = coroutine;
+}
+
+cli_coroutine_t *cli_coroutine_queue_pop(cli_coroutine_queue_t *queue)
+{
+	cli_coroutine_t *ret = queue->head;
+
+
+	if(ret && !(queue->head = ret->next))
+		queue->tail = NULL;
+
+	return ret;
+}
+
+void cli_coroutine_release(sts_script_t *script, cli_coroutine_t *coroutine)
+{
+	if(--coroutine->references)
+		return;
+
+	if(coroutine->function) sts_value_reference_decrement(script, coroutine->function);
+	if(coroutine->arguments) sts_value_reference_decrement(script, coroutine->arguments);
+	if(coroutine->result) sts_value_reference_decrement(script, coroutine->result);
+
+	free(coroutine);
+}
+
+int cli_coroutine_refdec(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_COROUTINE(value))
+		cli_coroutine_release(script, CLI_COROUTINE(value));
+
+	return 0;
+}
+
+void cli_coroutine_refinc(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_COROUTINE(value))
+		CLI_COROUTINE(value)->references++;
+}
+
+int cli_channel_refdec(sts_script_t *script, sts_value_t *value)
+{
+	unsigned int i;
+
+
+	if(IS_CLI_CHANNEL(value) && (!CLI_CHANNEL(value)->references || !--CLI_CHANNEL(value)->references))
+	{
+		for(i = 0; i < CLI_CHANNEL(value)->length; ++i)
+			sts_value_reference_decrement(script, CLI_CHANNEL(value)->values[(CLI_CHANNEL(value)->start + i) % CLI_CHANNEL(value)->capacity]);
+
+		free(CLI_CHANNEL(value)->values);
+		free(value->external.data_ptr);
+	}
+
+	return 0;
+}
+
+void cli_channel_refinc(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_CHANNEL(value))
+		CLI_CHANNEL(value)->references++;
+}
+
+void *cli_coroutine_stack_get(cli_scheduler_t *scheduler)
+{
+	void *ret = NULL;
+
+
+	if(scheduler->stack_count)
+		return scheduler->stacks[--scheduler->stack_count];
+
+	if((ret = mmap(NULL, CLI_COROUTINE_STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0)) == MAP_FAILED)
+		return NULL;
+
+	/* guard page so running off the end of the stack crashes instead of trashing the heap */
+	if(mprotect(ret, sysconf(_SC_PAGESIZE), PROT_NONE))
+	{
+		munmap(ret, CLI_COROUTINE_STACK_SIZE);
+		return NULL;
+	}
+
+	return ret;
+}
+
+void cli_coroutine_stack_put(cli_scheduler_t *scheduler, void *stack)
+{
+	if(scheduler->stack_count < CLI_COROUTINE_STACK_CACHE)
+		scheduler->stacks[scheduler->stack_count++] = stack;
+	else
+		munmap(stack, CLI_COROUTINE_STACK_SIZE);
+}
+
+/* moves the first coroutine in a wait queue, or all of them, to the ready queue */
+void cli_coroutine_wake(cli_scheduler_t *scheduler, cli_coroutine_queue_t *queue, int all)
+{
+	cli_coroutine_t *coroutine = NULL;
+
+
+	while((coroutine = cli_coroutine_queue_pop(queue)))
+	{
+		coroutine->state = CLI_COROUTINE_READY;
+		cli_coroutine_queue_push(&scheduler->ready, coroutine);
+
+		if(!all)
+			break;
+	}
+}
+
+/* makecontext can only pass ints, so the pointer is split in two */
+void cli_coroutine_entry(unsigned int high, unsigned int low)
+{
+	cli_coroutine_t *coroutine = (cli_coroutine_t *)(((uintptr_t)high << 16 << 16) | (uintptr_t)low);
+	sts_script_t *script = coroutine->script;
+
+
+	if(!(coroutine->result = sts_function_call(script, coroutine->function, coroutine->arguments)))
+	{
+		fprintf(stderr, "function failed in coroutine\n");
+		coroutine->result = sts_value_create(script, STS_NIL);
+	}
+
+	coroutine->state = CLI_COROUTINE_DONE;
+	cli_coroutine_wake(&CLI_STATE(script)->scheduler, &coroutine->awaiting, 1);
+
+	/* returning goes back to the scheduler through uc_link */
+}
+
+cli_coroutine_t *cli_coroutine_spawn(sts_script_t *script, sts_value_t *function, sts_value_t *arguments)
+{
+	cli_scheduler_t *scheduler = &CLI_STATE(script)->scheduler;
+	cli_coroutine_t *ret = NULL;
+
+
+	if(!(ret = calloc(1, sizeof(cli_coroutine_t))))
+	{
+		STS_ERROR_SIMPLE("could not allocate coroutine");
+		return NULL;
+	}
+
+	if(!(ret->stack = cli_coroutine_stack_get(scheduler)))
+	{
+		STS_ERROR_SIMPLE("could not allocate coroutine stack");
+		free(ret);
+		return NULL;
+	}
+
+	if(getcontext(&ret->context))
+	{
+		STS_ERROR_SIMPLE("could not get coroutine context");
+		cli_coroutine_stack_put(scheduler, ret->stack);
+		free(ret);
+		return NULL;
+	}
+
+	ret->context.uc_stack.ss_sp = ret->stack;
+	ret->context.uc_stack.ss_size = CLI_COROUTINE_STACK_SIZE;
+	ret->context.uc_link = &scheduler->context;
+	makecontext(&ret->context, (void (*)(void))&cli_coroutine_entry, 2, (unsigned int)((uintptr_t)ret >> 16 >> 16), (unsigned int)(uintptr_t)ret);
+
+	ret->references = 2; /* one for the scheduler and one for the handle */
+	ret->script = script;
+	ret->fd = -1;
+	ret->function = function;
+	ret->arguments = arguments;
+	STS_VALUE_REFINC(script, function);
+	STS_VALUE_REFINC(script, arguments);
+
+	if((ret->all_next = scheduler->all))
+		scheduler->all->all_previous = ret;
+	scheduler->all = ret;
+	scheduler->count++;
+
+	cli_coroutine_queue_push(&scheduler->ready, ret);
+
+	return ret;
+}
+
+void cli_coroutine_remove(sts_script_t *script, cli_coroutine_t *coroutine)
+{
+	cli_scheduler_t *scheduler = &CLI_STATE(script)->scheduler;
+
+
+	if(coroutine->all_previous)
+		coroutine->all_previous->all_next = coroutine->all_next;
+	else
+		scheduler->all = coroutine->all_next;
+	if(coroutine->all_next)
+		coroutine->all_next->all_previous = coroutine->all_previous;
+	scheduler->count--;
+
+	if(coroutine->state == CLI_COROUTINE_DONE)
+		cli_coroutine_stack_put(scheduler, coroutine->stack);
+	else
+		munmap(coroutine->stack, CLI_COROUTINE_STACK_SIZE);
+	coroutine->stack = NULL;
+
+	cli_coroutine_release(script, coroutine);
+}
+
+#ifndef CLI_NO_TIMERS
+#define CLI_TIMER(value) ((cli_timer_t *)value->external.data_ptr)
+#define IS_CLI_TIMER(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_timer_refdec)
+
+void cli_timer_release(sts_script_t *script, cli_timer_t *timer)
+{
+	if(timer->references && --timer->references)
+		return;
+
+	sts_value_reference_decrement(script, timer->function);
+	free(timer);
+}
+
+int cli_timer_refdec(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_TIMER(value))
+		cli_timer_release(script, CLI_TIMER(value));
+
+	return 0;
+}
+
+void cli_timer_refinc(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_TIMER(value))
+		CLI_TIMER(value)->references++;
+}
+
+sts_value_t *cli_timer_value(sts_script_t *script, cli_timer_t *timer)
+{
+	sts_value_t *ret = NULL;
+
+
+	if(!(ret = sts_value_create(script, STS_EXTERNAL)))
+	{
+		STS_ERROR_SIMPLE("could not create timer external value");
+		return NULL;
+	}
+
+	ret->external.refdec = &cli_timer_refdec;
+	ret->external.refinc = &cli_timer_refinc;
+	ret->external.data_ptr = timer;
+	timer->references++;
+
+	return ret;
+}
+
+/* ticks are CLOCK_MONOTONIC milliseconds, so they line up with clock-monotonic */
+uint64_t cli_timers_tick()
+{
+	struct timespec ts;
+
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+void cli_timers_link(cli_timers_t *timers, cli_timer_t *timer)
+{
+	uint64_t delta = timer->expires > timers->now ? timer->expires - timers->now : 0, expires = timer->expires;
+	unsigned int level = 0, index;
+
+
+	while(level < CLI_TIMER_LEVELS - 1 && delta >> (CLI_TIMER_BITS * (level + 1)))
+		level++;
+
+	/* further than the top level reaches goes in its last slot and is placed again when that slot is spread */
+	if(delta >> (CLI_TIMER_BITS * CLI_TIMER_LEVELS))
+		expires = timers->now + ((uint64_t)1 << (CLI_TIMER_BITS * CLI_TIMER_LEVELS)) - 1;
+
+	index = (expires >> (CLI_TIMER_BITS * level)) & (CLI_TIMER_SLOTS - 1);
+	timer->slot = &timers->slots[level][index];
+	timer->previous = NULL;
+	if((timer->next = *timer->slot))
+		timer->next->previous = timer;
+	*timer->slot = timer;
+
+	timers->occupied[level] |= (uint64_t)1 << index;
+	timers->count++;
+}
+
+void cli_timers_unlink(cli_timers_t *timers, cli_timer_t *timer)
+{
+	unsigned long index;
+
+
+	if(timer->previous)
+		timer->previous->next = timer->next;
+	else
+		*timer->slot = timer->next;
+	if(timer->next)
+		timer->next->previous = timer->previous;
+
+	if(timer->slot == &timers->due)
+	{
+		if(timers->due_last == timer)
+			timers->due_last = timer->previous;
+	}
+	else if(!*timer->slot)
+	{
+		index = timer->slot - &timers->slots[0][0];
+		timers->occupied[index / CLI_TIMER_SLOTS] &= ~((uint64_t)1 << (index % CLI_TIMER_SLOTS));
+	}
+
+	timer->slot = NULL;
+	timer->previous = timer->next = NULL;
+	timers->count--;
+}
+
+/* sets the timerfd for the soonest tick something happens. That is a timer on the lowest level or a higher
+level slot that has to be spread, so the wheel never wakes up just to turn */
+void cli_timers_arm(cli_timers_t *timers)
+{
+	struct itimerspec when;
+	uint64_t next = 0, at, bits;
+	unsigned int level, shift;
+
+
+	for(level = 0; level < CLI_TIMER_LEVELS; ++level)
+		if((bits = timers->occupied[level]))
+		{
+			/* rotate so the slot after the current one is the lowest bit. The current slot itself is a whole turn away */
+			shift = ((timers->now >> (CLI_TIMER_BITS * level)) + 1) & (CLI_TIMER_SLOTS - 1);
+			bits = (bits >> shift) | (bits << ((CLI_TIMER_SLOTS - shift) & (CLI_TIMER_SLOTS - 1)));
+
+			at = ((timers->now >> (CLI_TIMER_BITS * level)) + __builtin_ctzll(bits) + 1) << (CLI_TIMER_BITS * level);
+			if(!next || at < next)
+				next = at;
+		}
+
+	if(next == timers->armed)
+		return;
+
+	memset(&when, 0, sizeof(struct itimerspec));
+	when.it_value.tv_sec = next / 1000;
+	when.it_value.tv_nsec = (next % 1000) * 1000000;
+
+	if(!timerfd_settime(timers->fd, TFD_TIMER_ABSTIME, &when, NULL))
+		timers->armed = next;
+}
+
+/* puts a timer in the wheel, opening the timerfd first if this is the first one */
+int cli_timers_add(cli_timers_t *timers, cli_timer_t *timer, uint64_t delay)
+{
+	uint64_t now = cli_timers_tick();
+
+
+	if(!timers->opened)
+	{
+		if((timers->fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) == -1)
+			return 1;
+		timers->opened = 1;
+		timers->now = now;
+	}
+
+	if(!timers->count)
+		timers->now = now;
+
+	/* the current tick already fired, so the soonest anything can go is the next one */
+	timer->expires = now + delay > timers->now ? now + delay : timers->now + 1;
+	cli_timers_link(timers, timer);
+	timer->references++;
+
+	cli_timers_arm(timers);
+
+	return 0;
+}
+
+/* a handle to a new timer that calls function after delay milliseconds, and then every delay milliseconds when periodic */
+sts_value_t *cli_timer_start(sts_script_t *script, sts_value_t *function, double delay, int periodic)
+{
+	cli_timer_t *timer = NULL;
+	sts_value_t *ret = NULL;
+
+
+	if(!(timer = calloc(1, sizeof(cli_timer_t))))
+	{
+		STS_ERROR_SIMPLE("could not allocate timer");
+		return NULL;
+	}
+
+	timer->function = function;
+	STS_VALUE_REFINC(script, function);
+
+	if(delay < 0.0 || (periodic && delay < 1.0))
+		delay = periodic;
+	timer->period = periodic ? (unsigned long)delay : 0;
+
+	if(!(ret = cli_timer_value(script, timer)))
+	{
+		cli_timer_release(script, timer);
+		return NULL;
+	}
+
+	if(cli_timers_add(&CLI_STATE(script)->timers, timer, (uint64_t)delay))
+	{
+		STS_ERROR_SIMPLE("could not create timerfd");
+		sts_value_reference_decrement(script, ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+/* returns nonzero if the timer already fired or was cancelled */
+int cli_timers_cancel(sts_script_t *script, cli_timers_t *timers, cli_timer_t *timer)
+{
+	if(!timer->slot)
+	{
+		if(!timer->calling || !timer->period)
+			return 1;
+
+		timer->period = 0; /* cli_timers_call lets go of it once its function returns */
+		return 0;
+	}
+
+	cli_timers_unlink(timers, timer);
+	cli_timer_release(script, timer);
+	cli_timers_arm(timers);
+
+	return 0;
+}
+
+/* turns the wheel up to the current tick, moving everything that came due on the way to the due list. Nothing is
+called from here, since this runs in the middle of polling */
+void cli_timers_run(sts_script_t *script)
+{
+	cli_timers_t *timers = &CLI_STATE(script)->timers;
+	cli_timer_t *timer = NULL, *next = NULL;
+	uint64_t target = cli_timers_tick(), expirations;
+	unsigned int level, index;
+
+
+	if(read(timers->fd, &expirations, sizeof(uint64_t)) == -1 && errno != EAGAIN)
+		fprintf(stderr, "could not read timerfd\n");
+	timers->armed = 0;
+
+	while(timers->count > 0 && timers->now < target)
+	{
+		timers->now++;
+
+		/* spreading a higher level slot only happens when all of the levels under it come back around */
+		for(level = 1; level < CLI_TIMER_LEVELS && !(timers->now & (((uint64_t)1 << (CLI_TIMER_BITS * level)) - 1)); ++level)
+		{
+			index = (timers->now >> (CLI_TIMER_BITS * level)) & (CLI_TIMER_SLOTS - 1);
+			timer = timers->slots[level][index];
+			timers->slots[level][index] = NULL;
+			timers->occupied[level] &= ~((uint64_t)1 << index);
+
+			for(; timer; timer = next)
+			{
+				next = timer->next;
+				timers->count--;
+				cli_timers_link(timers, timer);
+			}
+		}
+
+		index = timers->now & (CLI_TIMER_SLOTS - 1);
+		timer = timers->slots[0][index];
+		timers->slots[0][index] = NULL;
+		timers->occupied[0] &= ~((uint64_t)1 << index);
+
+		for(; timer; timer = next)
+		{
+			next = timer->next;
+			timer->slot = &timers->due;
+			timer->next = NULL;
+			if((timer->previous = timers->due_last))
+				timers->due_last->next = timer;
+			else
+				timers->due = timer;
+			timers->due_last = timer;
+		}
+	}
+
+	if(!timers->count)
+		timers->now = target;
+
+	cli_timers_arm(timers);
+}
+
+/* calls the function of every due timer with the timer and the clock-monotonic time it was due. This only happens
+from the scheduler, outside of every coroutine, so a function that waits on something lets the coroutines run
+but holds up the timers behind it. Returns nonzero if anything was called */
+int cli_timers_call(sts_script_t *script)
+{
+	cli_timers_t *timers = &CLI_STATE(script)->timers;
+	cli_timer_t *timer = NULL;
+	sts_value_t *arguments = NULL, *temp = NULL;
+	int ret = 0;
+
+
+	while((timer = timers->due))
+	{
+		/* the reference the wheel had is kept until the function returns */
+		cli_timers_unlink(timers, timer);
+		timer->calling = 1;
+		ret = 1;
+
+		if((arguments = sts_value_create(script, STS_ARRAY)))
+		{
+			if((temp = cli_timer_value(script, timer)))
+				sts_array_append_insert(script, arguments, temp, arguments->array.length);
+			if(temp && (temp = sts_value_from_number(script, (double)timer->expires / 1000.0)))
+				sts_array_append_insert(script, arguments, temp, arguments->array.length);
+
+			if(!temp || !(temp = sts_function_call(script, timer->function, arguments)))
+				fprintf(stderr, "function failed in timer\n");
+			else
+				sts_value_reference_decrement(script, temp);
+
+			sts_value_reference_decrement(script, arguments);
+		}
+		else
+			STS_ERROR_SIMPLE("could not create argument array for timer");
+
+		timer->calling = 0;
+
+		/* every firing is a period after the last one so they never drift. Ones that were missed are skipped */
+		if(timer->period)
+		{
+			timer->expires += timer->period;
+			if(timer->expires <= timers->now)
+				timer->expires += ((timers->now - timer->expires) / timer->period + 1) * timer->period;
+			cli_timers_link(timers, timer);
+			cli_timers_arm(timers);
+		}
+		else
+			cli_timer_release(script, timer);
+	}
+
+	return ret;
+}
+
+/* cancels every timer that is left so their functions are released before the interpreter is */
+void cli_timers_finish(sts_script_t *script)
+{
+	cli_timers_t *timers = &CLI_STATE(script)->timers;
+	cli_timer_t *timer = NULL;
+	unsigned int level, index;
+
+
+	for(level = 0; level < CLI_TIMER_LEVELS; ++level)
+		for(index = 0; index < CLI_TIMER_SLOTS; ++index)
+			while((timer = timers->slots[level][index]))
+			{
+				cli_timers_unlink(timers, timer);
+				cli_timer_release(script, timer);
+			}
+
+	while((timer = timers->due))
+	{
+		cli_timers_unlink(timers, timer);
+		cli_timer_release(script, timer);
+	}
+
+	if(timers->opened)
+		close(timers->fd);
+
+	memset(timers, 0, sizeof(cli_timers_t));
+}
+#endif
+
+/* polls every coroutine waiting on an fd and readies the ones that can continue. fd is one more the scheduler itself
+waits on. The timerfd goes last while there are timers, so the ones that come due fire from here */
+int cli_coroutine_poll(sts_script_t *script, int fd, short events, int timeout)
+{
+	cli_scheduler_t *scheduler = &CLI_STATE(script)->scheduler;
+	cli_coroutine_queue_t waiting;
+	cli_coroutine_t *coroutine = NULL;
+	struct pollfd *fds = NULL;
+	unsigned int total = fd >= 0, i = 0;
+	#ifndef CLI_NO_TIMERS
+	unsigned int timed = 0;
+	#endif
+
+
+	for(coroutine = scheduler->fds.head; coroutine; coroutine = coroutine->next)
+		total++;
+
+	#ifndef CLI_NO_TIMERS
+	if(CLI_STATE(script)->timers.count)
+		timed = ++total;
+	#endif
+
+	if(!total)
+		return 0;
+
+	if(!(fds = malloc(sizeof(struct pollfd) * total)))
+	{
+		STS_ERROR_SIMPLE("could not allocate poll set");
+		return 0;
+	}
+
+	for(coroutine = scheduler->fds.head; coroutine; coroutine = coroutine->next, ++i)
+	{
+		fds[i].fd = coroutine->fd;
+		fds[i].events = coroutine->events;
+		fds[i].revents = 0;
+	}
+
+	if(fd >= 0)
+	{
+		fds[i].fd = fd;
+		fds[i].events = events;
+		fds[i].revents = 0;
+	}
+
+	#ifndef CLI_NO_TIMERS
+	if(timed)
+	{
+		fds[timed - 1].fd = CLI_STATE(script)->timers.fd;
+		fds[timed - 1].events = POLLIN;
+		fds[timed - 1].revents = 0;
+	}
+	#endif
+
+	if(poll(fds, total, timeout) > 0)
+	{
+		waiting = scheduler->fds;
+		memset(&scheduler->fds, 0, sizeof(cli_coroutine_queue_t));
+
+		for(i = 0; (coroutine = cli_coroutine_queue_pop(&waiting)); ++i)
+		{
+			if(fds[i].revents)
+			{
+				coroutine->state = CLI_COROUTINE_READY;
+				coroutine->revents = fds[i].revents;
+				cli_coroutine_queue_push(&scheduler->ready, coroutine);
+			}
+			else
+				cli_coroutine_queue_push(&scheduler->fds, coroutine);
+		}
+
+		#ifndef CLI_NO_TIMERS
+		if(timed && fds[timed - 1].revents)
+			cli_timers_run(script);
+		#endif
+	}
+
+	free(fds);
+
+	return 1;
+}
+
+/* runs every coroutine that was ready once. If none were, it blocks until one of the fds being waited on is ready,
+including fd which the scheduler itself waits on. Returns 0 if nothing could ever make progress */
+int cli_coroutine_round(sts_script_t *script, int fd, short events)
+{
+	cli_scheduler_t *scheduler = &CLI_STATE(script)->scheduler;
+	cli_coroutine_queue_t round = scheduler->ready;
+	cli_coroutine_t *coroutine = NULL;
+	unsigned int ran = 0;
+
+
+	/* anything readied while this round runs waits for the next one */
+	memset(&scheduler->ready, 0, sizeof(cli_coroutine_queue_t));
+
+	while((coroutine = cli_coroutine_queue_pop(&round)))
+	{
+		scheduler->current = coroutine;
+		swapcontext(&scheduler->context, &coroutine->context);
+		scheduler->current = NULL;
+		ran++;
+
+		if(coroutine->state == CLI_COROUTINE_DONE)
+			cli_coroutine_remove(script, coroutine);
+	}
+
+	/* only sleep if there is nothing else to do */
+	#ifndef CLI_NO_TIMERS
+	ran = cli_coroutine_poll(script, fd, events, ran || scheduler->ready.head ? 0 : -1) || ran;
+
+	return cli_timers_call(script) || ran;
+	#else
+	return cli_coroutine_poll(script, fd, events, ran || scheduler->ready.head ? 0 : -1) || ran;
+	#endif
+}
+
+/* gives up the rest of this turn until queue wakes it or fd is ready. With neither it just yields.
+Outside of a coroutine this runs a round instead, so the caller has to check again in a loop */
+int cli_coroutine_wait(sts_script_t *script, cli_coroutine_queue_t *queue, int fd, short events)
+{
+	cli_scheduler_t *scheduler = NULL;
+	cli_coroutine_t *coroutine = NULL;
+
+
+	/* parallel-map workers have no scheduler, so nothing could ever wake them */
+	if(!CLI_STATE(script))
+		return 0;
+
+	scheduler = &CLI_STATE(script)->scheduler;
+
+	if(!(coroutine = scheduler->current))
+		return cli_coroutine_round(script, fd, events);
+
+	if(queue)
+		coroutine->state = CLI_COROUTINE_WAITING;
+	else if(fd >= 0)
+	{
+		coroutine->state = CLI_COROUTINE_WAITING_FD;
+		queue = &scheduler->fds;
+	}
+	else
+	{
+		coroutine->state = CLI_COROUTINE_READY;
+		queue = &scheduler->ready;
+	}
+
+	coroutine->fd = fd;
+	coroutine->events = events;
+	cli_coroutine_queue_push(queue, coroutine);
+
+	swapcontext(&coroutine->context, &scheduler->context);
+
+	return 1;
+}
+
+/* lets every other coroutine run while a blocking fd isnt ready yet. Does nothing if there arent any coroutines */
+void cli_coroutine_wait_fd(sts_script_t *script, int fd, short events)
+{
+	struct pollfd single;
+
+
+	if(!CLI_STATE(script) || (!CLI_STATE(script)->scheduler.current && !CLI_STATE(script)->scheduler.count))
+	{
+		#ifndef CLI_NO_TIMERS
+		if(!CLI_STATE(script) || !CLI_STATE(script)->timers.count)
+		#endif
+			return;
+	}
+
+	single.fd = fd;
+	single.events = events;
+	single.revents = 0;
+
+	while(!poll(&single, 1, 0))
+		if(!cli_coroutine_wait(script, NULL, fd, events))
+			return;
+}
+
+/* runs the coroutines and timers that are left after the script finishes, then frees everything */
+void cli_coroutine_finish(sts_script_t *script)
+{
+	cli_scheduler_t *scheduler = NULL;
+
+
+	if(!CLI_STATE(script))
+		return;
+
+	scheduler = &CLI_STATE(script)->scheduler;
+
+	#ifndef CLI_NO_TIMERS
+	while(scheduler->count || CLI_STATE(script)->timers.count)
+	#else
+	while(scheduler->count)
+	#endif
+		if(!cli_coroutine_round(script, -1, 0))
+		{
+			fprintf(stderr, "%u coroutines are waiting on something that will never happen\n", scheduler->count);
+			break;
+		}
+
+	#ifndef CLI_NO_TIMERS
+	cli_timers_finish(script);
+	#endif
+
+	while(scheduler->all)
+		cli_coroutine_remove(script, scheduler->all);
+
+	while(scheduler->stack_count)
+		munmap(scheduler->stacks[--scheduler->stack_count], CLI_COROUTINE_STACK_SIZE);
+
+	memset(scheduler, 0, sizeof(cli_scheduler_t));
+}
+
+sts_value_t *cli_coroutine_value(sts_script_t *script, void *data, int (*refdec)(sts_script_t *, sts_value_t *), void (*refinc)(sts_script_t *, sts_value_t *))
+{
+	sts_value_t *ret = NULL;
+
+
+	if(!(ret = sts_value_create(script, STS_EXTERNAL)))
+	{
+		STS_ERROR_SIMPLE("could not create coroutine external value");
+		return NULL;
+	}
+
+	ret->external.refdec = refdec;
+	ret->external.refinc = refinc;
+	ret->external.data_ptr = data;
+
+	return ret;
+}
+#else
+#define cli_coroutine_wait_fd(script, fd, events)
+#define cli_coroutine_finish(script)
+#endif
+
+/* a future from one of the *-async actions. The job runs on the thread pool and only ever touches the plain
+buffers in here, never values, so the result is turned into a string once the script collects it */
+typedef struct cli_future_t cli_future_t;
+
+struct cli_future_t
+{
+	unsigned long references; /* a queued or running job holds one */
+	#ifndef CLI_NO_THREADS
+	pthread_mutex_t lock;
+	int signal[2]; /* the job writes a byte once it is done, so waiting is a poll on the read end */
+	#endif
+	char done, failed;
+	int (*run)(cli_future_t *future, void *scratch); /* returns nonzero if the job failed */
+	unsigned long scratch_size; /* memory the job needs. Workers keep theirs between jobs */
+	char *input[2]; /* copies of the arguments */
+	unsigned long input_length[2], numbers[2];
+	char *data; /* the result */
+	unsigned long length;
+};
+
+#define CLI_FUTURE(value) ((cli_future_t *)value->external.data_ptr)
+#define IS_CLI_FUTURE(value) (value->type == STS_EXTERNAL && value->external.refdec == &cli_future_refdec)
+
+void cli_future_release(cli_future_t *future)
+{
+	unsigned int i;
+
+
+	#ifndef CLI_NO_THREADS
+	pthread_mutex_lock(&future->lock);
+	if(future->references && --future->references)
+	{
+		pthread_mutex_unlock(&future->lock);
+		return;
+	}
+	pthread_mutex_unlock(&future->lock);
+
+	pthread_mutex_destroy(&future->lock);
+	if(future->signal[0] != -1) close(future->signal[0]);
+	if(future->signal[1] != -1) close(future->signal[1]);
+	#else
+	if(future->references && --future->references)
+		return;
+	#endif
+
+	for(i = 0; i < 2; ++i)
+		if(future->input[i])
+		{
+			crypto_wipe(future->input[i], future->input_length[i]);
+			free(future->input[i]);
+		}
+
+	if(future->data) free(future->data);
+	free(future);
+}
+
+int cli_future_refdec(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_FUTURE(value))
+		cli_future_release(CLI_FUTURE(value));
+
+	return 0;
+}
+
+void cli_future_refinc(sts_script_t *script, sts_value_t *value)
+{
+	if(IS_CLI_FUTURE(value))
+	{
+		#ifndef CLI_NO_THREADS
+		pthread_mutex_lock(&CLI_FUTURE(value)->lock);
+		CLI_FUTURE(value)->references++;
+		pthread_mutex_unlock(&CLI_FUTURE(value)->lock);
+		#else
+		CLI_FUTURE(value)->references++;
+		#endif
+	}
+}
+
+/* copies the string arguments of a job so the script can free them while it runs */
+cli_future_t *cli_future_new(int (*run)(cli_future_t *future, void *scratch), unsigned long scratch_size, sts_value_t *first, sts_value_t *second)
+{
+	cli_future_t *ret = NULL;
+	sts_value_t *inputs[2];
+	unsigned int i;
+
+
+	inputs[0] = first;
+	inputs[1] = second;
+
+	if(!(ret = calloc(1, sizeof(cli_future_t))))
+		return NULL;
+
+	ret->references = 1;
+	ret->run = run;
+	ret->scratch_size = scratch_size;
+
+	#ifndef CLI_NO_THREADS
+	ret->signal[0] = ret->signal[1] = -1;
+	pthread_mutex_init(&ret->lock, NULL);
+
+	if(pipe(ret->signal) || fcntl(ret->signal[0], F_SETFD, FD_CLOEXEC) || fcntl(ret->signal[1], F_SETFD, FD_CLOEXEC))
+	{
+		cli_future_release(ret);
+		return NULL;
+	}
+	#endif
+
+	for(i = 0; i < 2; ++i)
+		if(inputs[i])
+		{
+			if(!(ret->input[i] = malloc(inputs[i]->string.length + 1)))
+			{
+				cli_future_release(ret);
+				return NULL;
+			}
+
+			memcpy(ret->input[i], inputs[i]->string.data, inputs[i]->string.length + 1);
+			ret->input_length[i] = inputs[i]->string.length;
+		}
+
+	return ret;
+}
+
+int cli_future_done(cli_future_t *future)
+{
+	int ret;
+
+
+	#ifndef CLI_NO_THREADS
+	pthread_mutex_lock(&future->lock);
+	ret = future->done;
+	pthread_mutex_unlock(&future->lock);
+	#else
+	ret = future->done;
+	#endif
+
+	return ret;
+}
+
+#ifndef CLI_NO_THREADS
+void cli_future_job(sts_pool_worker_t *worker, void *data)
+{
+	cli_future_t *future = data;
+	void *scratch = NULL;
+	int failed;
+
+
+	failed = (future->scratch_size && !(scratch = sts_pool_worker_scratch(worker, future->scratch_size))) || future->run(future, scratch);
+
+	pthread_mutex_lock(&future->lock);
+	future->failed = failed;
+	future->done = 1;
+	pthread_mutex_unlock(&future->lock);
+
+	/* never read, so the pipe stays readable for everything that waits on it */
+	if(write(future->signal[1], "", 1) != 1)
+		fprintf(stderr, "could not signal that a future is done\n");
+
+	cli_future_release(future);
+}
+#endif
+
+/* runs the job on the pool of the script. Without one, like inside of a worker or when there are no threads, it runs here and
+the future is already done. Returns nonzero if it could not be started */
+int cli_future_start(sts_script_t *script, cli_future_t *future)
+{
+	void *scratch = NULL;
+
+
+	#ifndef CLI_NO_THREADS
+	if(CLI_STATE(script) && (CLI_STATE(script)->pool || (CLI_STATE(script)->pool = sts_pool_create(script, 0))))
+	{
+		future->references++;
+
+		if(sts_pool_submit(CLI_STATE(script)->pool, &cli_future_job, future))
+			return 0;
+
+		future->references--;
+		return 1;
+	}
+	#endif
+
+	if(future->scratch_size && !(scratch = malloc(future->scratch_size)))
+		return 1;
+
+	future->failed = future->run(future, scratch);
+	future->done = 1;
+
+	if(scratch) free(scratch);
+
+	return 0;
+}
+
+/* blocks until the job is done, letting other coroutines run meanwhile. Returns the result as a string, or nil if the job failed */
+sts_value_t *cli_future_wait(sts_script_t *script, cli_future_t *future)
+{
+	#ifndef CLI_NO_THREADS
+	struct pollfd single;
+
+
+	single.fd = future->signal[0];
+	single.events = POLLIN;
+
+	while(!cli_future_done(future))
+	{
+		cli_coroutine_wait_fd(script, future->signal[0], POLLIN);
+		single.revents = 0;
+		poll(&single, 1, -1);
+	}
+	#endif
+
+	if(future->failed)
+		return sts_value_create(script, STS_NIL);
+
+	return sts_value_from_nstring(script, future->data, future->length);
+}
+
+int cli_future_argon2i(cli_future_t *future, void *scratch)
+{
+	if(!(future->data = malloc(32 + 1)))
+		return 1;
+
+	future->data[32] = 0;
+	future->length = 32;
+
+	crypto_argon2i((uint8_t *)future->data, future->length, scratch, future->numbers[0], future->numbers[1], (uint8_t *)future->input[0], future->input_length[0], (uint8_t *)future->input[1], future->input_length[1]);
+
+	return 0;
+}
+
+#ifndef CLI_NO_SOCKETS
+/* reads more into the socket buffer. Returns the amount read, 0 once the peer is gone, -1 on errors, -2 if a nonblocking socket has nothing yet,
+and -3 if the buffer is full at CLI_SOCKET_BUFFER_MAX */
+long cli_socket_fill(sts_script_t *script, cli_socket_t *socket)
+{
+	char *temp = NULL;
+	long ret;
+
+
+	if(!socket->buffer.data)
+	{
+		if(!socket->buffer.size)
+			socket->buffer.size = CLI_SOCKET_BUFFER_SIZE;
+
+		if(!(socket->buffer.data = malloc(socket->buffer.size)))
+		{
+			STS_ERROR_SIMPLE("could not allocate socket buffer");
+			return -1;
+		}
+	}
+
+	/* keep what is buffered in one piece so it can be scanned in one go */
+	if(socket->buffer.start == socket->buffer.end)
+		socket->buffer.start = socket->buffer.end = 0;
+	else if(socket->buffer.end == socket->buffer.size && socket->buffer.start)
+	{
+		memmove(socket->buffer.data, &socket->buffer.data[socket->buffer.start], socket->buffer.end - socket->buffer.start);
+		socket->buffer.end -= socket->buffer.start;
+		socket->buffer.start = 0;
+	}
+
+	if(socket->buffer.end == socket->buffer.size)
+	{
+		if(socket->buffer.size >= CLI_SOCKET_BUFFER_MAX)
+			return -3;
+
+		if(!(temp = realloc(socket->buffer.data, socket->buffer.size * 2 > CLI_SOCKET_BUFFER_MAX ? CLI_SOCKET_BUFFER_MAX : socket->buffer.size * 2)))
+		{
+			STS_ERROR_SIMPLE("could not resize socket buffer");
+			return -1;
+		}
+
+		socket->buffer.data = temp;
+		socket->buffer.size = socket->buffer.size * 2 > CLI_SOCKET_BUFFER_MAX ? CLI_SOCKET_BUFFER_MAX : socket->buffer.size * 2;
+	}
+
+	if(socket->socket.non_blocking)
+	{
+		if(!socket->ssl && cli_socket_fd_would_block(socket))
+			return -2;
+	}
+	else if(!socket->ssl)
+		cli_coroutine_wait_fd(script, socket->socket.handle, POLLIN);
+
+	if(socket->ssl)
+		ret = SSL_read(socket->ssl, &socket->buffer.data[socket->buffer.end], socket->buffer.size - socket->buffer.end);
+	else
+		ret = zed_net_tcp_socket_receive(&socket->socket, &socket->buffer.data[socket->buffer.end], socket->buffer.size - socket->buffer.end);
+
+	if(ret > 0)
+		socket->buffer.end += ret;
+
+	return ret;
+}
+
+/* returns the next length bytes as a string, or everything up to delim if there is one. The delim is consumed but not returned.
+Returns the number 1 while a nonblocking socket doesnt have enough yet and -1 on errors or once a closed socket has nothing left */
+sts_value_t *cli_socket_read_buffer(sts_script_t *script, cli_socket_t *socket, char *delim, unsigned long delim_length, unsigned long length)
+{
+	sts_value_t *ret = NULL;
+	unsigned long scanned = 0, found = 0, skip = 0;
+	char *match = NULL;
+	long got;
+
+
+	while(1)
+	{
+		if(delim)
+		{
+			/* only what arrived since the last scan is searched again */
+			while(scanned + delim_length <= socket->buffer.end - socket->buffer.start && (match = memchr(&socket->buffer.data[socket->buffer.start + scanned], delim[0], socket->buffer.end - socket->buffer.start - scanned - delim_length + 1)))
+			{
+				if(!memcmp(match, delim, delim_length))
+					break;
+
+				scanned = match - &socket->buffer.data[socket->buffer.start] + 1;
+				match = NULL;
+			}
+
+			if(match)
+			{
+				found = match - &socket->buffer.data[socket->buffer.start];
+				skip = delim_length;
+				break;
+			}
+
+			if(socket->buffer.end - socket->buffer.start >= delim_length)
+				scanned = socket->buffer.end - socket->buffer.start - delim_length + 1;
+		}
+		else if(socket->buffer.end - socket->buffer.start >= length)
+		{
+			found = length;
+			break;
+		}
+
+		if((got = cli_socket_fill(script, socket)) == -2)
+			return sts_value_from_number(script, 1);
+		else if(got == -3)
+		{
+			fprintf(stderr, "a socket read needs more than the %lu bytes CLI_SOCKET_BUFFER_MAX allows\n", (unsigned long)CLI_SOCKET_BUFFER_MAX);
+			return sts_value_from_number(script, -1);
+		}
+		else if(got <= 0)
+		{
+			if(socket->buffer.end == socket->buffer.start)
+				return sts_value_from_number(script, -1);
+
+			/* whatever was left before the peer left */
+			found = socket->buffer.end - socket->buffer.start;
+			break;
+		}
+	}
+
+	if(!(ret = sts_value_create(script, STS_STRING)))
+	{
+		STS_ERROR_SIMPLE("could not create string for a socket read");
+		return NULL;
+	}
+
+	if(!(ret->string.data = sts_memdup(&socket->buffer.data[socket->buffer.start], found)))
+	{
+		STS_ERROR_SIMPLE("could not copy string for a socket read");
+		sts_value_reference_decrement(script, ret);
+		return NULL;
+	}
+
+	ret->string.length = found;
+	socket->buffer.start += found + skip;
+
+	return ret;
+}
+
+sts_value_t *cli_socket_read(sts_script_t *script, cli_socket_t *socket, char *delim, unsigned long delim_length, unsigned long length)
+{
+	sts_value_t *ret = cli_socket_read_buffer(script, socket, delim, delim_length, length);
+
+
+	cli_socket_poller_update(socket);
+
+	return ret;
+}
+
+#ifndef CLI_WINDOWS
+/* waits until a nonblocking socket is ready again. Other coroutines run meanwhile */
+void cli_socket_wait(sts_script_t *script, cli_socket_t *socket, short events)
+{
+	struct pollfd single;
+
+
+	cli_coroutine_wait_fd(script, socket->socket.handle, events);
+
+	single.fd = socket->socket.handle;
+	single.events = events;
+	single.revents = 0;
+
+	while(poll(&single, 1, -1) == -1 && errno == EINTR);
+}
+#endif
+
+/* sends length bytes of a file starting at offset, or the rest of it if length is negative. sendfile keeps the file out of user space.
+Tls sockets and systems without it read the file in chunks instead. Returns the amount sent or -1 */
+long cli_socket_sendfile(sts_script_t *script, cli_socket_t *socket, char *path, long offset, long length)
+{
+	FILE *file = NULL;
+	char *chunk = NULL;
+	long ret = 0, got = 0;
+	#ifdef __linux__
+	struct stat info;
+	off_t position = offset;
+	ssize_t sent;
+	int fd;
+
+
+	if(!socket->ssl)
+	{
+		if((fd = open(path, O_RDONLY | O_CLOEXEC)) == -1)
+			return -1;
+
+		if(fstat(fd, &info))
+		{
+			close(fd);
+			return -1;
+		}
+
+		if(length < 0 || offset + length > info.st_size)
+			length = info.st_size > offset ? info.st_size - offset : 0;
+
+		while(ret < length)
+		{
+			if((sent = sendfile(socket->socket.handle, fd, &position, length - ret)) > 0)
+				ret += sent;
+			else if(sent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+				cli_socket_wait(script, socket, POLLOUT);
+			else if(sent == -1 && errno == EINTR)
+				continue;
+			else
+			{
+				if(sent == -1 && !ret)
+					ret = -1;
+				break;
+			}
+		}
+
+		close(fd);
+
+		return ret;
+	}
+	#endif
+
+	if(!(file = fopen(path, "rb")))
+		return -1;
+
+	if(fseek(file, offset, SEEK_SET) || !(chunk = malloc(CLI_SENDFILE_CHUNK)))
+	{
+		fclose(file);
+		return -1;
+	}
+
+	while(length < 0 || ret < length)
+	{
+		if((got = fread(chunk, 1, length < 0 || length - ret > CLI_SENDFILE_CHUNK ? CLI_SENDFILE_CHUNK : length - ret, file)) <= 0)
+			break;
+
+		if(socket->ssl ? SSL_write(socket->ssl, chunk, got) != got : zed_net_tcp_socket_send(&socket->socket, chunk, got) != 0)
+		{
+			if(!ret)
+				ret = -1;
+			break;
+		}
+
+		ret += got;
+	}
+
+	free(chunk);
+	fclose(file);
+
+	return ret;
+}
+
+/* sends every string in an array as if they were one. Plain sockets hand the strings to writev as they are and
+everything else joins them once first. Returns the amount sent or -1 */
+long cli_socket_sendv(sts_script_t *script, cli_socket_t *socket, sts_value_t *array)
+{
+	char *joined = NULL;
+	long ret = 0, total = 0;
+	unsigned int i;
+	#ifndef CLI_WINDOWS
+	struct iovec *pieces = NULL;
+	unsigned int first = 0, count;
+	ssize_t sent;
+	#endif
+
+
+	for(i = 0; i < array->array.length; ++i)
+		total += array->array.data[i]->string.length;
+
+	#ifndef CLI_WINDOWS
+	if(!socket->ssl)
+	{
+		if(!array->array.length)
+			return 0;
+
+		if(!(pieces = malloc(sizeof(struct iovec) * array->array.length)))
+		{
+			STS_ERROR_SIMPLE("could not allocate pieces for sendv");
+			return -1;
+		}
+
+		for(i = 0; i < array->array.length; ++i)
+		{
+			pieces[i].iov_base = array->array.data[i]->string.data;
+			pieces[i].iov_len = array->array.data[i]->string.length;
+		}
+
+		while(ret < total)
+		{
+			count = array->array.length - first > IOV_MAX ? IOV_MAX : array->array.length - first;
+
+			if((sent = writev(socket->socket.handle, &pieces[first], count)) == -1)
+			{
+				if(errno == EAGAIN || errno == EWOULDBLOCK)
+				{
+					cli_socket_wait(script, socket, POLLOUT);
+					continue;
+				}
+				else if(errno == EINTR)
+					continue;
+
+				if(!ret)
+					ret = -1;
+				break;
+			}
+
+			ret += sent;
+
+			/* skip what was sent and continue in the middle of a partly sent piece */
+			while(first < array->array.length && (size_t)sent >= pieces[first].iov_len)
+				sent -= pieces[first++].iov_len;
+			if(first < array->array.length)
+			{
+				pieces[first].iov_base = (char *)pieces[first].iov_base + sent;
+				pieces[first].iov_len -= sent;
+			}
+		}
+
+		free(pieces);
+
+		return ret;
+	}
+	#endif
+
+	if(!(joined = malloc(total + 1)))
+	{
+		STS_ERROR_SIMPLE("could not join strings for sendv");
+		return -1;
+	}
+
+	for(i = 0; i < array->array.length; ++i)
+	{
+		memcpy(&joined[ret], array->array.data[i]->string.data, array->array.data[i]->string.length);
+		ret += array->array.data[i]->string.length;
+	}
+
+	if(socket->ssl ? SSL_write(socket->ssl, joined, total) != total : zed_net_tcp_socket_send(&socket->socket, joined, total) != 0)
+		ret = -1;
+
+	free(joined);
+
+	return ret;
+}
+
+/* makes room for headers datagram headers and slots receive buffers in the batch buffers of a socket */
+int cli_socket_batch_reserve(cli_socket_t *socket, unsigned int headers, unsigned int slots)
+{
+	void *temp = NULL;
+
+
+	#ifdef __linux__
+	if(headers > socket->batch.headers_allocated)
+	{
+		if(!(temp = realloc(socket->batch.headers, sizeof(struct mmsghdr) * headers)))
+			return 1;
+		socket->batch.headers = temp;
+
+		if(!(temp = realloc(socket->batch.pieces, sizeof(struct iovec) * headers)))
+			return 1;
+		socket->batch.pieces = temp;
+
+		if(!(temp = realloc(socket->batch.addresses, sizeof(struct sockaddr_in) * headers)))
+			return 1;
+		socket->batch.addresses = temp;
+
+		socket->batch.headers_allocated = headers;
+	}
+	#endif
+
+	if(slots > socket->batch.allocated)
+	{
+		/* nothing in the old slots has to survive */
+		free(socket->batch.data);
+		socket->batch.allocated = 0;
+
+		if(!(socket->batch.data = malloc((size_t)CLI_UDP_DATAGRAM_SIZE * slots)))
+			return 1;
+
+		socket->batch.allocated = slots;
+	}
+
+	return 0;
+}
+
+/* creates the [address port data] array the batch functions use for a datagram */
+sts_value_t *cli_datagram_value(sts_script_t *script, unsigned int host, unsigned short port, char *data, unsigned long length)
+{
+	sts_value_t *ret = NULL, *temp = NULL;
+
+
+	if(!(ret = sts_value_create(script, STS_ARRAY)))
+		return NULL;
+
+	if(!(temp = sts_value_from_string(script, (char *)zed_net_host_to_str(host))))
+		goto error;
+	sts_array_append_insert(script, ret, temp, ret->array.length);
+
+	if(!(temp = sts_value_from_number(script, port)))
+		goto error;
+	sts_array_append_insert(script, ret, temp, ret->array.length);
+
+	if(!(temp = sts_value_from_nstring(script, data, length)))
+		goto error;
+	sts_array_append_insert(script, ret, temp, ret->array.length);
+
+	return ret;
+
+	error:
+	sts_value_reference_decrement(script, ret);
+
+	return NULL;
+}
+
+/* receives up to max datagrams, all with one recvmmsg call where it exists. Returns an array of [address port data] arrays,
+a 1 if a nonblocking socket has nothing waiting, or -1 */
+sts_value_t *cli_socket_recv_batch(sts_script_t *script, cli_socket_t *socket, unsigned int max)
+{
+	sts_value_t *ret = NULL, *temp = NULL;
+	unsigned int i;
+	int got;
+	#ifndef __linux__
+	zed_net_address_t address;
+	#endif
+
+
+	/* every slot is a whole datagram, so a script asking for huge batches would allocate huge buffers */
+	if(max > CLI_UDP_BATCH_MAX)
+		max = CLI_UDP_BATCH_MAX;
+
+	#ifdef __linux__
+	if(cli_socket_batch_reserve(socket, max, max))
+	#else
+	if(cli_socket_batch_reserve(socket, 0, 1))
+	#endif
+	{
+		STS_ERROR_SIMPLE("could not allocate the batch buffers of a socket");
+		return NULL;
+	}
+
+	/* a blocking socket lets the other coroutines run while it waits */
+	if(!socket->socket.non_blocking)
+		cli_coroutine_wait_fd(script, socket->socket.handle, POLLIN);
+
+	#ifdef __linux__
+	for(i = 0; i < max; ++i)
+	{
+		socket->batch.pieces[i].iov_base = &socket->batch.data[(size_t)CLI_UDP_DATAGRAM_SIZE * i];
+		socket->batch.pieces[i].iov_len = CLI_UDP_DATAGRAM_SIZE;
+
+		memset(&socket->batch.headers[i], 0, sizeof(struct mmsghdr));
+		socket->batch.headers[i].msg_hdr.msg_name = &socket->batch.addresses[i];
+		socket->batch.headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+		socket->batch.headers[i].msg_hdr.msg_iov = &socket->batch.pieces[i];
+		socket->batch.headers[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	/* a blocking socket only waits for the first datagram and takes whatever else is already there */
+	while((got = recvmmsg(socket->socket.handle, socket->batch.headers, max, socket->socket.non_blocking ? MSG_DONTWAIT : MSG_WAITFORONE, NULL)) == -1 && errno == EINTR);
+
+	if(got == -1)
+		return sts_value_from_number(script, errno == EAGAIN || errno == EWOULDBLOCK ? 1 : -1);
+
+	if(!(ret = sts_value_create(script, STS_ARRAY)))
+		return NULL;
+
+	for(i = 0; i < (unsigned int)got; ++i)
+	{
+		if(!(temp = cli_datagram_value(script, socket->batch.addresses[i].sin_addr.s_addr, ntohs(socket->batch.addresses[i].sin_port), socket->batch.pieces[i].iov_base, socket->batch.headers[i].msg_len)))
+		{
+			sts_value_reference_decrement(script, ret);
+			return NULL;
+		}
+
+		sts_array_append_insert(script, ret, temp, ret->array.length);
+	}
+	#else
+	if(socket->socket.non_blocking && cli_socket_would_block(socket) == 1)
+		return sts_value_from_number(script, 1);
+
+	if(!(ret = sts_value_create(script, STS_ARRAY)))
+		return NULL;
+
+	for(i = 0; i < max; ++i)
+	{
+		if(i && cli_socket_would_block(socket))
+			break;
+
+		if((got = zed_net_udp_socket_receive(&socket->socket, &address, socket->batch.data, CLI_UDP_DATAGRAM_SIZE)) <= 0)
+			break;
+
+		if(!(temp = cli_datagram_value(script, address.host, address.port, socket->batch.data, got)))
+		{
+			sts_value_reference_decrement(script, ret);
+			return NULL;
+		}
+
+		sts_array_append_insert(script, ret, temp, ret->array.length);
+	}
+	#endif
+
+	return ret;
+}
+
+#ifdef __linux__
+/* sends the first count batch headers of a socket. Returns how many were sent or -1 */
+long cli_socket_send_headers(cli_socket_t *socket, unsigned int count)
+{
+	long ret = 0;
+	int sent;
+
+
+	/* sendmmsg can stop early. A full buffer on a nonblocking socket ends the batch with what was sent */
+	while(ret < count)
+	{
+		if((sent = sendmmsg(socket->socket.handle, &socket->batch.headers[ret], count - ret, 0)) == -1)
+		{
+			if(errno == EINTR)
+				continue;
+			else if(!ret && errno != EAGAIN && errno != EWOULDBLOCK)
+				ret = -1;
+			break;
+		}
+
+		ret += sent;
+	}
+
+	return ret;
+}
+#endif
+
+/* sends every [address port data] array in an array, with one sendmmsg call for every CLI_UDP_BATCH_MAX of them where it exists.
+Returns how many were sent or -1 */
+long cli_socket_send_batch(sts_script_t *script, cli_socket_t *socket, sts_value_t *array)
+{
+	sts_value_t *datagram = NULL, *previous = NULL;
+	zed_net_address_t address;
+	unsigned int i;
+	long ret = 0;
+	#ifdef __linux__
+	unsigned int slot = 0;
+	long sent;
+
+
+	if(cli_socket_batch_reserve(socket, array->array.length < CLI_UDP_BATCH_MAX ? array->array.length : CLI_UDP_BATCH_MAX, 0))
+	{
+		STS_ERROR_SIMPLE("could not allocate the batch buffers of a socket");
+		return -1;
+	}
+	#endif
+
+	for(i = 0; i < array->array.length; ++i)
+	{
+		datagram = array->array.data[i];
+
+		/* batches mostly go to one place, so the address is only looked up when it changes */
+		if(!previous || previous->array.data[1]->number != datagram->array.data[1]->number || previous->array.data[0]->string.length != datagram->array.data[0]->string.length ||
+		memcmp(previous->array.data[0]->string.data, datagram->array.data[0]->string.data, datagram->array.data[0]->string.length))
+			if(zed_net_get_address(&address, datagram->array.data[0]->string.data, datagram->array.data[1]->number))
+			{
+				fprintf(stderr, "could not get the address '%s' in socket-udp-send-batch: %s\n", datagram->array.data[0]->string.data, zed_net_get_error());
+				return -1;
+			}
+		previous = datagram;
+
+		#ifdef __linux__
+		memset(&socket->batch.addresses[slot], 0, sizeof(struct sockaddr_in));
+		socket->batch.addresses[slot].sin_family = AF_INET;
+		socket->batch.addresses[slot].sin_addr.s_addr = address.host;
+		socket->batch.addresses[slot].sin_port = htons(address.port);
+
+		socket->batch.pieces[slot].iov_base = datagram->array.data[2]->string.data;
+		socket->batch.pieces[slot].iov_len = datagram->array.data[2]->string.length;
+
+		memset(&socket->batch.headers[slot], 0, sizeof(struct mmsghdr));
+		socket->batch.headers[slot].msg_hdr.msg_name = &socket->batch.addresses[slot];
+		socket->batch.headers[slot].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+		socket->batch.headers[slot].msg_hdr.msg_iov = &socket->batch.pieces[slot];
+		socket->batch.headers[slot].msg_hdr.msg_iovlen = 1;
+
+		/* the headers are reused for every CLI_UDP_BATCH_MAX datagrams */
+		if(++slot == CLI_UDP_BATCH_MAX || i + 1 == array->array.length)
+		{
+			if((sent = cli_socket_send_headers(socket, slot)) == -1)
+				return ret ? ret : -1;
+
+			ret += sent;
+			if(sent < slot)
+				break;
+
+			slot = 0;
+		}
+		#else
+		if(zed_net_udp_socket_send(&socket->socket, address, datagram->array.data[2]->string.data, datagram->array.data[2]->string.length))
+			return ret ? ret : -1;
+		++ret;
+		#endif
+	}
+
+	return ret;
+}
+#endif /* CLI_NO_SOCKETS */
+
+void debug_ast(sts_node_t *node, int level)
+{
+	int i;
+	
+	while(1)
+	{
+		for(i = 0; i < level; i++)
+		{
+			printf(" ");
+		}
+		
+		printf("%u:", node->line);
+		
+		switch(node->type)
+		{
+			case STS_NODE_EXPRESSION:
+				printf("expression:\n");
+				if(node->child)
+					debug_ast(node->child, level + 1);
+			break;
+			case STS_NODE_IDENTIFIER:
+				printf("ident: '%s'\n", node->value->string.data);
+			break;
+			case STS_NODE_VALUE:
+				if(node->value)
+				{
+					switch(node->value->type)
+					{
+						case STS_ARRAY:
+							printf("array(%u): \n", node->value->references);
+						break;
+						case STS_EXTERNAL:
+							printf("external(%u): \n", node->value->references);
+						break;
+						case STS_NUMBER:
+							printf("number(%u): %f\n", node->value->references, node->value->number);
+						break;
+						case STS_STRING:
+							printf("string(%u): '%s'\n", node->value->references, node->value->string.data);
+						break;
+					}
+				}
+				else
+					printf("null value\n");
+			break;
+		}
+		if(!(node = node->next))
+			break;
+	}
+}
+
+int equal_open_close(char *input)
+{
+	unsigned int i = 0, open = 0, close = 0, instring = 0;
+
+
+	if(!input) return 0;
+
+	for(; i < strlen(input); ++i)
+	{
+		switch(instring)
+		{
+			case 0:
+				if(input[i] == '\"')
+					instring = 1;
+				else if(input[i] == '(' || input[i] == '{' || input[i] == '[')
+					open++;
+				else if(input[i] == ')' || input[i] == '}' || input[i] == ']')
+					close++;
+			break;
+			case 1:
+				if(input[i] == '\\' && input[i] == '\"')
+					continue;
+				else if(input[i] == '\"')
+					instring = 0;
+			break;
+		}
+	}
+
+	return (open == close);
+}
+
+/* TODO: maybe dont make this recursive */
+sts_value_t *sts_value_from_json(sts_script_t *script, json_stream *json, char *json_str, unsigned long length)
+{
+	sts_value_t *ret = NULL, *temp = NULL, *temp_container = NULL;
+	json_stream new_json;
+	unsigned long i = 0, str_length = 0, init_json = 0;
+	char *str = NULL;
+	int type;
+	
+
+	/* initialize stream */
+	if(!json)
+	{
+		json_open_string(&new_json, json_str);
+		json = &new_json;
+		init_json = 1;
+	}
+
+	type = json_next(json);
+
+	switch(type)
+	{
+		case JSON_NULL:
+			if(!(ret = sts_value_create(script, STS_NIL)))
+			{
+				fprintf(stderr, "could not create nil value\n");
+				return NULL;
+			}
+
+			return ret;
+		break;
+		case JSON_TRUE:
+			if(!(ret = sts_value_from_boolean(script, 1)))
+			{
+				fprintf(stderr, "could not create true value\n");
+				return NULL;
+			}
+
+			return ret;
+		break;
+		case JSON_FALSE:
+			if(!(ret = sts_value_from_boolean(script, 0)))
+			{
+				fprintf(stderr, "could not create false value\n");
+				return NULL;
+			}
+
+			return ret;
+		break;
+		case JSON_NUMBER:
+			if(!(ret = sts_value_from_number(script, json_get_number(json))))
+			{
+				fprintf(stderr, "could not create true value\n");
+				return NULL;
+			}
+
+			return ret;
+		break;
+		case JSON_STRING:
+			str = json_get_string(json, &str_length);
+
+			/* NOTE: pdjson likes to include \0 in the string length. No idea why */
+			if(!(ret = sts_value_from_nstring(script, str, str_length - 1)))
+			{
+				fprintf(stderr, "could not create true value");
+				return NULL;
+			}
+
+			return ret;
+		break;
+		case JSON_ARRAY:
+			if(!(ret = sts_value_create(script, STS_ARRAY)))
+			{
+				fprintf(stderr, "could not create array value\n");
+				return NULL;
+			}
+
+			while((type = json_peek(json)) != JSON_DONE && type != JSON_ERROR && type != JSON_ARRAY_END)
+			{
+				if(!(temp = sts_value_from_json(script, json, json_str, length)))
+				{
+					fprintf(stderr, "could not add member to array\n");
+					sts_value_reference_decrement(script, ret);
+					return NULL;
+				}
+
+				STS_ARRAY_APPEND_INSERT(ret, temp, i);
+				++i;
+			}
+
+			json_next(json);
+		break;
+		case JSON_OBJECT:
+			if(!(ret = sts_value_create(script, STS_ARRAY)))
+			{
+				fprintf(stderr, "could not create hashmap array value\n");
+				return NULL;
+			}
+
+			while((type = json_peek(json)) != JSON_DONE && type != JSON_ERROR && type != JSON_OBJECT_END)
+			{
+				/* create the key */
+
+				/* NOTE: this would be more compact but gcc has really weird behavior. Works perfectly fine on clang */
+				str = json_get_string(json, &str_length);
+				str = sts_memdup(str, str_length);
+
+				json_next(json);
+
+				if(!(temp = sts_value_from_json(script, json, json_str, length)))
+				{
+					fprintf(stderr, "could not add member to object\n");
+					sts_value_reference_decrement(script, ret);
+					free(str);
+					return NULL;
+				}
+
+				if(sts_hashmap_set(script, ret, str, str_length - 1, temp))
+				{
+					fprintf(stderr, "could not add '%.*s' to hashmap\n", (int)str_length - 1, str);
+					sts_value_reference_decrement(script, ret);
+					free(str);
+					return NULL;
+				}
+
+				free(str);
+			}
+
+			json_next(json);
+		break;
+		case JSON_ERROR:
+			fprintf(stderr, "json parse error on line %ld: '%s'\n", json_get_lineno(json), json_get_error(json));
+			return NULL;
+		break;
+	}
+
+	if(init_json)
+		json_close(json);
+
+
+	return ret;
+}
+
+int sts_hashmap_verify(sts_script_t *script, sts_value_t *value)
+{
+	unsigned long i;
+
+	/* hashmaps are only a concept of the stdlib itself so we can only guess if its actually a hashmap */
+	if(value->type == STS_ARRAY && 
+		value->array.length && 
+		value->array.data[0]->type == STS_ARRAY && 
+		value->array.data[0]->array.length == 3
+	)
+	{
+		for(i = 0; i < value->array.length; ++i)
+		{
+			/* verify first hash number, then key string, and that every row has 3 values */
+
+			if(value->array.data[i]->type != STS_ARRAY || 
+				value->array.data[i]->array.length != 3 ||
+				value->array.data[i]->array.data[0]->type != STS_NUMBER ||
+				value->array.data[i]->array.data[1]->type != STS_STRING
+			)
+			{
+				return 0;
+			}
+
+			/* TODO: determine if its worth it to hash every string and see if the number is true */
+		}
+
+		return 1;
+	}
+
+	return 0;
+}
+
+/* control simple tiny script */
+
+int repl(sts_script_t *script)
+{
+	int quit = 0, blank = 1;
+	size_t size = 0;
+	unsigned int offset = 0, line = 0;
+	sts_value_t *ret = NULL;
+	sts_node_t *temp_node = NULL, *current_node = NULL;
+	char *current_buffer = NULL, *temp_buffer = NULL;
+	/* know if ready to parse by making sure '['s and ']'s are even */
+
+	while(!quit)
+	{
+		printf("%s ", PS1);
+		while(!equal_open_close(current_buffer) || current_buffer[strlen(current_buffer) - 2] == '\\')
+		{
+			if(current_buffer)
+				printf("> ");
+			
+			getline(&temp_buffer, &size, stdin);
+
+			if(!strcmp(temp_buffer, "exit\n")) /* exit isnt a real action but it needs to clean up in a simple way so this works */
+			{
+				free(temp_buffer);
+				free(current_buffer);
+				cli_coroutine_finish(script);
+				if(!sts_destroy(script))
+					fprintf(stderr, "problem cleaning up script");
+				return 0;
+			}
+
+			current_buffer = realloc(current_buffer, (current_buffer ? strlen(current_buffer) : 0) + strlen(temp_buffer) + 1); /* honestly, this is a really simple and hacky repl. At this point, it really doesn't matter in this part if we check for realloc errors */
+			if(blank)
+			{
+				current_buffer[0] = 0x0;
+				blank = 0;
+			}
+			strcat(current_buffer, temp_buffer);
+
+			free(temp_buffer);
+			temp_buffer = NULL;
+		}
+		
+		/* parse and eval */
+
+		if(!(current_node = sts_parse(script, NULL, current_buffer, "repl.sts", &offset, &line)))
+		{
+			fprintf(stderr, "parser error\n");
+		}
+
+
+		/* eval */
+		ret = sts_eval(script, current_node, NULL, NULL, 0, 0);
+		if(ret && !sts_value_reference_decrement(script, ret)) fprintf(stderr, "could not clean up returned value\n");
+		else if(!ret) fprintf(stderr, "command error\n");
+		sts_output_flush(script);
+
+		sts_ast_delete(script, current_node);
+		free(current_buffer);
+		current_buffer = NULL;
+		blank = 1;
+		offset = line = 0;
+	}
+
+	/* cleanup */
+
+	cli_coroutine_finish(script);
+	if(!sts_destroy(script))
+		fprintf(stderr, "problem cleaning up script");
+	
+	return 0;
+}
+
+char *read_file(sts_script_t *script, char *file, unsigned int *size)
+{
+	FILE *script_file = NULL;
+	char *ret = NULL;
+
+
+	if(!(script_file = fopen(file, "r")))
+	{
+		return NULL;
+	}
+	
+	fseek(script_file, 0, SEEK_END);
+	*size = ftell(script_file);
+	fseek(script_file, 0, SEEK_SET);
+	
+	if(!(ret = calloc((*size) + 1, sizeof(char))))
+	{
+		fprintf(stderr, "could not calloc script text buffer\n");
+		fclose(script_file);
+		return NULL;
+	}
+	
+	if((*size) && fread(ret, (*size), sizeof(char), script_file) <= 0)
+	{
+		fprintf(stderr, "could not read script file\n");
+		free(ret);
+		fclose(script_file);
+		return NULL;
+	}
+	
+	fclose(script_file);
+
+
+	return ret;
+}
+
+#ifndef CLI_WINDOWS
+/* sits in the page in front of a file mapping */
+typedef struct
+{
+	unsigned long references, size; /* size is of the whole mapping, this page included */
+} cli_mapping_t;
+
+#define CLI_MAPPING(data) ((cli_mapping_t *)((data) - sysconf(_SC_PAGESIZE)))
+#endif
+
+/* maps a whole file read only. The mapping is a byte longer than the file and that byte is always 0, so it can be used as a string.
+Returns NULL for empty files and anything that can't be mapped, like pipes. Truncating the file while it is mapped crashes the process
+with SIGBUS once the missing pages are touched */
+char *cli_map_file(char *file, unsigned int *size)
+{
+	#ifdef CLI_WINDOWS
+	return NULL;
+	#else
+	struct stat info;
+	char *ret = NULL;
+	long page = sysconf(_SC_PAGESIZE);
+	unsigned long whole;
+	int fd;
+
+
+	if((fd = open(file, O_RDONLY | O_CLOEXEC)) == -1)
+		return NULL;
+
+	if(fstat(fd, &info) || !S_ISREG(info.st_mode) || !info.st_size || (unsigned long)info.st_size >= UINT_MAX)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	/* zeroed pages are reserved first for the header in front and so the extra byte exists even when the file ends on a page boundary */
+	if((ret = mmap(NULL, page + info.st_size + 1, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	/* only whole pages are mapped. The partial page at the end is copied, since the 0 after the file would be in it and
+	anything appended to the file would show up there */
+	whole = info.st_size - info.st_size % page;
+
+	if((whole && mmap(ret + page, whole, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) ||
+	(whole != (unsigned long)info.st_size && pread(fd, ret + page + whole, info.st_size - whole, whole) != (ssize_t)(info.st_size - whole)))
+	{
+		munmap(ret, page + info.st_size + 1);
+		close(fd);
+		return NULL;
+	}
+
+	close(fd);
+
+	((cli_mapping_t *)ret)->references = 1;
+	((cli_mapping_t *)ret)->size = page + info.st_size + 1;
+	ret += page;
+
+	#ifdef MADV_SEQUENTIAL
+	madvise(ret, info.st_size, MADV_SEQUENTIAL);
+	#endif
+
+	*size = info.st_size;
+
+	return ret;
+	#endif
+}
+
+/* copies of a mapped string share the mapping */
+char *cli_map_share(char *data)
+{
+	#ifndef CLI_WINDOWS
+	CLI_MAPPING(data)->references++;
+	#endif
+
+	return data;
+}
+
+void cli_map_release(char *data)
+{
+	#ifndef CLI_WINDOWS
+	cli_mapping_t *mapping = CLI_MAPPING(data);
+
+
+	if(!--mapping->references)
+		munmap(mapping, mapping->size);
+	#endif
+}
+
+/* wraps an open fd in a file handle. Borrowed fds are never closed */
+cli_file_t *cli_file_new(int fd, char borrowed)
+{
+	cli_file_t *ret = NULL;
+	struct stat info;
+
+
+	if(!(ret = calloc(1, sizeof(cli_file_t))))
+		return NULL;
+
+	ret->references = 1;
+	ret->fd = fd;
+	ret->borrowed = borrowed;
+	ret->pollable = fstat(fd, &info) || !S_ISREG(info.st_mode);
+
+	return ret;
+}
+
+sts_value_t *cli_file_value(sts_script_t *script, cli_file_t *file)
+{
+	sts_value_t *ret = NULL;
+
+
+	if(!(ret = sts_value_create(script, STS_EXTERNAL)))
+	{
+		STS_ERROR_SIMPLE("could not create file external value");
+		return NULL;
+	}
+
+	ret->external.refdec = &cli_file_refdec;
+	ret->external.refinc = &cli_file_refinc;
+	ret->external.data_ptr = file;
+
+	return ret;
+}
+
+/* reads as much as fits into the buffer of a file. Returns the amount read, 0 at the end, or -1 */
+long cli_file_fill(sts_script_t *script, cli_file_t *file)
+{
+	char *temp = NULL;
+	long ret;
+
+
+	if(!file->buffer.data)
+	{
+		if(!(file->buffer.data = malloc(CLI_FILE_BUFFER_SIZE)))
+		{
+			STS_ERROR_SIMPLE("could not allocate file buffer");
+			return -1;
+		}
+
+		file->buffer.size = CLI_FILE_BUFFER_SIZE;
+	}
+
+	/* keep what is buffered in one piece so it can be scanned in one go */
+	if(file->buffer.start == file->buffer.end)
+		file->buffer.start = file->buffer.end = 0;
+	else if(file->buffer.end == file->buffer.size && file->buffer.start)
+	{
+		memmove(file->buffer.data, &file->buffer.data[file->buffer.start], file->buffer.end - file->buffer.start);
+		file->buffer.end -= file->buffer.start;
+		file->buffer.start = 0;
+	}
+
+	if(file->buffer.end == file->buffer.size)
+	{
+		if(!(temp = realloc(file->buffer.data, file->buffer.size * 2)))
+		{
+			STS_ERROR_SIMPLE("could not resize file buffer");
+			return -1;
+		}
+
+		file->buffer.data = temp;
+		file->buffer.size *= 2;
+	}
+
+	if(file->pollable)
+		cli_coroutine_wait_fd(script, file->fd, POLLIN);
+
+	while((ret = read(file->fd, &file->buffer.data[file->buffer.end], file->buffer.size - file->buffer.end)) == -1 && errno == EINTR);
+
+	if(ret > 0)
+		file->buffer.end += ret;
+
+	return ret;
+}
+
+/* returns the next line without the newline or \r\n, or nil once there is nothing left */
+sts_value_t *cli_file_read_line(sts_script_t *script, cli_file_t *file)
+{
+	sts_value_t *ret = NULL;
+	unsigned long scanned = 0, found, length;
+	char *match = NULL;
+
+
+	while(file->fd != -1)
+	{
+		/* only what was read since the last scan is searched again */
+		if(file->buffer.end - file->buffer.start > scanned && (match = memchr(&file->buffer.data[file->buffer.start + scanned], '\n', file->buffer.end - file->buffer.start - scanned)))
+			break;
+
+		scanned = file->buffer.end - file->buffer.start;
+
+		if(cli_file_fill(script, file) <= 0)
+			break;
+	}
+
+	if(file->buffer.end == file->buffer.start)
+	{
+		if(!(ret = sts_value_create(script, STS_NIL)))
+			STS_ERROR_SIMPLE("could not create nil for a file read");
+		return ret;
+	}
+
+	/* the last line doesn't need a newline */
+	found = match ? (unsigned long)(match - &file->buffer.data[file->buffer.start]) : file->buffer.end - file->buffer.start;
+	length = found;
+	if(length && file->buffer.data[file->buffer.start + length - 1] == '\r')
+		--length;
+
+	if(!(ret = sts_value_from_nstring(script, &file->buffer.data[file->buffer.start], length)))
+		STS_ERROR_SIMPLE("could not create string for a file read");
+
+	file->buffer.start += found + (match ? 1 : 0);
+
+	return ret;
+}
+
+/* returns everything up to the first delim, which is consumed but not returned, or the next length bytes if delim is 0.
+A length of 0 reads to the end. What is left at the end is returned even if it is short */
+sts_value_t *cli_file_read_until(sts_script_t *script, cli_file_t *file, unsigned long length, char delim)
+{
+	sts_value_t *ret = NULL;
+	unsigned long scanned = 0, found, skip = 0;
+	char *match = NULL;
+
+
+	while(file->fd != -1)
+	{
+		if(delim)
+		{
+			if(file->buffer.end - file->buffer.start > scanned && (match = memchr(&file->buffer.data[file->buffer.start + scanned], delim, file->buffer.end - file->buffer.start - scanned)))
+				break;
+
+			scanned = file->buffer.end - file->buffer.start;
+		}
+		else if(length && file->buffer.end - file->buffer.start >= length)
+			break;
+
+		if(cli_file_fill(script, file) <= 0)
+			break;
+	}
+
+	if(match)
+	{
+		found = match - &file->buffer.data[file->buffer.start];
+		skip = 1;
+	}
+	else if(!delim && length && file->buffer.end - file->buffer.start > length)
+		found = length;
+	else
+		found = file->buffer.end - file->buffer.start;
+
+	if(!(ret = sts_value_from_nstring(script, found ? &file->buffer.data[file->buffer.start] : "", found)))
+		STS_ERROR_SIMPLE("could not create string for a file read");
+
+	file->buffer.start += found + skip;
+
+	return ret;
+}
+
+/* opens a file for a file-writer. A size of 0 writes everything straight through */
+sts_value_t *cli_writer_new(sts_script_t *script, char *path, int append, unsigned long size)
+{
+	sts_value_t *ret = NULL;
+	cli_writer_t *writer = NULL;
+
+
+	if(!(writer = calloc(1, sizeof(cli_writer_t))))
+		return NULL;
+
+	writer->references = 1;
+
+	if(size && !(writer->buffer.data = malloc(size)))
+	{
+		free(writer);
+		return NULL;
+	}
+	writer->buffer.size = size;
+
+	if((writer->fd = open(path, O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC), 0666)) == -1)
+	{
+		cli_writer_release(writer);
+		return sts_value_create(script, STS_NIL);
+	}
+
+	if(!(ret = sts_value_create(script, STS_EXTERNAL)))
+	{
+		cli_writer_release(writer);
+		return NULL;
+	}
+
+	ret->external.refdec = &cli_writer_refdec;
+	ret->external.refinc = &cli_writer_refinc;
+	ret->external.data_ptr = writer;
+
+	return ret;
+}
+
+/* buffers data, flushing first if it doesn't fit. Anything as big as the buffer skips it. Returns the length or -1 */
+long cli_writer_write(cli_writer_t *writer, char *data, unsigned long length)
+{
+	if(writer->fd == -1)
+		return -1;
+
+	if(writer->buffer.length + length > writer->buffer.size && cli_writer_flush(writer))
+		return -1;
+
+	if(length >= writer->buffer.size)
+		return cli_writer_write_fd(writer, data, length) ? -1 : (long)length;
+
+	memcpy(&writer->buffer.data[writer->buffer.length], data, length);
+	writer->buffer.length += length;
+
+	return length;
+}
+
+#ifndef CLI_NO_PROCESSES
+/* turns an array into a NULL terminated argv. Numbers and booleans are written out like pipeout does. Returns NULL on failure */
+char **cli_process_argv(sts_value_t *array)
+{
+	char **ret = NULL, buf[64];
+	unsigned int i;
+
+
+	if(array->type != STS_ARRAY || !array->array.length || !(ret = calloc(array->array.length + 1, sizeof(char *))))
+		return NULL;
+
+	for(i = 0; i < array->array.length; ++i)
+	{
+		switch(array->array.data[i]->type)
+		{
+			case STS_STRING: ret[i] = strdup(array->array.data[i]->string.data); break;
+			case STS_NUMBER: snprintf(buf, sizeof(buf), "%1.17g", array->array.data[i]->number); ret[i] = strdup(buf); break;
+			case STS_BOOLEAN: ret[i] = strdup(array->array.data[i]->boolean ? "true" : "false"); break;
+			default: break;
+		}
+
+		if(!ret[i])
+		{
+			while(i) free(ret[--i]);
+			free(ret);
+			return NULL;
+		}
+	}
+
+	return ret;
+}
+
+void cli_process_argv_free(char **argv)
+{
+	unsigned int i;
+
+
+	for(i = 0; argv[i]; ++i)
+		free(argv[i]);
+	free(argv);
+}
+
+int cli_process_pipe(int fds[2])
+{
+	if(pipe(fds))
+		return -1;
+
+	/* only the duplicates made for the child should survive its exec */
+	fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+	return 0;
+}
+
+/* starts argv[0] from the PATH without a shell, with its stdout and stderr going to new pipes. When quiet is set
+its stdin is /dev/null so children running side by side don't fight over the terminal. Returns 0 or an errno value */
+int cli_process_start(char **argv, int quiet, pid_t *pid, int *out, int *err)
+{
+	posix_spawn_file_actions_t actions;
+	int out_pipe[2], err_pipe[2], ret;
+
+
+	if(cli_process_pipe(out_pipe))
+		return errno;
+
+	if(cli_process_pipe(err_pipe))
+	{
+		ret = errno;
+		close(out_pipe[0]);
+		close(out_pipe[1]);
+		return ret;
+	}
+
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, out_pipe[1], 1);
+	posix_spawn_file_actions_adddup2(&actions, err_pipe[1], 2);
+	if(quiet)
+		posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0);
+
+	ret = posix_spawnp(pid, argv[0], &actions, NULL, argv, environ);
+
+	posix_spawn_file_actions_destroy(&actions);
+	close(out_pipe[1]);
+	close(err_pipe[1]);
+
+	if(ret)
+	{
+		close(out_pipe[0]);
+		close(err_pipe[0]);
+		return ret;
+	}
+
+	*out = out_pipe[0];
+	*err = err_pipe[0];
+
+	return 0;
+}
+
+/* what a shell would say $? is */
+int cli_process_exit_code(int status)
+{
+	if(WIFEXITED(status))
+		return WEXITSTATUS(status);
+	if(WIFSIGNALED(status))
+		return 128 + WTERMSIG(status);
+
+	return -1;
+}
+
+/* returns a process external, nil if the command couldn't be started, or NULL */
+sts_value_t *cli_process_spawn(sts_script_t *script, char **argv)
+{
+	sts_value_t *ret = NULL;
+	cli_process_t *process = NULL;
+	int out, err, error;
+
+
+	if(!(process = calloc(1, sizeof(cli_process_t))))
+		return NULL;
+
+	if((error = cli_process_start(argv, 0, &process->pid, &out, &err)))
+	{
+		fprintf(stderr, "could not start %s: %s\n", argv[0], strerror(error));
+		free(process);
+		return sts_value_create(script, STS_NIL);
+	}
+
+	process->references = 1;
+	if(!(process->out = cli_file_new(out, 0)) || !(process->err = cli_file_new(err, 0)) || !(ret = sts_value_create(script, STS_EXTERNAL)))
+	{
+		if(process->out) cli_file_release(process->out);
+		else close(out);
+		if(process->err) cli_file_release(process->err);
+		else close(err);
+		waitpid(process->pid, NULL, 0);
+		free(process);
+		return NULL;
+	}
+
+	ret->external.refdec = &cli_process_refdec;
+	ret->external.refinc = &cli_process_refinc;
+	ret->external.data_ptr = process;
+
+	return ret;
+}
+
+/* blocks until the child exits. Its output should be read first, since a child that fills a pipe nobody reads never exits */
+int cli_process_wait(cli_process_t *process)
+{
+	int status;
+
+
+	if(!process->waited)
+	{
+		while(waitpid(process->pid, &status, 0) == -1)
+			if(errno != EINTR)
+			{
+				status = -1;
+				break;
+			}
+
+		process->status = status == -1 ? -1 : cli_process_exit_code(status);
+		process->waited = 1;
+	}
+
+	return process->status;
+}
+
+/* runs every argv array in commands with at most max running at once, collecting their output with poll as it comes.
+Returns an array of [exit_code stdout stderr] arrays in the same order as commands, or NULL */
+sts_value_t *cli_process_run_parallel(sts_script_t *script, sts_value_t *commands, unsigned int max)
+{
+	typedef struct
+	{
+		pid_t pid;
+		int fds[2], status; /* fds are -1 once that stream ends */
+		struct
+		{
+			char *data;
+			unsigned long length, allocated;
+		} output[2];
+	} cli_job_t;
+
+	sts_value_t *ret = NULL, *temp = NULL, *result = NULL;
+	cli_job_t *jobs = NULL, *job = NULL;
+	struct pollfd *polls = NULL;
+	unsigned int *owners = NULL, count = commands->array.length, next = 0, running = 0, finished = 0, polled, i, j;
+	char **argv = NULL, *data = NULL;
+	long got;
+	int error, status;
+	#if defined(__linux__) && !defined(CLI_NO_COROUTINES)
+	struct epoll_event event;
+	int pipes = -1; /* every open pipe, so the scheduler can wait on all of them as one fd */
+	#endif
+
+
+	if(!max)
+		max = 1;
+	if(max > count)
+		max = count;
+
+	if(!(jobs = calloc(count ? count : 1, sizeof(cli_job_t))) || !(polls = calloc(max * 2 + 1, sizeof(struct pollfd))) || !(owners = calloc(max * 2 + 1, sizeof(unsigned int))))
+		goto error;
+
+	#if defined(__linux__) && !defined(CLI_NO_COROUTINES)
+	if((pipes = epoll_create1(EPOLL_CLOEXEC)) == -1)
+		goto error;
+	#endif
+
+	while(finished < count)
+	{
+		for(; running < max && next < count; ++next)
+		{
+			job = &jobs[next];
+			job->fds[0] = job->fds[1] = -1;
+
+			if(!(argv = cli_process_argv(commands->array.data[next])))
+				error = EINVAL;
+			else
+			{
+				error = cli_process_start(argv, 1, &job->pid, &job->fds[0], &job->fds[1]);
+				cli_process_argv_free(argv);
+			}
+
+			if(error)
+			{
+				/* reported the way a shell reports a command it can't run */
+				job->status = 127;
+				if((job->output[1].data = malloc(256)))
+					job->output[1].length = snprintf(job->output[1].data, 256, "could not start command %u: %s\n", next, strerror(error));
+				finished++;
+			}
+			else
+			{
+				running++;
+
+				#if defined(__linux__) && !defined(CLI_NO_COROUTINES)
+				/* closing a pipe takes it out of the set again */
+				for(j = 0; j < 2; ++j)
+				{
+					event.events = EPOLLIN;
+					event.data.u32 = next * 2 + j;
+					if(epoll_ctl(pipes, EPOLL_CTL_ADD, job->fds[j], &event) == -1)
+						goto error;
+				}
+				#endif
+			}
+		}
+
+		for(i = 0, polled = 0; i < next; ++i)
+			for(j = 0; j < 2; ++j)
+				if(jobs[i].fds[j] != -1)
+				{
+					polls[polled].fd = jobs[i].fds[j];
+					polls[polled].events = POLLIN;
+					polls[polled].revents = 0;
+					owners[polled++] = i * 2 + j;
+				}
+
+		if(!polled)
+			continue;
+
+		/* other coroutines and timers run until one of the pipes has something. Elsewhere this blocks them */
+		#if defined(__linux__) && !defined(CLI_NO_COROUTINES)
+		cli_coroutine_wait_fd(script, pipes, POLLIN);
+		#endif
+
+		if(poll(polls, polled, -1) == -1)
+		{
+			if(errno == EINTR)
+				continue;
+			goto error;
+		}
+
+		for(i = 0; i < polled; ++i)
+		{
+			if(!polls[i].revents)
+				continue;
+
+			job = &jobs[owners[i] / 2];
+			j = owners[i] % 2;
+
+			if(job->output[j].allocated - job->output[j].length < CLI_PROCESS_READ_SIZE + 1)
+			{
+				if(!(data = realloc(job->output[j].data, job->output[j].allocated + CLI_PROCESS_READ_SIZE + 1)))
+					goto error;
+				job->output[j].data = data;
+				job->output[j].allocated += CLI_PROCESS_READ_SIZE + 1;
+			}
+
+			while((got = read(job->fds[j], &job->output[j].data[job->output[j].length], CLI_PROCESS_READ_SIZE)) == -1 && errno == EINTR);
+
+			if(got > 0)
+			{
+				job->output[j].length += got;
+				continue;
+			}
+
+			close(job->fds[j]);
+			job->fds[j] = -1;
+
+			if(job->fds[0] == -1 && job->fds[1] == -1)
+			{
+				while((error = waitpid(job->pid, &status, 0)) == -1 && errno == EINTR);
+				job->status = error == -1 ? -1 : cli_process_exit_code(status);
+				running--;
+				finished++;
+			}
+		}
+	}
+
+	if(!(ret = sts_value_create(script, STS_ARRAY)))
+		goto error;
+
+	for(i = 0; i < count; ++i)
+	{
+		if(!(result = sts_value_create(script, STS_ARRAY)))
+			goto error;
+		sts_array_append_insert(script, ret, result, ret->array.length);
+
+		if(!(temp = sts_value_from_number(script, jobs[i].status)))
+			goto error;
+		sts_array_append_insert(script, result, temp, result->array.length);
+
+		for(j = 0; j < 2; ++j)
+		{
+			if(!(temp = sts_value_from_nstring(script, jobs[i].output[j].data ? jobs[i].output[j].data : "", jobs[i].output[j].length)))
+				goto error;
+			sts_array_append_insert(script, result, temp, result->array.length);
+		}
+	}
+
+	goto cleanup;
+
+	error:
+	if(ret) sts_value_reference_decrement(script, ret);
+	ret = NULL;
+
+	cleanup:
+	if(jobs)
+	{
+		for(i = 0; i < next; ++i)
+		{
+			/* only left running when something failed part way */
+			running = jobs[i].fds[0] != -1 || jobs[i].fds[1] != -1;
+
+			for(j = 0; j < 2; ++j)
+			{
+				if(jobs[i].fds[j] != -1) close(jobs[i].fds[j]);
+				if(jobs[i].output[j].data) free(jobs[i].output[j].data);
+			}
+
+			if(running)
+				waitpid(jobs[i].pid, NULL, 0);
+		}
+		free(jobs);
+	}
+	if(polls) free(polls);
+	if(owners) free(owners);
+	#if defined(__linux__) && !defined(CLI_NO_COROUTINES)
+	if(pipes != -1) close(pipes);
+	#endif
+
+	return ret;
+}
+#endif
+
+#ifndef CLI_NO_DIRECTORY_WALK
+/* directory-walk reads every directory as its own job on the thread pool. Jobs only build plain entries and the
+array is made from them once every job is done, since values can only be created on the interpreter thread */
+typedef struct
+{
+	char *path;
+	unsigned long length;
+	const char *type;
+	double size, mtime;
+} cli_walk_entry_t;
+
+typedef struct cli_walk_directory_t
+{
+	struct cli_walk_directory_t *next; /* the stack directories wait in when there is no pool */
+	struct cli_walk_t *walk;
+	char *path;
+	unsigned long length;
+	int depth;
+} cli_walk_directory_t;
+
+typedef struct cli_walk_t
+{
+	#ifndef CLI_NO_THREADS
+	sts_pool_t *pool;
+	pthread_mutex_t lock;
+	pthread_cond_t done;
+	#endif
+	unsigned long pending; /* directories queued or being read */
+	cli_walk_directory_t *stack;
+	int max_depth; /* -1 for no limit */
+	char *glob;
+	struct
+	{
+		cli_walk_entry_t *data;
+		unsigned long length, allocated;
+	} entries;
+	char failed; /* 1 if something couldn't be allocated and 2 if the starting directory couldn't be read */
+} cli_walk_t;
+
+void cli_walk_directory(cli_walk_directory_t *directory);
+
+#ifndef CLI_NO_THREADS
+void cli_walk_job(sts_pool_worker_t *worker, void *data)
+{
+	cli_walk_directory(data);
+}
+#endif
+
+/* queues path to be read. Takes ownership of path */
+int cli_walk_queue(cli_walk_t *walk, char *path, unsigned long length, int depth)
+{
+	cli_walk_directory_t *directory = NULL;
+
+
+	if(!(directory = malloc(sizeof(cli_walk_directory_t))))
+	{
+		free(path);
+		return -1;
+	}
+
+	directory->walk = walk;
+	directory->path = path;
+	directory->length = length;
+	directory->depth = depth;
+
+	#ifndef CLI_NO_THREADS
+	if(walk->pool)
+	{
+		pthread_mutex_lock(&walk->lock);
+		walk->pending++;
+		pthread_mutex_unlock(&walk->lock);
+
+		if(sts_pool_submit(walk->pool, &cli_walk_job, directory))
+			return 0;
+
+		pthread_mutex_lock(&walk->lock);
+		walk->pending--;
+		pthread_mutex_unlock(&walk->lock);
+
+		free(path);
+		free(directory);
+		return -1;
+	}
+	#endif
+
+	directory->next = walk->stack;
+	walk->stack = directory;
+
+	return 0;
+}
+
+/* adds the entries a job found to the walk in one go, so the lock is only taken once per directory */
+void cli_walk_finish(cli_walk_t *walk, cli_walk_entry_t *entries, unsigned long length, int failed)
+{
+	cli_walk_entry_t *temp = NULL;
+	unsigned long i;
+
+
+	#ifndef CLI_NO_THREADS
+	if(walk->pool)
+		pthread_mutex_lock(&walk->lock);
+	#endif
+
+	if(walk->entries.length + length > walk->entries.allocated)
+	{
+		if((temp = realloc(walk->entries.data, sizeof(cli_walk_entry_t) * (walk->entries.length + length) * 2)))
+		{
+			walk->entries.data = temp;
+			walk->entries.allocated = (walk->entries.length + length) * 2;
+		}
+		else
+			failed = 1;
+	}
+
+	if(length && walk->entries.length + length <= walk->entries.allocated)
+	{
+		memcpy(&walk->entries.data[walk->entries.length], entries, sizeof(cli_walk_entry_t) * length);
+		walk->entries.length += length;
+	}
+	else
+		for(i = 0; i < length; ++i)
+			free(entries[i].path);
+
+	if(failed > walk->failed)
+		walk->failed = failed;
+
+	#ifndef CLI_NO_THREADS
+	if(walk->pool)
+	{
+		if(!--walk->pending)
+			pthread_cond_signal(&walk->done);
+		pthread_mutex_unlock(&walk->lock);
+	}
+	#endif
+}
+
+/* reads one directory. Entries are stat'ed relative to it so the kernel doesn't walk the whole path again for each one.
+Symbolic links are listed but never followed, so loops can't happen */
+void cli_walk_directory(cli_walk_directory_t *directory)
+{
+	cli_walk_t *walk = directory->walk;
+	cli_walk_entry_t *entries = NULL, *temp = NULL;
+	unsigned long length = 0, allocated = 0, name_length;
+	struct dirent *entry = NULL;
+	struct stat info;
+	char *path = NULL, *queued = NULL;
+	DIR *d = NULL;
+	int fd, failed = 0, descend, matches;
+
+
+	if((fd = openat(AT_FDCWD, directory->path, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) == -1 || !(d = fdopendir(fd)))
+	{
+		if(fd != -1) close(fd);
+		/* unreadable directories further down are skipped. Only the starting one not opening makes the walk give nil */
+		cli_walk_finish(walk, NULL, 0, directory->depth ? 0 : 2);
+		free(directory->path);
+		free(directory);
+		return;
+	}
+
+	while((entry = readdir(d)))
+	{
+		if(entry->d_name[0] == '.' && (!entry->d_name[1] || (entry->d_name[1] == '.' && !entry->d_name[2])))
+			continue;
+
+		if(fstatat(fd, entry->d_name, &info, AT_SYMLINK_NOFOLLOW))
+			continue;
+
+		descend = S_ISDIR(info.st_mode) && (walk->max_depth < 0 || directory->depth + 1 < walk->max_depth);
+		matches = !walk->glob || !fnmatch(walk->glob, entry->d_name, 0);
+
+		/* directories are gone into even when the glob only matches things inside of them */
+		if(!matches && !descend)
+			continue;
+
+		name_length = strlen(entry->d_name);
+
+		if(!(path = malloc(directory->length + 1 + name_length + 1)))
+		{
+			failed = 1;
+			break;
+		}
+
+		memcpy(path, directory->path, directory->length);
+		path[directory->length] = '/';
+		memcpy(&path[directory->length + 1], entry->d_name, name_length + 1);
+
+		if(descend)
+		{
+			if(!(queued = matches ? strdup(path) : path))
+			{
+				free(path);
+				failed = 1;
+				break;
+			}
+
+			if(cli_walk_queue(walk, queued, directory->length + 1 + name_length, directory->depth + 1))
+				failed = 1;
+
+			if(!matches) /* the queue has the path now */
+				continue;
+		}
+
+		if(length == allocated)
+		{
+			if(!(temp = realloc(entries, sizeof(cli_walk_entry_t) * (allocated ? allocated * 2 : 64))))
+			{
+				free(path);
+				failed = 1;
+				break;
+			}
+
+			entries = temp;
+			allocated = allocated ? allocated * 2 : 64;
+		}
+
+		entries[length].path = path;
+		entries[length].length = directory->length + 1 + name_length;
+		entries[length].type = S_ISREG(info.st_mode) ? "file" : S_ISDIR(info.st_mode) ? "directory" : S_ISLNK(info.st_mode) ? "link" : "other";
+		entries[length].size = info.st_size;
+		#ifdef __linux__
+		entries[length].mtime = (double)info.st_mtim.tv_sec + (double)info.st_mtim.tv_nsec / 1000000000.0;
+		#else
+		entries[length].mtime = info.st_mtime;
+		#endif
+		length++;
+	}
+
+	closedir(d);
+
+	cli_walk_finish(walk, entries, length, failed);
+
+	if(entries) free(entries);
+	free(directory->path);
+	free(directory);
+}
+
+/* returns an array of [path type size mtime] for everything under path in no particular order, or nil if path can't be read.
+A max_depth of 1 only lists path itself and -1 has no limit. glob is matched against the names of entries */
+sts_value_t *cli_walk(sts_script_t *script, char *path, unsigned long length, int max_depth, char *glob)
+{
+	cli_walk_t walk;
+	cli_walk_directory_t *directory = NULL;
+	sts_value_t *ret = NULL, *record = NULL, *temp = NULL;
+	unsigned long i = 0;
+	char *root = NULL;
+
+
+	memset(&walk, 0, sizeof(cli_walk_t));
+	walk.max_depth = max_depth;
+	walk.glob = glob;
+
+	/* a trailing slash would double up in every path */
+	while(length > 1 && path[length - 1] == '/')
+		length--;
+
+	if(!(root = malloc(length + 1)))
+		return NULL;
+
+	memcpy(root, path, length);
+	root[length] = 0;
+
+	#ifndef CLI_NO_THREADS
+	if(CLI_STATE(script) && (CLI_STATE(script)->pool || (CLI_STATE(script)->pool = sts_pool_create(script, 0))))
+	{
+		walk.pool = CLI_STATE(script)->pool;
+		pthread_mutex_init(&walk.lock, NULL);
+		pthread_cond_init(&walk.done, NULL);
+	}
+	#endif
+
+	if(cli_walk_queue(&walk, root, length, 0))
+		walk.failed = 1;
+
+	#ifndef CLI_NO_THREADS
+	if(walk.pool)
+	{
+		pthread_mutex_lock(&walk.lock);
+		while(walk.pending)
+			pthread_cond_wait(&walk.done, &walk.lock);
+		pthread_mutex_unlock(&walk.lock);
+
+		pthread_cond_destroy(&walk.done);
+		pthread_mutex_destroy(&walk.lock);
+	}
+	#endif
+
+	/* without a pool the directories are read here instead */
+	while((directory = walk.stack))
+	{
+		walk.stack = directory->next;
+		cli_walk_directory(directory);
+	}
+
+	if(walk.failed == 2)
+		ret = sts_value_create(script, STS_NIL);
+	else if(!walk.failed && (ret = sts_value_create(script, STS_ARRAY)))
+		for(i = 0; i < walk.entries.length; ++i)
+		{
+			if(!(record = sts_value_create(script, STS_ARRAY)))
+				break;
+			sts_array_append_insert(script, ret, record, ret->array.length);
+
+			/* the path is handed over instead of copied */
+			if(!(temp = sts_value_create(script, STS_STRING)))
+				break;
+			temp->string.data = walk.entries.data[i].path;
+			temp->string.length = walk.entries.data[i].length;
+			walk.entries.data[i].path = NULL;
+			sts_array_append_insert(script, record, temp, record->array.length);
+
+			if(!(temp = sts_value_from_string(script, (char *)walk.entries.data[i].type)))
+				break;
+			sts_array_append_insert(script, record, temp, record->array.length);
+
+			if(!(temp = sts_value_from_number(script, walk.entries.data[i].size)))
+				break;
+			sts_array_append_insert(script, record, temp, record->array.length);
+
+			if(!(temp = sts_value_from_number(script, walk.entries.data[i].mtime)))
+				break;
+			sts_array_append_insert(script, record, temp, record->array.length);
+		}
+
+	if(ret && ret->type == STS_ARRAY && i != walk.entries.length)
+	{
+		sts_value_reference_decrement(script, ret);
+		ret = NULL;
+	}
+
+	for(i = 0; i < walk.entries.length; ++i)
+		if(walk.entries.data[i].path)
+			free(walk.entries.data[i].path);
+	if(walk.entries.data) free(walk.entries.data);
+
+	return ret;
+}
+#endif
+
+void cli_json_release(cli_json_t *json)
+{
+	if(json->references && --json->references)
+		return;
+
+	json_close(&json->stream);
+
+	if(json->file)
+		cli_file_release(json->file);
+	#ifndef CLI_NO_SOCKETS
+	if(json->socket)
+		cli_socket_release(json->socket);
+	#endif
+	if(json->data)
+	{
+		if(json->mapped)
+			cli_map_release(json->data);
+		else
+			free(json->data);
+	}
+
+	free(json);
+}
+
+/* hands pdjson the next byte of a file or socket, taking it out of the buffer only when consume is set */
+int cli_json_byte(cli_json_t *json, int consume)
+{
+	int ret = EOF;
+
+
+	if(json->file)
+	{
+		if(json->file->buffer.start == json->file->buffer.end && (json->file->fd == -1 || cli_file_fill(json->script, json->file) <= 0))
+			return EOF;
+
+		ret = (unsigned char)json->file->buffer.data[json->file->buffer.start];
+		json->file->buffer.start += consume;
+	}
+	#ifndef CLI_NO_SOCKETS
+	else if(json->socket)
+	{
+		if(json->socket->buffer.start == json->socket->buffer.end && cli_socket_fill(json->script, json->socket) <= 0)
+			return EOF;
+
+		ret = (unsigned char)json->socket->buffer.data[json->socket->buffer.start];
+		json->socket->buffer.start += consume;
+	}
+	#endif
+
+	return ret;
+}
+
+int cli_json_get(void *user)
+{
+	return cli_json_byte(user, 1);
+}
+
+int cli_json_peek(void *user)
+{
+	return cli_json_byte(user, 0);
+}
+
+/* makes a handle that reads from a file, a socket, or a copy of a string. Whatever is passed in is owned by the handle after. Returns NULL on failure */
+sts_value_t *cli_json_new(sts_script_t *script, cli_file_t *file, void *socket, char *data, unsigned long length, char mapped, char lines)
+{
+	sts_value_t *ret = NULL;
+	cli_json_t *json = NULL;
+
+
+	if(!(json = calloc(1, sizeof(cli_json_t))))
+		return NULL;
+
+	json->references = 1;
+	json->script = script;
+	json->file = file;
+	#ifndef CLI_NO_SOCKETS
+	json->socket = socket;
+	#endif
+	json->data = data;
+	json->mapped = mapped;
+	json->lines = lines;
+
+	if(data)
+		json_open_buffer(&json->stream, data, length);
+	else
+		json_open_user(&json->stream, &cli_json_get, &cli_json_peek, json);
+
+	/* lets more than one document follow another, which is all json lines is */
+	json_set_streaming(&json->stream, lines);
+
+	if(!(ret = sts_value_create(script, STS_EXTERNAL)))
+	{
+		cli_json_release(json);
+		return NULL;
+	}
+
+	ret->external.refdec = &cli_json_refdec;
+	ret->external.refinc = &cli_json_refinc;
+	ret->external.data_ptr = json;
+
+	return ret;
+}
+
+/* reads past whatever is left of the document being read */
+void cli_json_finish(cli_json_t *json)
+{
+	int type;
+
+
+	json->each = 0;
+
+	while(json_get_depth(&json->stream))
+		if((type = json_next(&json->stream)) == JSON_ERROR || type == JSON_DONE)
+			break;
+}
+
+void cli_json_error(json_stream *stream)
+{
+	fprintf(stderr, "json parse error on line %ld: '%s'\n", (long)json_get_lineno(stream), json_get_error(stream) ? json_get_error(stream) : "unexpected end of input");
+}
+
+/* moves to the start of the next document. Returns 1 if there is one, 0 at the end, or -1 on a parse error */
+int cli_json_begin(cli_json_t *json)
+{
+	int type;
+
+
+	cli_json_finish(json);
+
+	if((type = json_peek(&json->stream)) == JSON_DONE && json->lines)
+	{
+		json_next(&json->stream);
+		json_reset(&json->stream);
+		type = json_peek(&json->stream);
+	}
+
+	if(type == JSON_ERROR)
+	{
+		cli_json_error(&json->stream);
+		return -1;
+	}
+
+	return type != JSON_DONE;
+}
+
+/* matches the first step of a path against an object key or, when key is NULL, an array index. Returns the rest of the path or NULL */
+char *cli_json_step(char *path, const char *key, unsigned long length, unsigned long index)
+{
+	char *end = NULL;
+
+
+	if(*path == '.')
+		++path;
+
+	if(*path == '[')
+	{
+		if(key || strtoul(&path[1], &end, 10) != index || *end != ']')
+			return NULL;
+
+		return &end[1];
+	}
+
+	end = &path[strcspn(path, ".[")];
+
+	if(!key || (unsigned long)(end - path) != length || memcmp(path, key, length))
+		return NULL;
+
+	return end;
+}
+
+/* follows the rest of a path through a value that was already built. Returns a borrowed value or NULL */
+sts_value_t *cli_json_value_at(sts_script_t *script, sts_value_t *value, char *path)
+{
+	sts_value_t *row = NULL;
+	unsigned long index;
+	char *end = NULL;
+
+
+	while(value && *path)
+	{
+		if(*path == '.')
+			++path;
+
+		if(value->type != STS_ARRAY)
+			return NULL;
+
+		if(*path == '[')
+		{
+			index = strtoul(&path[1], &end, 10);
+			if(*end != ']' || index >= value->array.length || sts_hashmap_verify(script, value))
+				return NULL;
+
+			value = value->array.data[index];
+			path = &end[1];
+		}
+		else
+		{
+			end = &path[strcspn(path, ".[")];
+			if(!sts_hashmap_verify(script, value) || !(row = sts_hashmap_get(script, value, path, end - path)))
+				return NULL;
+
+			value = row->array.data[2];
+			path = end;
+		}
+	}
+
+	return value;
+}
+
+typedef struct
+{
+	unsigned int index;
+	char *rest;
+} cli_json_path_t;
+
+/* reads the next value in the stream and puts what is at each path into results. Only subtrees some path goes through
+are looked into, everything else is skipped without building values. Returns 0 or -1 on a parse error */
+int cli_json_walk(sts_script_t *script, json_stream *stream, cli_json_path_t *paths, unsigned int count, sts_value_t **results)
+{
+	sts_value_t *value = NULL;
+	cli_json_path_t *children = NULL;
+	unsigned long index = 0, length = 0;
+	unsigned int i, found;
+	const char *key = NULL;
+	char *rest = NULL;
+	int type, object, ret = 0;
+
+
+	for(i = 0; i < count; ++i)
+		if(!*paths[i].rest)
+			break;
+
+	/* one of the paths ends here, so it gets built and any path going further looks inside of it */
+	if(i < count)
+	{
+		if(!(value = sts_value_from_json(script, stream, NULL, 0)))
+			return -1;
+
+		for(i = 0; i < count; ++i)
+			if((results[paths[i].index] = *paths[i].rest ? cli_json_value_at(script, value, paths[i].rest) : value))
+				STS_VALUE_REFINC(script, results[paths[i].index]);
+
+		sts_value_reference_decrement(script, value);
+
+		return 0;
+	}
+
+	if(!count || ((type = json_peek(stream)) != JSON_ARRAY && type != JSON_OBJECT))
+	{
+		if(json_skip(stream) != JSON_ERROR)
+			return 0;
+
+		cli_json_error(stream);
+		return -1;
+	}
+
+	if(!(children = malloc(count * sizeof(cli_json_path_t))))
+		return -1;
+
+	object = json_next(stream) == JSON_OBJECT;
+
+	while((type = json_peek(stream)) != JSON_ARRAY_END && type != JSON_OBJECT_END)
+	{
+		if(type == JSON_ERROR || type == JSON_DONE)
+		{
+			cli_json_error(stream);
+			ret = -1;
+			break;
+		}
+
+		/* a key comes before every value of an object */
+		if(object)
+		{
+			json_next(stream);
+			key = json_get_string(stream, (size_t *)&length);
+			--length; /* pdjson counts the \0 */
+		}
+
+		for(i = 0, found = 0; i < count; ++i)
+			if((rest = cli_json_step(paths[i].rest, key, length, index)))
+			{
+				children[found].index = paths[i].index;
+				children[found++].rest = rest;
+			}
+
+		if(found ? cli_json_walk(script, stream, children, found, results) : json_skip(stream) == JSON_ERROR)
+		{
+			if(!found)
+				cli_json_error(stream);
+			ret = -1;
+			break;
+		}
+
+		++index;
+	}
+
+	if(!ret)
+		json_next(stream);
+
+	free(children);
+
+	return ret;
+}
+
+int cli_json_paths_valid(sts_value_t *paths)
+{
+	unsigned int i;
+
+
+	if(paths->type == STS_STRING)
+		return 1;
+	if(paths->type != STS_ARRAY)
+		return 0;
+
+	for(i = 0; i < paths->array.length; ++i)
+		if(paths->array.data[i]->type != STS_STRING)
+			return 0;
+
+	return 1;
+}
+
+/* reads the next value in the stream. With no paths the whole value is built, with a string path only what is at it, and
+with an array of paths an array of what is at each of them. Paths that aren't there are nil. Returns NULL on a parse error */
+sts_value_t *cli_json_query(sts_script_t *script, cli_json_t *json, sts_value_t *paths)
+{
+	sts_value_t *ret = NULL, **results = NULL;
+	cli_json_path_t *alive = NULL;
+	unsigned int count, i;
+
+
+	if(!paths)
+		return sts_value_from_json(script, &json->stream, NULL, 0);
+
+	count = paths->type == STS_ARRAY ? paths->array.length : 1;
+
+	if(!(results = calloc(count + 1, sizeof(sts_value_t *))) || !(alive = calloc(count + 1, sizeof(cli_json_path_t))))
+		goto cleanup;
+
+	for(i = 0; i < count; ++i)
+	{
+		alive[i].index = i;
+		alive[i].rest = paths->type == STS_ARRAY ? paths->array.data[i]->string.data : paths->string.data;
+	}
+
+	if(cli_json_walk(script, &json->stream, alive, count, results))
+		goto cleanup;
+
+	if(paths->type == STS_STRING)
+	{
+		if(!(ret = results[0]))
+			ret = sts_value_create(script, STS_NIL);
+		results[0] = NULL;
+		goto cleanup;
+	}
+
+	if(!(ret = sts_value_create(script, STS_ARRAY)))
+		goto cleanup;
+
+	for(i = 0; i < count; ++i)
+	{
+		if(!results[i] && !(results[i] = sts_value_create(script, STS_NIL)))
+		{
+			sts_value_reference_decrement(script, ret);
+			ret = NULL;
+			goto cleanup;
+		}
+
+		sts_array_append_insert(script, ret, results[i], ret->array.length);
+		results[i] = NULL;
+	}
+
+	cleanup:
+	if(results)
+	{
+		for(i = 0; i < count; ++i)
+			if(results[i])
+				sts_value_reference_decrement(script, results[i]);
+		free(results);
+	}
+	if(alive) free(alive);
+
+	return ret;
+}
+
+/* json-get. Reads the whole next document, returning what is at the path or paths. nil at the end of the input */
+sts_value_t *cli_json_get_paths(sts_script_t *script, cli_json_t *json, sts_value_t *paths)
+{
+	sts_value_t *ret = NULL;
+
+
+	switch(cli_json_begin(json))
+	{
+		case -1: return NULL;
+		case 0: return sts_value_create(script, STS_NIL);
+	}
+
+	ret = cli_json_query(script, json, paths);
+	cli_json_finish(json);
+
+	return ret;
+}
+
+/* reads up to the value at path, skipping everything beside it. Returns 1 if that value is next in the stream, 0 if the path isn't there, or -1 on a parse error */
+int cli_json_find(json_stream *stream, char *path)
+{
+	unsigned long index, length = 0;
+	const char *key = NULL;
+	char *rest = NULL;
+	int type, object;
+
+
+	while(*path)
+	{
+		if((type = json_peek(stream)) != JSON_ARRAY && type != JSON_OBJECT)
+			return type == JSON_ERROR ? -1 : 0;
+
+		object = json_next(stream) == JSON_OBJECT;
+
+		for(index = 0, rest = NULL; !rest; ++index)
+		{
+			if((type = json_peek(stream)) == JSON_ARRAY_END || type == JSON_OBJECT_END)
+				return 0;
+			if(type == JSON_ERROR || type == JSON_DONE)
+				return -1;
+
+			if(object)
+			{
+				json_next(stream);
+				key = json_get_string(stream, (size_t *)&length);
+				--length; /* pdjson counts the \0 */
+			}
+
+			if(!(rest = cli_json_step(path, object ? key : NULL, length, index)) && json_skip(stream) == JSON_ERROR)
+				return -1;
+		}
+
+		path = rest;
+	}
+
+	return 1;
+}
+
+/* json-each. Returns the next element of the array at path, or with no path the next document, only building what
+query asks for. nil once the array or the input runs out */
+sts_value_t *cli_json_each(sts_script_t *script, cli_json_t *json, char *path, sts_value_t *query)
+{
+	int type;
+
+
+	if(!json->each)
+	{
+		switch(cli_json_begin(json))
+		{
+			case -1: return NULL;
+			case 0: return sts_value_create(script, STS_NIL);
+		}
+
+		if(!path)
+			return cli_json_query(script, json, query);
+
+		switch(cli_json_find(&json->stream, path))
+		{
+			case -1:
+				cli_json_error(&json->stream);
+				return NULL;
+			case 0:
+				cli_json_finish(json);
+				return sts_value_create(script, STS_NIL);
+		}
+
+		if(json_next(&json->stream) != JSON_ARRAY)
+		{
+			cli_json_finish(json);
+			return sts_value_create(script, STS_NIL);
+		}
+
+		json->each = 1;
+	}
+
+	if((type = json_peek(&json->stream)) == JSON_ERROR)
+	{
+		cli_json_error(&json->stream);
+		return NULL;
+	}
+
+	if(type == JSON_ARRAY_END || type == JSON_DONE)
+	{
+		cli_json_finish(json);
+		return sts_value_create(script, STS_NIL);
+	}
+
+	return cli_json_query(script, json, query);
+}
+
+/* json being written. It is built in one buffer that grows by doubling. With a file-writer or socket to go to,
+the buffer is handed off whenever it fills instead of growing, so it stays around CLI_JSON_WRITE_CHUNK */
+typedef struct
+{
+	char *data;
+	unsigned long length, allocated, written;
+	cli_writer_t *writer;
+	#ifndef CLI_NO_SOCKETS
+	cli_socket_t *socket;
+	#endif
+} cli_json_output_t;
+
+#ifndef CLI_NO_SOCKETS
+	#define CLI_JSON_OUTPUT_SINK(output) ((output)->writer || (output)->socket)
+#else
+	#define CLI_JSON_OUTPUT_SINK(output) ((output)->writer)
+#endif
+
+/* what each byte is written as after a backslash. 'u' means as \u00XX and 0 means it doesn't need escaping */
+static const char cli_json_escapes[256] = {
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+	['"'] = '"', ['/'] = '/', ['\\'] = '\\'
+};
+
+/* hands what is buffered to the file-writer or socket. A string keeps all of it. Returns 0 or -1 */
+int cli_json_output_flush(cli_json_output_t *output)
+{
+	int ret = 0;
+
+
+	if(!output->length || !CLI_JSON_OUTPUT_SINK(output))
+		return 0;
+
+	if(output->writer)
+		ret = cli_writer_write(output->writer, output->data, output->length) == -1 ? -1 : 0;
+	#ifndef CLI_NO_SOCKETS
+	else if(output->socket->ssl ? SSL_write(output->socket->ssl, output->data, output->length) != (int)output->length : zed_net_tcp_socket_send(&output->socket->socket, output->data, output->length) != 0)
+		ret = -1;
+	#endif
+
+	output->written += output->length;
+	output->length = 0;
+
+	return ret;
+}
+
+/* makes room for length more bytes. Returns 0 or -1 */
+int cli_json_output_reserve(cli_json_output_t *output, unsigned long length)
+{
+	char *temp = NULL;
+	unsigned long size;
+
+
+	if(output->length + length <= output->allocated)
+		return 0;
+
+	if(CLI_JSON_OUTPUT_SINK(output) && output->length)
+	{
+		if(cli_json_output_flush(output))
+			return -1;
+		if(length <= output->allocated)
+			return 0;
+	}
+
+	for(size = output->allocated ? output->allocated * 2 : (CLI_JSON_OUTPUT_SINK(output) ? CLI_JSON_WRITE_CHUNK : 1024); size < output->length + length + 1; size *= 2);
+
+	if(!(temp = realloc(output->data, size)))
+	{
+		fprintf(stderr, "could not resize json output\n");
+		return -1;
+	}
+
+	output->data = temp;
+	output->allocated = size;
+
+	return 0;
+}
+
+int cli_json_output_emit(cli_json_output_t *output, const char *data, unsigned long length)
+{
+	if(cli_json_output_reserve(output, length))
+		return -1;
+
+	memcpy(&output->data[output->length], data, length);
+	output->length += length;
+
+	return 0;
+}
+
+/* writes a quoted string, copying the runs between characters that need escaping in one go. With SSE2 those
+characters are looked for 16 bytes at a time */
+int cli_json_output_string(cli_json_output_t *output, const char *string, unsigned long length)
+{
+	unsigned long i = 0, start;
+	char escaped[7];
+	#ifdef __SSE2__
+	const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), slash = _mm_set1_epi8('/'), control = _mm_set1_epi8(0x1f);
+	__m128i chunk;
+	int mask;
+	#endif
+
+
+	if(cli_json_output_emit(output, "\"", 1))
+		return -1;
+
+	while(i < length)
+	{
+		start = i;
+
+		#ifdef __SSE2__
+		for(; i + 16 <= length; i += 16)
+		{
+			chunk = _mm_loadu_si128((const __m128i *)&string[i]);
+			/* the min is only equal to the byte itself for bytes at or under 0x1f */
+			mask = _mm_movemask_epi8(_mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, slash), _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk))));
+
+			if(mask)
+			{
+				i += __builtin_ctz(mask);
+				break;
+			}
+		}
+		#endif
+
+		while(i < length && !cli_json_escapes[(unsigned char)string[i]])
+			++i;
+
+		if(i > start && cli_json_output_emit(output, &string[start], i - start))
+			return -1;
+
+		if(i < length)
+		{
+			escaped[0] = '\\';
+			escaped[1] = cli_json_escapes[(unsigned char)string[i]];
+
+			if(escaped[1] == 'u')
+				snprintf(&escaped[1], sizeof(escaped) - 1, "u%04x", (unsigned char)string[i]);
+
+			if(cli_json_output_emit(output, escaped, escaped[1] == 'u' ? 6 : 2))
+				return -1;
+			++i;
+		}
+	}
+
+	return cli_json_output_emit(output, "\"", 1);
+}
+
+int cli_json_output_indent(cli_json_output_t *output, int depth)
+{
+	if(cli_json_output_reserve(output, depth))
+		return -1;
+
+	memset(&output->data[output->length], '\t', depth);
+	output->length += depth;
+
+	return 0;
+}
+
+/* writes a value as json. Arrays that look like stdlib hashmaps are written as objects. Returns 0 or -1 */
+int cli_json_output_value(sts_script_t *script, cli_json_output_t *output, sts_value_t *value, int pretty, int depth)
+{
+	char number[32];
+	unsigned long i;
+
+
+	switch(value->type)
+	{
+		case STS_NUMBER:
+			return cli_json_output_emit(output, number, snprintf(number, sizeof(number), "%1.17g", value->number));
+		case STS_BOOLEAN:
+			return cli_json_output_emit(output, value->boolean ? "true" : "false", value->boolean ? 4 : 5);
+		case STS_STRING:
+			return cli_json_output_string(output, value->string.data, value->string.length);
+		case STS_ARRAY:
+			if(sts_hashmap_verify(script, value))
+			{
+				if(cli_json_output_emit(output, "{\n", pretty ? 2 : 1))
+					return -1;
+
+				for(i = 0; i < value->array.length; ++i)
+				{
+					if((pretty && cli_json_output_indent(output, depth + 1)) ||
+						cli_json_output_string(output, value->array.data[i]->array.data[1]->string.data, value->array.data[i]->array.data[1]->string.length) ||
+						cli_json_output_emit(output, ": ", 2) ||
+						cli_json_output_value(script, output, value->array.data[i]->array.data[2], pretty, depth + 1) ||
+						(i != value->array.length - 1 && cli_json_output_emit(output, ",", 1)) ||
+						(pretty && cli_json_output_emit(output, "\n", 1)))
+						return -1;
+				}
+
+				if(pretty && cli_json_output_indent(output, depth))
+					return -1;
+
+				return cli_json_output_emit(output, "}", 1);
+			}
+
+			if(cli_json_output_emit(output, "[", 1))
+				return -1;
+
+			for(i = 0; i < value->array.length; ++i)
+				if(cli_json_output_value(script, output, value->array.data[i], pretty, depth + 1) || (i != value->array.length - 1 && cli_json_output_emit(output, ",", 1)))
+					return -1;
+
+			return cli_json_output_emit(output, "]", 1);
+		default: /* nil, and functions which have no json form */
+			return cli_json_output_emit(output, "null", 4);
+	}
+}
+
+/* base64 with padding. With SSSE3 it goes 12 bytes to 16 characters at a time using pshufb as the lookup table,
+otherwise 3 bytes at a time. AVX2 builds have SSSE3 too, so they get the same path */
+static const char cli_base64_alphabet[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* 255 for anything that isn't in the alphabet */
+static const unsigned char cli_base64_values[256] = {
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 62, 255, 255, 255, 63,
+	52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 255, 255, 255, 255, 255, 255,
+	255, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+	15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 255, 255, 255, 255, 255,
+	255, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+	41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255
+};
+
+#define CLI_BASE64_ENCODED_LENGTH(length) (4 * (((length) + 2) / 3))
+
+/* sets decoded to the exact length of what decoding gives. Returns 0, or -1 if the length can't be base64 */
+int cli_base64_decoded_length(const char *string, unsigned long length, unsigned long *decoded)
+{
+	if(length % 4)
+		return -1;
+
+	*decoded = length ? length / 4 * 3 - (string[length - 1] == '=') - (string[length - 2] == '=') : 0;
+
+	return 0;
+}
+
+/* writes exactly CLI_BASE64_ENCODED_LENGTH(length) characters */
+void cli_base64_encode(char *dest, const unsigned char *src, unsigned long length)
+{
+	const unsigned char *end = src + length;
+	uint32_t group;
+	#ifdef __SSSE3__
+	const __m128i spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+	const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+	__m128i chunk, indices;
+
+
+	/* loads 16 but only uses 12, so the last few bytes are left to the scalar loop */
+	for(; end - src >= 16; src += 12, dest += 16)
+	{
+		chunk = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)src), spread);
+
+		/* every 32 bit lane has 3 bytes in it now. Split them into four 6 bit indices, one per byte */
+		indices = _mm_or_si128(_mm_mulhi_epu16(_mm_and_si128(chunk, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040)),
+			_mm_mullo_epi16(_mm_and_si128(chunk, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010)));
+
+		/* picks which range of the alphabet each index is in and adds the offset of that range */
+		chunk = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+		chunk = _mm_or_si128(chunk, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+		_mm_storeu_si128((__m128i *)dest, _mm_add_epi8(_mm_shuffle_epi8(offsets, chunk), indices));
+	}
+	#endif
+
+
+	for(; end - src >= 3; src += 3, dest += 4)
+	{
+		group = (uint32_t)src[0] << 16 | (uint32_t)src[1] << 8 | src[2];
+		dest[0] = cli_base64_alphabet[group >> 18];
+		dest[1] = cli_base64_alphabet[group >> 12 & 63];
+		dest[2] = cli_base64_alphabet[group >> 6 & 63];
+		dest[3] = cli_base64_alphabet[group & 63];
+	}
+
+	if(end - src)
+	{
+		group = (uint32_t)src[0] << 16 | (end - src == 2 ? (uint32_t)src[1] << 8 : 0);
+		dest[0] = cli_base64_alphabet[group >> 18];
+		dest[1] = cli_base64_alphabet[group >> 12 & 63];
+		dest[2] = end - src == 2 ? cli_base64_alphabet[group >> 6 & 63] : '=';
+		dest[3] = '=';
+	}
+}
+
+/* writes exactly the length cli_base64_decoded_length gives. Returns 0, or -1 if the string isn't valid base64 */
+int cli_base64_decode(unsigned char *dest, const char *src, unsigned long length)
+{
+	const unsigned char *string = (const unsigned char *)src, *end = string + length;
+	unsigned long padding;
+	uint32_t group;
+	#ifdef __SSSE3__
+	const __m128i low_lookup = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+	const __m128i high_lookup = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m128i shifts = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	const __m128i nibble = _mm_set1_epi8(0x2f);
+	__m128i chunk, high;
+
+
+	/* stores 16 but only 12 are used, so it stops while there is enough output left for that */
+	for(; end - string >= 24; string += 16, dest += 12)
+	{
+		chunk = _mm_loadu_si128((const __m128i *)string);
+		high = _mm_and_si128(_mm_srli_epi32(chunk, 4), nibble);
+
+		/* the two lookups only share a bit for bytes that aren't in the alphabet */
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(_mm_shuffle_epi8(low_lookup, _mm_and_si128(chunk, nibble)), _mm_shuffle_epi8(high_lookup, high)), _mm_setzero_si128())) != 0xffff)
+			return -1;
+
+		/* turns characters into their 6 bit values, then packs every four of them into 3 bytes */
+		chunk = _mm_add_epi8(chunk, _mm_shuffle_epi8(shifts, _mm_add_epi8(_mm_cmpeq_epi8(chunk, nibble), high)));
+		chunk = _mm_madd_epi16(_mm_maddubs_epi16(chunk, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+		_mm_storeu_si128((__m128i *)dest, _mm_shuffle_epi8(chunk, pack));
+	}
+	#endif
+
+	if((end - string) % 4)
+		return -1;
+
+	padding = end - string && end[-1] == '=' ? 1 + (end[-2] == '=') : 0;
+
+	for(; end - string > 4 || (end - string == 4 && !padding); string += 4, dest += 3)
+	{
+		if((cli_base64_values[string[0]] | cli_base64_values[string[1]] | cli_base64_values[string[2]] | cli_base64_values[string[3]]) == 255)
+			return -1;
+
+		group = (uint32_t)cli_base64_values[string[0]] << 18 | (uint32_t)cli_base64_values[string[1]] << 12 | (uint32_t)cli_base64_values[string[2]] << 6 | cli_base64_values[string[3]];
+		dest[0] = group >> 16;
+		dest[1] = group >> 8;
+		dest[2] = group;
+	}
+
+	if(end - string)
+	{
+		if((cli_base64_values[string[0]] | cli_base64_values[string[1]] | (padding == 1 ? cli_base64_values[string[2]] : 0)) == 255)
+			return -1;
+
+		group = (uint32_t)cli_base64_values[string[0]] << 18 | (uint32_t)cli_base64_values[string[1]] << 12 | (padding == 1 ? (uint32_t)cli_base64_values[string[2]] << 6 : 0);
+		dest[0] = group >> 16;
+		if(padding == 1)
+			dest[1] = group >> 8;
+	}
+
+	return 0;
+}
+
+char *import(sts_script_t *script, char *file)
+{
+	unsigned int size = 0;
+	char *ret = NULL, *assemble_string = NULL;
+
+
+	STS_STRING_ASSEMBLE(assemble_string, size, INSTALL_DIR, strlen(INSTALL_DIR), file, strlen(file));
+
+	ret = read_file(script, assemble_string, &size);
+
+	STS_FREE(assemble_string);
+
+	return ret;
+}
+
+sts_value_t *cli_actions(sts_script_t *script, sts_value_t *action, sts_node_t *args, sts_scope_t *locals, sts_value_t **previous)
+{
+	sts_value_t *ret = NULL, *eval_value = NULL, *temp_value = NULL, *first_arg_value = NULL, *second_arg_value = NULL, *third_arg_value = NULL;
+	FILE *proc_pipe = NULL, *file = NULL;
+	#ifndef CLI_NO_SOCKETS
+	zed_net_address_t address;
+	#endif
+	char *temp_str = NULL, *popen_buf = NULL, buf[1024];
+	unsigned int i = 0, size = 0, total = 0, temp_uint = 0;
+	unsigned long temp_ulong = 0;
+	void *work_area = NULL;
+	int temp_int = 0;
+	cli_json_output_t json_output;
+	cli_xxh64_t xxh64_state;
+	cli_future_t *future = NULL;
+	uint64_t fast_hash = 0;
+	uint8_t hash[32];
+	#ifndef CLI_NO_POLLER
+	cli_poller_t *poller = NULL;
+	cli_socket_t *polled = NULL;
+	#endif
+	#ifndef CLI_NO_COROUTINES
+	sts_node_t *arg = NULL;
+	cli_coroutine_t *coroutine = NULL;
+	cli_channel_t *channel = NULL;
+	#endif
+
+
+	GOTO_JMP(&cli_actions);
+	if(!GOTO_ACTIVATED && action->type == STS_STRING)
+	{
+		ACTION(if, "pipeout")
+		{
+			GOTO_SET(&cli_actions);
+			/* the first arg is the string that comes from stdout and
+			the remaining arguments are the command part */
+			
+			EVAL_ARG(args->next);
+			first_arg_value = eval_value;
+			STS_VALUE_EXPECT_MUTABLE(first_arg_value, return NULL);
+
+			args = args->next;
+
+			ACTION_BEGIN_ARGLOOP
+				switch(eval_value->type)
+				{
+					case STS_NUMBER: STS_STRING_ASSEMBLE_FMT(temp_str, size, "%1.17g", eval_value->number, " ", 1); break;
+					case STS_BOOLEAN: STS_STRING_ASSEMBLE_FMT(temp_str, size, "%s", eval_value->boolean ? "true" : "false", " ", 1); break;
+					case STS_STRING: STS_STRING_ASSEMBLE(temp_str, size, eval_value->string.data, eval_value->string.length, " ", 1); break;
+				}
+			ACTION_END_ARGLOOP
+
+			sts_output_flush(script); /* the command can still write to the terminal */
+			if((proc_pipe = popen(temp_str, "r")))
+			{
+				while((size = fread(buf, 1, sizeof(buf), proc_pipe)) > 0)
+				{
+					if(!(popen_buf = realloc(popen_buf, total + size + 1)))
+					{
+						fprintf(stderr, "could not resize pipe buffer\n");
+						break;
+					}
+
+					memmove(&popen_buf[total], buf, size);
+					total += size;
+					popen_buf[total] = 0x0;
+				}
+
+				/* make string into sts value */
+				VALUE_INIT(temp_value, STS_STRING);
+
+				/* copy it to the first arg to set it to a string only */
+				if(sts_value_copy(script, first_arg_value, temp_value, 0))
+				{
+					fprintf(stderr, "could not set value to string type\n");
+				}
+
+				first_arg_value->string.data = popen_buf;
+				first_arg_value->string.length = total;
+
+				/* cleanup temporary value */
+
+				if(!sts_value_reference_decrement(script, temp_value))
+					STS_ERROR_SIMPLE("could not decrement references for temporary value in pipeout action");
+				
+
+				VALUE_FROM_NUMBER(ret, (double)pclose(proc_pipe));
+			}
+			else
+			{
+				fprintf(stderr, "could not execute command provided\n");
+			}
+
+			free(temp_str);
+			if(!sts_value_reference_decrement(script, first_arg_value))
+				STS_ERROR_SIMPLE("could not decrement references for first argument in pipeout action");
+		}
+		#ifndef CLI_NO_PROCESSES
+		ACTION(else if, "process-spawn") /* starts a command from an argv array without the shell. Returns a process, or nil if it can't be started */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(!(work_area = cli_process_argv(eval_value)))
+				{
+					fprintf(stderr, "the process-spawn action requires a non empty array of strings for the command\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in process-spawn action");
+					return NULL;
+				}
+
+				ret = cli_process_spawn(script, work_area);
+				cli_process_argv_free(work_area);
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in process-spawn action");
+
+				if(!ret)
+				{
+					STS_ERROR_SIMPLE("could not create process in process-spawn");
+					return NULL;
+				}
+			}
+			else {STS_ERROR_SIMPLE("process-spawn action requires an argv array"); return NULL;}
+		}
+		ACTION(else if, "process-stdout") /* the stdout of a process as a file for file-read-line */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(!IS_CLI_PROCESS(eval_value))
+				{
+					fprintf(stderr, "the process-stdout action requires a process from process-spawn\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in process-stdout action");
+					return NULL;
+				}
+
+				if((ret = cli_file_value(script, CLI_PROCESS(eval_value)->out)))
+					CLI_PROCESS(eval_value)->out->references++;
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in process-stdout action");
+
+				if(!ret)
+					return NULL;
+			}
+			else {STS_ERROR_SIMPLE("process-stdout action requires a process"); return NULL;}
+		}
+		ACTION(else if, "process-stderr") /* the stderr of a process as a file for file-read-line */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(!IS_CLI_PROCESS(eval_value))
+				{
+					fprintf(stderr, "the process-stderr action requires a process from process-spawn\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in process-stderr action");
+					return NULL;
+				}
+
+				if((ret = cli_file_value(script, CLI_PROCESS(eval_value)->err)))
+					CLI_PROCESS(eval_value)->err->references++;
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in process-stderr action");
+
+				if(!ret)
+					return NULL;
+			}
+			else {STS_ERROR_SIMPLE("process-stderr action requires a process"); return NULL;}
+		}
+		ACTION(else if, "process-wait") /* waits for a process to exit and returns its exit code */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(!IS_CLI_PROCESS(eval_value))
+				{
+					fprintf(stderr, "the process-wait action requires a process from process-spawn\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in process-wait action");
+					return NULL;
+				}
+
+				VALUE_FROM_NUMBER(ret, cli_process_wait(CLI_PROCESS(eval_value)));
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in process-wait action");
+			}
+			else {STS_ERROR_SIMPLE("process-wait action requires a process"); return NULL;}
+		}
+		ACTION(else if, "process-run-parallel") /* runs an array of argv arrays with at most max at once. Returns [exit_code stdout stderr] for each, in order */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next); first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(first_arg_value->type != STS_ARRAY || eval_value->type != STS_NUMBER || eval_value->number < 1.0)
+				{
+					fprintf(stderr, "the process-run-parallel action requires an array of argv arrays and a max concurrency of at least 1\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in process-run-parallel action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in process-run-parallel action");
+					return NULL;
+				}
+
+				ret = cli_process_run_parallel(script, first_arg_value, (unsigned int)eval_value->number);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in process-run-parallel action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in process-run-parallel action");
+
+				if(!ret)
+				{
+					STS_ERROR_SIMPLE("could not run the commands in process-run-parallel");
+					return NULL;
+				}
+			}
+			else {STS_ERROR_SIMPLE("process-run-parallel action requires an array of commands and a max concurrency"); return NULL;}
+		}
+		#endif
+		ACTION(else if, "file-read") /* reads files into a string */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(eval_value->type != STS_STRING)
+				{
+					fprintf(stderr, "the file-read action requires a string argument for the path\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-read action");
+					return NULL;
+				}
+
+				if(!(file = fopen(eval_value->string.data, "rb")))
+				{
+					VALUE_INIT(ret, STS_NIL);
+				}
+				else
+				{
+					fseek(file, 0, SEEK_END);
+					temp_uint = ftell(file);
+					fseek(file, 0, SEEK_SET);
+
+					if(!(temp_str = calloc(temp_uint + 1, sizeof(char))))
+					{
+						fprintf(stderr, "could not alocate string in read-file\n");
+						VALUE_INIT(ret, STS_NIL);
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-read action");
+						return ret;
+					}
+					
+					if(fread(temp_str, temp_uint, sizeof(char), file) <= 0)
+					{
+						fprintf(stderr, "could not read file in read-file\n");
+					}
+
+					VALUE_INIT(ret, STS_STRING);
+					ret->string.data = temp_str;
+					ret->string.length = temp_uint;
+
+					fclose(file);
+				}
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-read action");
+			}
+			else {STS_ERROR_SIMPLE("file-read action requires a single string path argument"); return NULL;}
+		}
+		ACTION(else if, "file-map") /* maps a file into a string. Only the pages that are used get read. Files that can't be mapped are read like file-read does */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(eval_value->type != STS_STRING)
+				{
+					fprintf(stderr, "the file-map action requires a string argument for the path\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-map action");
+					return NULL;
+				}
+
+				if((temp_str = cli_map_file(eval_value->string.data, &temp_uint)))
+				{
+					VALUE_INIT(ret, STS_STRING);
+					ret->string.data = temp_str;
+					ret->string.length = temp_uint;
+					ret->mapped = 1;
+				}
+				else if((temp_str = read_file(script, eval_value->string.data, &temp_uint)))
+				{
+					VALUE_INIT(ret, STS_STRING);
+					ret->string.data = temp_str;
+					ret->string.length = temp_uint;
+				}
+				else
+					VALUE_INIT(ret, STS_NIL);
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-map action");
+			}
+			else {STS_ERROR_SIMPLE("file-map action requires a single string path argument"); return NULL;}
+		}
+		ACTION(else if, "file-open") /* opens a file for file-read-line. Returns nil if it can't be opened */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(eval_value->type != STS_STRING)
+				{
+					fprintf(stderr, "the file-open action requires a string argument for the path\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-open action");
+					return NULL;
+				}
+
+				if((temp_int = open(eval_value->string.data, O_RDONLY | O_CLOEXEC)) == -1)
+					VALUE_INIT(ret, STS_NIL);
+				else if(!(work_area = cli_file_new(temp_int, 0)) || !(ret = cli_file_value(script, work_area)))
+				{
+					STS_ERROR_SIMPLE("could not create file handle in file-open");
+					if(work_area) cli_file_release(work_area);
+					else close(temp_int);
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-open action");
+					return NULL;
+				}
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-open action");
+			}
+			else {STS_ERROR_SIMPLE("file-open action requires a single string path argument"); return NULL;}
+		}
+		ACTION(else if, "file-read-line") /* returns the next line without the newline, or nil at the end of the file */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(!IS_CLI_FILE(eval_value))
+				{
+					fprintf(stderr, "the file-read-line action requires a file from file-open\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-read-line action");
+					return NULL;
+				}
+
+				ret = cli_file_read_line(script, CLI_FILE(eval_value));
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-read-line action");
+
+				if(!ret)
+					return NULL;
+			}
+			else {STS_ERROR_SIMPLE("file-read-line action requires a file"); return NULL;}
+		}
+		ACTION(else if, "file-close") /* closes a file from file-open before its last reference is gone */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(!IS_CLI_FILE(eval_value))
+				{
+					fprintf(stderr, "the file-close action requires a file from file-open\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-close action");
+					return NULL;
+				}
+
+				cli_file_close(CLI_FILE(eval_value));
+				VALUE_FROM_NUMBER(ret, 0);
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-close action");
+			}
+			else {STS_ERROR_SIMPLE("file-close action requires a file"); return NULL;}
+		}
+		ACTION(else if, "file-write") /* writes a string to a file */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next); first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(first_arg_value->type != STS_STRING && eval_value->type != STS_STRING)
+				{
+					fprintf(stderr, "file-write requires 2 string arguments only\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in file-write action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-write action");
+					return NULL;
+				}
+
+				if(!(file = fopen(first_arg_value->string.data, "wb")))
+				{
+					VALUE_INIT(ret, STS_NIL);
+				}
+				else
+				{
+					VALUE_FROM_NUMBER(ret, fwrite(eval_value->string.data, sizeof(char), eval_value->string.length, file));
+					fclose(file);
+				}
+				
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in file-write action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-write action");
+			}
+			else {STS_ERROR_SIMPLE("file-write action requires at least 2 string arguments"); return NULL;}
+		}
+		ACTION(else if, "file-writer") /* opens a buffered file-writer. Returns nil if the file can't be opened (file, optional append, optional buffer size) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				if(args->next->next)
+				{
+					EVAL_ARG(args->next->next);
+					second_arg_value = eval_value;
+				}
+				if(args->next->next && args->next->next->next)
+				{
+					EVAL_ARG(args->next->next->next);
+					third_arg_value = eval_value;
+				}
+
+				if(first_arg_value->type != STS_STRING || (second_arg_value && second_arg_value->type != STS_NUMBER && second_arg_value->type != STS_BOOLEAN) || (third_arg_value && (third_arg_value->type != STS_NUMBER || third_arg_value->number < 0.0)))
+				{
+					fprintf(stderr, "the file-writer action requires a path, and optionally if it appends and the buffer size\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-writer action");
+					if(second_arg_value && !sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in file-writer action");
+					if(third_arg_value && !sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in file-writer action");
+					return NULL;
+				}
+
+				if(!(ret = cli_writer_new(script, first_arg_value->string.data, second_arg_value && (second_arg_value->type == STS_NUMBER ? second_arg_value->number != 0.0 : second_arg_value->boolean), third_arg_value ? (unsigned long)third_arg_value->number : CLI_WRITER_BUFFER_SIZE)))
+					STS_ERROR_SIMPLE("could not create file-writer");
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-writer action");
+				if(second_arg_value && !sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in file-writer action");
+				if(third_arg_value && !sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in file-writer action");
+
+				if(!ret)
+					return NULL;
+			}
+			else {STS_ERROR_SIMPLE("file-writer action requires a path"); return NULL;}
+		}
+		ACTION(else if, "file-writer-write") /* buffers a string. Returns the amount written or -1 (writer, string) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(!IS_CLI_WRITER(first_arg_value) || eval_value->type != STS_STRING)
+				{
+					fprintf(stderr, "the file-writer-write action requires a file-writer and a string\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-writer-write action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in file-writer-write action");
+					return NULL;
+				}
+
+				VALUE_FROM_NUMBER(ret, cli_writer_write(CLI_WRITER(first_arg_value), eval_value->string.data, eval_value->string.length));
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-writer-write action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in file-writer-write action");
+			}
+			else {STS_ERROR_SIMPLE("file-writer-write action requires a file-writer and a string"); return NULL;}
+		}
+		ACTION(else if, "file-writer-flush") /* writes out what is buffered and optionally fsyncs. Returns 0 or -1 (writer, optional sync) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				if(args->next->next)
+				{
+					EVAL_ARG(args->next->next);
+					second_arg_value = eval_value;
+				}
+
+				if(!IS_CLI_WRITER(first_arg_value) || (second_arg_value && second_arg_value->type != STS_NUMBER && second_arg_value->type != STS_BOOLEAN))
+				{
+					fprintf(stderr, "the file-writer-flush action requires a file-writer and optionally if it should sync\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-writer-flush action");
+					if(second_arg_value && !sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in file-writer-flush action");
+					return NULL;
+				}
+
+				temp_int = CLI_WRITER(first_arg_value)->fd == -1 ? -1 : cli_writer_flush(CLI_WRITER(first_arg_value));
+
+				#ifndef CLI_WINDOWS
+				if(!temp_int && second_arg_value && (second_arg_value->type == STS_NUMBER ? second_arg_value->number != 0.0 : second_arg_value->boolean))
+					temp_int = fsync(CLI_WRITER(first_arg_value)->fd);
+				#endif
+
+				VALUE_FROM_NUMBER(ret, temp_int);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-writer-flush action");
+				if(second_arg_value && !sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in file-writer-flush action");
+			}
+			else {STS_ERROR_SIMPLE("file-writer-flush action requires a file-writer"); return NULL;}
+		}
+		ACTION(else if, "file-writer-close") /* flushes and closes a file-writer before its last reference goes away. Returns 0 or -1 */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(!IS_CLI_WRITER(eval_value))
+				{
+					fprintf(stderr, "the file-writer-close action requires a file-writer\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-writer-close action");
+					return NULL;
+				}
+
+				VALUE_FROM_NUMBER(ret, cli_writer_close(CLI_WRITER(eval_value)));
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-writer-close action");
+			}
+			else {STS_ERROR_SIMPLE("file-writer-close action requires a file-writer"); return NULL;}
+		}
+		ACTION(else if, "file-append") /* appends a string to a file */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next); first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(first_arg_value->type != STS_STRING && eval_value->type != STS_STRING)
+				{
+					fprintf(stderr, "file-append requires 2 string arguments only\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in file-append action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-append action");
+					return NULL;
+				}
+
+				if(!(file = fopen(first_arg_value->string.data, "ab")))
+				{
+					VALUE_INIT(ret, STS_NIL);
+				}
+				else
+				{
+					VALUE_FROM_NUMBER(ret, fwrite(eval_value->string.data, sizeof(char), eval_value->string.length, file));
+					fclose(file);
+				}
+				
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in file-append action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-append action");
+			}
+			else {STS_ERROR_SIMPLE("file-append action requires at least 2 string arguments"); return NULL;}
+		}
+		ACTION(else if, "stdin-read") /* if <=0, it reads until eof. If >0, it will read at least that many characters */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(eval_value->type != STS_NUMBER && eval_value->type != STS_STRING)
+				{
+					fprintf(stderr, "the stdin-read action requires a number argument for the amount to read or a character (single char long string) for the character to read until\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the stdin-read action");
+					return NULL;
+				}
+
+				sts_output_flush(script); /* a prompt has to be seen before waiting for the answer */
+
+				/* the main interpreter shares the buffer of stdin-read-line, so mixing the two doesn't lose or reorder input */
+				if(CLI_STATE(script))
+				{
+					if(!CLI_STATE(script)->input && !(CLI_STATE(script)->input = cli_file_new(STDIN_FILENO, 1)))
+						STS_ERROR_SIMPLE("could not create the stdin buffer in stdin-read");
+					else
+						ret = cli_file_read_until(script, CLI_STATE(script)->input, eval_value->type == STS_NUMBER && eval_value->number > 0 ? (unsigned long)eval_value->number : 0, eval_value->type == STS_STRING ? *eval_value->string.data : 0);
+
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in stdin-read action");
+					if(!ret)
+						return NULL;
+				}
+				else if(eval_value->type == STS_NUMBER)
+				{
+					while((size = fread(buf, 1, ((unsigned int)eval_value->number <= 0) ? sizeof(buf) : (unsigned int)eval_value->number, stdin)) > 0)
+					{
+						if(!(temp_str = realloc(temp_str, total + size + 1)))
+						{
+							fprintf(stderr, "could not resize stdin buffer\n");
+							break;
+						}
+
+						memmove(&temp_str[total], buf, size);
+						total += size;
+						temp_str[total] = 0x0;
+
+						if(eval_value->number > 0 && total == eval_value->number)
+							break;
+					}
+				}
+				else
+				{
+					while((size = fread(buf, 1, 1, stdin)) > 0)
+					{
+						if(!(temp_str = realloc(temp_str, total + size + 1))) /* not very quick */
+						{
+							fprintf(stderr, "could not resize stdin buffer\n");
+							break;
+						}
+
+						memmove(&temp_str[total], buf, size);
+						total += size;
+						temp_str[total] = 0x0;
+
+						if(*eval_value->string.data == temp_str[total - 1])
+						{
+							temp_str[total - 1] = 0x0;
+							break;
+						}
+					}
+				}
+
+				if(!ret)
+				{
+					VALUE_INIT(ret, STS_STRING);
+
+					ret->string.data = temp_str;
+					ret->string.length = total;
+
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in stdin-read action");
+				}
+			}
+			else {STS_ERROR_SIMPLE("stdin-read action requires a single string path argument"); return NULL;}
+		}
+		ACTION(else if, "stdin-read-line") /* returns the next line of stdin without the newline, or nil at the end */
+		{
+			GOTO_SET(&cli_actions);
+			if(!CLI_STATE(script))
+			{
+				fprintf(stderr, "the stdin-read-line action can only be used by the main interpreter\n");
+				VALUE_INIT(ret, STS_NIL);
+				return ret;
+			}
+
+			if(!CLI_STATE(script)->input && !(CLI_STATE(script)->input = cli_file_new(STDIN_FILENO, 1)))
+			{
+				STS_ERROR_SIMPLE("could not create the stdin buffer in stdin-read-line");
+				return NULL;
+			}
+
+			sts_output_flush(script); /* a prompt has to be seen before waiting for the answer */
+			if(!(ret = cli_file_read_line(script, CLI_STATE(script)->input)))
+				return NULL;
+		}
+		ACTION(else if, "stdout-write") /* writes raw strings to stdout */
+		{
+			GOTO_SET(&cli_actions);
+			ACTION_BEGIN_ARGLOOP
+				switch(eval_value->type)
+				{
+					case STS_NUMBER: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%1.17g", eval_value->number, " ", 0); break;
+					case STS_NIL: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%s", "nil", " ", 0); break;
+					case STS_ARRAY: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "[array passed and is %u elements long]", eval_value->array.length,  " ", 0); break;
+					case STS_STRING: STS_STRING_ASSEMBLE(temp_str, temp_uint, eval_value->string.data, eval_value->string.length, " ", 0); break;
+					case STS_EXTERNAL: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%p", eval_value->external.data_ptr, " ", 0); break;
+					case STS_FUNCTION: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "[function passed and it takes %u arguments]", eval_value->function.argument_identifiers->array.length, " ", 0); break;
+					case STS_BOOLEAN: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%s", eval_value->boolean ? "true" : "false", " ", 0); break;
+				}
+			ACTION_END_ARGLOOP
+			if(temp_uint && sts_output_write(script, temp_str, temp_uint)) STS_ERROR_SIMPLE("could not write the output of the stdout-write action");
+			STS_FREE(temp_str);
+			VALUE_FROM_NUMBER(ret, 1);
+		}
+		ACTION(else if, "stderr-write") /* writes raw strings to stderr */
+		{
+			GOTO_SET(&cli_actions);
+			ACTION_BEGIN_ARGLOOP
+				switch(eval_value->type)
+				{
+					case STS_NUMBER: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%1.17g", eval_value->number, " ", 0); break;
+					case STS_NIL: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%s", "nil", " ", 0); break;
+					case STS_ARRAY: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "[array passed and is %u elements long]", eval_value->array.length,  " ", 0); break;
+					case STS_STRING: STS_STRING_ASSEMBLE(temp_str, temp_uint, eval_value->string.data, eval_value->string.length, " ", 0); break;
+					case STS_EXTERNAL: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%p", eval_value->external.data_ptr, " ", 0); break;
+					case STS_FUNCTION: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "[function passed and it takes %u arguments]", eval_value->function.argument_identifiers->array.length, " ", 0); break;
+					case STS_BOOLEAN: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%s", eval_value->boolean ? "true" : "false", " ", 0); break;
+				}
+			ACTION_END_ARGLOOP
+			if(temp_uint) fwrite(temp_str, 1, temp_uint, stderr);
+			STS_FREE(temp_str);
+			VALUE_FROM_NUMBER(ret, 1);
+		}
+		ACTION(else if, "getenv") /* gets a string from the system shell environment */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(eval_value->type != STS_STRING)
+				{
+					fprintf(stderr, "the getenv action requires a string argument for the env variable\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in getenv action");
+					return NULL;
+				}
+
+				if(!(temp_str = getenv(eval_value->string.data)))
+				{
+					VALUE_INIT(ret, STS_NIL);
+				}
+				else
+				{
+					VALUE_INIT(ret, STS_STRING);
+					if(!(ret->string.data = strdup(temp_str)))
+					{
+						fprintf(stderr, "couldnt duplicate environment variable value\n");
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in getenv action");
+						return NULL;
+					}
+					ret->string.length = strlen(temp_str);
+				}
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in getenv action");
+			}
+			else {STS_ERROR_SIMPLE("getenv action requires a single string path argument"); return NULL;}
+		}
+		ACTION(else if, "setenv") /* write a new or overwrite old env variable */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next); first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(first_arg_value->type != STS_STRING && eval_value->type != STS_STRING)
+				{
+					fprintf(stderr, "setenv requires 2 string arguments only\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in setenv action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in setenv action");
+					return NULL;
+				}
+
+				VALUE_FROM_NUMBER(ret, (double)setenv(first_arg_value->string.data, eval_value->string.data, 1));
+				
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in setenv action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in setenv action");
+			}
+			else {STS_ERROR_SIMPLE("setenv action requires at least 2 string arguments"); return NULL;}
+		}
+		ACTION(else if, "sleep") /* sleeps for the number of seconds provided */
+		{
+			#ifdef __unix__
+			struct timespec ts;
+			#endif
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(eval_value->type != STS_NUMBER )
+				{
+					fprintf(stderr, "the sleep action requires a number argument for the number of seconds to sleep\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the sleep action");
+					return NULL;
+				}
+
+				#ifdef __unix__
+				ts.tv_sec = eval_value->number;
+				ts.tv_nsec = fmod(eval_value->number, 1.0) * 1000000000.0;
+				nanosleep(&ts, NULL);
+				#elif defined(WIN32)
+				Sleep(eval_value->number);
+				#else
+				sleep((unsigned int)eval_value->number);
+				#endif
+				VALUE_FROM_NUMBER(ret, 1.0);
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in sleep action");
+			}
+			else {STS_ERROR_SIMPLE("sleep action requires a single number argument"); return NULL;}
+		}
+		ACTION(else if, "json") /* parses json into sts values or outputs a stringified version */
+		{
+			GOTO_SET(&cli_actions);
+			/* parsing from string */
+			if(args->next && !args->next->next)
+			{
+				EVAL_ARG(args->next);
+				if(eval_value->type != STS_STRING )
+				{
+					fprintf(stderr, "the json action, if passed one argument, requires a string\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the json action");
+					return NULL;
+				}
+
+				if(!(ret = sts_value_from_json(script, NULL, eval_value->string.data, eval_value->string.length)))
+				{
+					STS_ERROR_SIMPLE("could not parse json into value");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the json action");
+					return NULL;
+				}
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in json action");
+			}
+			else if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(eval_value->type != STS_NUMBER)
+				{
+					fprintf(stderr, "the json action, if passed two arguments, requires the second to be a number (boolean)\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the json action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the json action");
+					return NULL;
+				}
+
+				memset(&json_output, 0, sizeof(json_output));
+				if(cli_json_output_value(script, &json_output, first_arg_value, eval_value->number, 0) || cli_json_output_reserve(&json_output, 1))
+				{
+					STS_ERROR_SIMPLE("could not create json string from value");
+					if(json_output.data) free(json_output.data);
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the json action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the json action");
+					return NULL;
+				}
+
+				temp_str = json_output.data;
+				temp_str[json_output.length] = 0x0;
+				temp_ulong = json_output.length;
+
+				if(!(ret = sts_value_create(script, STS_STRING)))
+				{
+					STS_ERROR_SIMPLE("could not create sts string for json string");
+					free(temp_str);
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the json action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the json action");
+					return NULL;
+				}
+
+				/* dont duplicate the string the json was built in */
+				ret->string.data = temp_str;
+				ret->string.length = temp_ulong;
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the json action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the json action");
+			}
+			else {STS_ERROR_SIMPLE("json action requires either single string or any value and a number for pretty printing"); return NULL;}
+		}
+		ACTION(else if, "json-write") /* writes a value as json to a file-writer or socket in chunks as it is built. Returns the amount written or -1 (sink, value, optional prettify) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next); first_arg_value = eval_value;
+				EVAL_ARG(args->next->next); second_arg_value = eval_value;
+				if(args->next->next->next) {EVAL_ARG(args->next->next->next); third_arg_value = eval_value;}
+
+				#ifndef CLI_NO_SOCKETS
+				if((!IS_CLI_WRITER(first_arg_value) && !IS_CLI_SOCKET(first_arg_value)) || (third_arg_value && third_arg_value->type != STS_NUMBER))
+				#else
+				if(!IS_CLI_WRITER(first_arg_value) || (third_arg_value && third_arg_value->type != STS_NUMBER))
+				#endif
+				{
+					fprintf(stderr, "the json-write action requires a file-writer or socket, a value, and an optional number for prettify\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in json-write action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in json-write action");
+					if(third_arg_value) if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in json-write action");
+					return NULL;
+				}
+
+				memset(&json_output, 0, sizeof(json_output));
+				if(IS_CLI_WRITER(first_arg_value))
+					json_output.writer = CLI_WRITER(first_arg_value);
+				#ifndef CLI_NO_SOCKETS
+				else
+					json_output.socket = CLI_SOCKET(first_arg_value);
+				#endif
+
+				if(cli_json_output_value(script, &json_output, second_arg_value, third_arg_value ? third_arg_value->number : 0, 0) || cli_json_output_flush(&json_output))
+					VALUE_FROM_NUMBER(ret, -1);
+				else
+					VALUE_FROM_NUMBER(ret, json_output.written);
+
+				if(json_output.data) free(json_output.data);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in json-write action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in json-write action");
+				if(third_arg_value) if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in json-write action");
+			}
+			else {STS_ERROR_SIMPLE("json-write action requires a file-writer or socket and a value"); return NULL;}
+		}
+		ACTION(else if, "json-open-file") /* opens a path, file, or socket for json-get and json-each. Returns nil if the path can't be opened (source, optional lines) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next); first_arg_value = eval_value;
+				if(args->next->next) {EVAL_ARG(args->next->next); second_arg_value = eval_value;}
+
+				#ifndef CLI_NO_SOCKETS
+				if(first_arg_value->type != STS_STRING && !IS_CLI_FILE(first_arg_value) && !IS_CLI_SOCKET(first_arg_value))
+				#else
+				if(first_arg_value->type != STS_STRING && !IS_CLI_FILE(first_arg_value))
+				#endif
+				{
+					fprintf(stderr, "the json-open-file action requires a path, a file, or a socket\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in json-open-file action");
+					if(second_arg_value) if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in json-open-file action");
+					return NULL;
+				}
+
+				temp_uint = second_arg_value && (second_arg_value->type == STS_NUMBER ? second_arg_value->number != 0.0 : second_arg_value->boolean);
+
+				if(first_arg_value->type == STS_STRING)
+				{
+					if((temp_int = open(first_arg_value->string.data, O_RDONLY | O_CLOEXEC)) == -1)
+						VALUE_INIT(ret, STS_NIL);
+					else if(!(work_area = cli_file_new(temp_int, 0)))
+						close(temp_int);
+					else if(!(ret = cli_json_new(script, work_area, NULL, NULL, 0, 0, temp_uint)))
+						cli_file_release(work_area);
+				}
+				else if(IS_CLI_FILE(first_arg_value))
+				{
+					CLI_FILE(first_arg_value)->references++;
+					if(!(ret = cli_json_new(script, CLI_FILE(first_arg_value), NULL, NULL, 0, 0, temp_uint)))
+						cli_file_release(CLI_FILE(first_arg_value));
+				}
+				#ifndef CLI_NO_SOCKETS
+				else
+				{
+					CLI_SOCKET(first_arg_value)->references++;
+					if(!(ret = cli_json_new(script, NULL, CLI_SOCKET(first_arg_value), NULL, 0, 0, temp_uint)))
+						cli_socket_release(CLI_SOCKET(first_arg_value));
+				}
+				#endif
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in json-open-file action");
+				if(second_arg_value) if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in json-open-file action");
+
+				if(!ret)
+				{
+					STS_ERROR_SIMPLE("could not create json handle in json-open-file");
+					return NULL;
+				}
+			}
+			else {STS_ERROR_SIMPLE("json-open-file action requires a path, file, or socket"); return NULL;}
+		}
+		ACTION(else if, "json-open-string") /* opens a string for json-get and json-each (string, optional lines) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next); first_arg_value = eval_value;
+				if(args->next->next) {EVAL_ARG(args->next->next); second_arg_value = eval_value;}
+
+				if(first_arg_value->type != STS_STRING)
+				{
+					fprintf(stderr, "the json-open-string action requires a string\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in json-open-string action");
+					if(second_arg_value) if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in json-open-string action");
+					return NULL;
+				}
+
+				temp_int = second_arg_value && (second_arg_value->type == STS_NUMBER ? second_arg_value->number != 0.0 : second_arg_value->boolean);
+
+				/* the handle keeps its own copy since set can replace the string it came from. A file-map string only shares the mapping */
+				if(first_arg_value->mapped)
+					temp_str = cli_map_share(first_arg_value->string.data);
+				else if((temp_str = malloc(first_arg_value->string.length + 1)))
+					memcpy(temp_str, first_arg_value->string.data, first_arg_value->string.length + 1);
+
+				if(temp_str && !(ret = cli_json_new(script, NULL, NULL, temp_str, first_arg_value->string.length, first_arg_value->mapped, temp_int)))
+				{
+					if(first_arg_value->mapped) cli_map_release(temp_str);
+					else free(temp_str);
+				}
+				temp_str = NULL;
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in json-open-string action");
+				if(second_arg_value) if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in json-open-string action");
+
+				if(!ret)
+				{
+					STS_ERROR_SIMPLE("could not create json handle in json-open-string");
+					return NULL;
+				}
+			}
+			else {STS_ERROR_SIMPLE("json-open-string action requires a string"); return NULL;}
+		}
+		ACTION(else if, "json-get") /* reads the next document of a json handle and returns what is at a path, or an array of what is at each of an array of paths */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next); first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(!IS_CLI_JSON(first_arg_value) || !cli_json_paths_valid(eval_value))
+				{
+					fprintf(stderr, "the json-get action requires a json handle and a string path or an array of them\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in json-get action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in json-get action");
+					return NULL;
+				}
+
+				ret = cli_json_get_paths(script, CLI_JSON(first_arg_value), eval_value);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in json-get action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in json-get action");
+
+				if(!ret)
+				{
+					STS_ERROR_SIMPLE("could not read json in json-get");
+					return NULL;
+				}
+			}
+			else {STS_ERROR_SIMPLE("json-get action requires a json handle and a path"); return NULL;}
+		}
+		ACTION(else if, "json-each") /* returns the next element of the array at a path, or the next document without one. nil at the end (handle, optional path, optional query) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next); first_arg_value = eval_value;
+				if(args->next->next) {EVAL_ARG(args->next->next); second_arg_value = eval_value;}
+				if(second_arg_value && args->next->next->next) {EVAL_ARG(args->next->next->next); third_arg_value = eval_value;}
+
+				if(!IS_CLI_JSON(first_arg_value) || (second_arg_value && second_arg_value->type != STS_STRING && second_arg_value->type != STS_NIL) || (third_arg_value && !cli_json_paths_valid(third_arg_value)))
+				{
+					fprintf(stderr, "the json-each action requires a json handle, an optional string path, and an optional string or array of strings to query each element with\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in json-each action");
+					if(second_arg_value) if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in json-each action");
+					if(third_arg_value) if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in json-each action");
+					return NULL;
+				}
+
+				ret = cli_json_each(script, CLI_JSON(first_arg_value), second_arg_value && second_arg_value->type == STS_STRING ? second_arg_value->string.data : NULL, third_arg_value);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in json-each action");
+				if(second_arg_value) if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in json-each action");
+				if(third_arg_value) if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in json-each action");
+
+				if(!ret)
+				{
+					STS_ERROR_SIMPLE("could not read json in json-each");
+					return NULL;
+				}
+			}
+			else {STS_ERROR_SIMPLE("json-each action requires a json handle"); return NULL;}
+		}
+		#ifndef CLI_NO_SOCKETS
+		ACTION(else if, "socket-tcp") /* creates new tcp socket. args are (port, non_blocking, listening) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next && args->next->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value;
+				EVAL_ARG(args->next->next->next);
+
+				if(first_arg_value->type != STS_NUMBER || second_arg_value->type != STS_NUMBER || eval_value->type != STS_NUMBER)
+				{
+					fprintf(stderr, "the socket-tcp action requires 3 number arguments\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp action");
+					return NULL;
+				}
+
+				if(!(ret = cli_socket_new(script)))
+				{
+					STS_ERROR_SIMPLE("could not create return socket-tcp");
+
+					/* return nil */
+
+					if(!(ret = sts_value_create(script, STS_NIL)))
+						STS_ERROR_SIMPLE("could not create nil socket in socket-tcp");
+					
+
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp action");
+					return ret;
+				}
+
+				if(zed_net_tcp_socket_open(&CLI_SOCKET(ret)->socket, first_arg_value->number, second_arg_value->number, eval_value->number))
+				{
+					STS_ERROR_SIMPLE("could not open socket");
+
+					/* return nil */
+
+					if(!sts_value_reference_decrement(ret, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the old ret in the socket-tcp action");
+
+					if(!(ret = sts_value_create(script, STS_NIL)))
+						STS_ERROR_SIMPLE("could not create nil socket in socket-tcp");
+					
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp action");
+					return ret;
+				}
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp action");
+			}
+			else {STS_ERROR_SIMPLE("socket-tcp action requires 3 arguments"); return NULL;}
+		}
+		ACTION(else if, "socket-udp") /* creates new udp socket. args are (port, non_blocking) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value;
+
+				if(first_arg_value->type != STS_NUMBER || second_arg_value->type != STS_NUMBER)
+				{
+					fprintf(stderr, "the socket-udp action requires 2 number arguments\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp action");
+					return NULL;
+				}
+
+				if(!(ret = cli_socket_new(script)))
+				{
+					STS_ERROR_SIMPLE("could not create return socket-udp");
+
+					/* return nil */
+
+					if(!(ret = sts_value_create(script, STS_NIL)))
+						STS_ERROR_SIMPLE("could not create nil socket in socket-tcp");
+
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp action");
+					return ret;
+				}
+
+				if(zed_net_udp_socket_open(&CLI_SOCKET(ret)->socket, first_arg_value->number, second_arg_value->number))
+				{
+					STS_ERROR_SIMPLE("could not open socket");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp action");
+					return NULL;
+				}
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp action");
+			}
+			else {STS_ERROR_SIMPLE("socket-udp action requires 3 arguments"); return NULL;}
+		}
+		ACTION(else if, "socket-set-broadcast") /* applies SO_BROADCAST socket option, (socket state) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				int opt;
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value;
+
+				if(!IS_CLI_SOCKET(first_arg_value) || second_arg_value->type != STS_NUMBER)
+				{
+					fprintf(stderr, "the socket-set-broadcast action requires a socket argument and state\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-set-broadcast action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-set-broadcast action");
+					return NULL;
+				}
+				
+				opt = second_arg_value->number;
+				if(setsockopt(CLI_SOCKET(first_arg_value)->socket.handle, SOL_SOCKET, SO_BROADCAST, &opt, sizeof(int)))
+					VALUE_FROM_NUMBER(ret, 1);
+				else
+					VALUE_FROM_NUMBER(ret, 0);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-set-broadcast action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-set-broadcast action");
+			}
+			else {STS_ERROR_SIMPLE("socket-set-broadcast action requires 2 arguments"); return NULL;}
+		}
+		ACTION(else if, "socket-set-option") /* sets nodelay, cork, sndbuf, or rcvbuf. Returns nonzero on error (socket, option, value) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next && args->next->next->next)
+			{
+				int opt, level = IPPROTO_TCP, name = -1;
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value;
+				EVAL_ARG(args->next->next->next);
+
+				if(!IS_CLI_SOCKET(first_arg_value) || second_arg_value->type != STS_STRING || eval_value->type != STS_NUMBER)
+				{
+					fprintf(stderr, "the socket-set-option action requires a socket, an option name, and a number\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-set-option action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-set-option action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-set-option action");
+					return NULL;
+				}
+
+				if(!strcmp(second_arg_value->string.data, "nodelay"))
+					name = TCP_NODELAY;
+				#ifdef TCP_CORK
+				else if(!strcmp(second_arg_value->string.data, "cork"))
+					name = TCP_CORK;
+				#endif
+				else if(!strcmp(second_arg_value->string.data, "sndbuf"))
+				{
+					level = SOL_SOCKET;
+					name = SO_SNDBUF;
+				}
+				else if(!strcmp(second_arg_value->string.data, "rcvbuf"))
+				{
+					level = SOL_SOCKET;
+					name = SO_RCVBUF;
+				}
+				else
+					fprintf(stderr, "unknown or unsupported option '%s' in socket-set-option\n", second_arg_value->string.data);
+
+				opt = eval_value->number;
+				if(name == -1 || setsockopt(CLI_SOCKET(first_arg_value)->socket.handle, level, name, (void *)&opt, sizeof(int)))
+					VALUE_FROM_NUMBER(ret, 1);
+				else
+					VALUE_FROM_NUMBER(ret, 0);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-set-option action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-set-option action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-set-option action");
+			}
+			else {STS_ERROR_SIMPLE("socket-set-option action requires 3 arguments"); return NULL;}
+		}
+		ACTION(else if, "socket-tcp-connect") /* connects to tcp server (socket, host, port) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next && args->next->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value;
+				EVAL_ARG(args->next->next->next);
+
+				if(!IS_CLI_SOCKET(first_arg_value) || second_arg_value->type != STS_STRING || eval_value->type != STS_NUMBER)
+				{
+					fprintf(stderr, "the socket-tcp-connect action requires a socket, astring argument for the address, and a number argument for the port\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-connect action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-connect action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp-connect action");
+					return NULL;
+				}
+				
+				temp_uint = 0;
+
+				if(zed_net_get_address(&address, second_arg_value->string.data, eval_value->number))
+				{
+					fprintf(stderr, "could not get the address in socket-tcp-connect: %s\n", zed_net_get_error());
+					temp_uint = 1;
+				}
+				else if(zed_net_tcp_connect(&CLI_SOCKET(first_arg_value)->socket, address))
+				{
+					fprintf(stderr, "could not connect to host in socket-tcp-connect: %s\n", zed_net_get_error());
+					temp_uint = 2;
+				}
+
+				if(!(CLI_SOCKET(first_arg_value)->name = sts_memdup(second_arg_value->string.data, second_arg_value->string.length)))
+				{
+					STS_ERROR_SIMPLE("could not duplicate the host string in socket-tcp-connect");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-connect action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-connect action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp-connect action");
+					return NULL;
+				}
+
+				VALUE_FROM_NUMBER(ret, temp_uint);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-connect action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-connect action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp-connect action");
+			}
+			else {STS_ERROR_SIMPLE("socket-tcp-connect action requires 4 arguments"); return NULL;}
+		}
+		ACTION(else if, "socket-tcp-send") /* sends a string buffer to the host in the socket (socket, data) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(!IS_CLI_SOCKET(first_arg_value) || eval_value->type != STS_STRING)
+				{
+					fprintf(stderr, "the socket-tcp-send action requires a socket and the data to send\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-send action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-send action");
+					return NULL;
+				}
+
+				if(CLI_SOCKET(first_arg_value)->ssl)
+					VALUE_FROM_NUMBER(ret, SSL_write(CLI_SOCKET(first_arg_value)->ssl, eval_value->string.data, eval_value->string.length));
+				else
+					VALUE_FROM_NUMBER(ret, zed_net_tcp_socket_send(&CLI_SOCKET(first_arg_value)->socket, eval_value->string.data, eval_value->string.length));
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-send action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-send action");
+			}
+			else {STS_ERROR_SIMPLE("socket-tcp-send action requires a socket and a data string"); return NULL;}
+		}
+		ACTION(else if, "socket-tcp-sendv") /* sends an array of strings as one without joining them. Returns the amount sent or -1 (socket, array) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				for(i = 0; eval_value->type == STS_ARRAY && i < eval_value->array.length; ++i)
+					if(eval_value->array.data[i]->type != STS_STRING)
+						break;
+
+				if(!IS_CLI_SOCKET(first_arg_value) || eval_value->type != STS_ARRAY || i != eval_value->array.length)
+					fprintf(stderr, "the socket-tcp-sendv action requires a socket and an array of strings\n");
+				else
+					VALUE_FROM_NUMBER(ret, cli_socket_sendv(script, CLI_SOCKET(first_arg_value), eval_value));
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-sendv action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-sendv action");
+
+				if(!ret)
+					return NULL;
+			}
+			else {STS_ERROR_SIMPLE("socket-tcp-sendv action requires a socket and an array of strings"); return NULL;}
+		}
+		ACTION(else if, "socket-tcp-sendfile") /* sends a file without reading it into a string. Returns the amount sent or -1 (socket, path, offset, length) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value;
+				eval_value = NULL;
+
+				if(args->next->next->next)
+				{
+					EVAL_ARG(args->next->next->next);
+					third_arg_value = eval_value;
+					eval_value = NULL;
+
+					if(args->next->next->next->next)
+						EVAL_ARG(args->next->next->next->next);
+				}
+
+				if(!IS_CLI_SOCKET(first_arg_value) || second_arg_value->type != STS_STRING || (third_arg_value && third_arg_value->type != STS_NUMBER) || (eval_value && eval_value->type != STS_NUMBER))
+					fprintf(stderr, "the socket-tcp-sendfile action requires a socket, a path, and optionally an offset and length\n");
+				else
+					VALUE_FROM_NUMBER(ret, cli_socket_sendfile(script, CLI_SOCKET(first_arg_value), second_arg_value->string.data, third_arg_value ? (long)third_arg_value->number : 0, eval_value ? (long)eval_value->number : -1));
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-sendfile action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-sendfile action");
+				if(third_arg_value && !sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp-sendfile action");
+				if(eval_value && !sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the fourth argument in the socket-tcp-sendfile action");
+
+				if(!ret)
+					return NULL;
+			}
+			else {STS_ERROR_SIMPLE("socket-tcp-sendfile action requires a socket and a path"); return NULL;}
+		}
+		ACTION(else if, "socket-tcp-recv") /* returns a string of data from the socket. ret of 1 means would block, -1 means error, string is data */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+
+				if(!IS_CLI_SOCKET(eval_value))
+				{
+					fprintf(stderr, "the socket-tcp-recv action requires a socket and the data to send\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+					return NULL;
+				}
+
+				/* anything the socket-read-* functions buffered comes first */
+				if(CLI_SOCKET(eval_value)->buffer.end != CLI_SOCKET(eval_value)->buffer.start)
+				{
+					ret = cli_socket_read(script, CLI_SOCKET(eval_value), NULL, 0, CLI_SOCKET(eval_value)->buffer.end - CLI_SOCKET(eval_value)->buffer.start);
+
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+
+					return ret;
+				}
+
+				/* a blocking socket lets the other coroutines run while it waits */
+				if(!CLI_SOCKET(eval_value)->socket.non_blocking && !CLI_SOCKET(eval_value)->ssl)
+					cli_coroutine_wait_fd(script, CLI_SOCKET(eval_value)->socket.handle, POLLIN);
+
+				/* first check if it would block and return a 1 instead of a string */
+
+				if(cli_socket_would_block(CLI_SOCKET(eval_value)) == 1)
+				{
+					if(!(ret = sts_value_from_number(script, 1)))
+					{
+						STS_ERROR_SIMPLE("could not create number retval in socket-tcp-recv");
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+						return NULL;
+					}
+
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+
+					return ret;
+				}
+
+				do
+				{
+					if(cli_socket_would_block(CLI_SOCKET(eval_value)))
+						break;
+
+					if(CLI_SOCKET(eval_value)->ssl)
+						temp_int = SSL_read(CLI_SOCKET(eval_value)->ssl, buf, sizeof(buf));
+					else
+						temp_int = zed_net_tcp_socket_receive(&CLI_SOCKET(eval_value)->socket, buf, sizeof(buf));
+					
+					if(temp_int <= 0)
+					 break;
+
+					/* this is bad, but this whole project is for personal use primarily */
+					if(!(temp_str = realloc(temp_str, temp_ulong + temp_int + 1)))
+					{
+						STS_ERROR_SIMPLE("could not resize temporary buffer in socket-tcp-recv");
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+						return NULL;
+					}
+
+					memcpy(&temp_str[temp_ulong], buf, temp_int);
+
+					temp_ulong += temp_int;
+					temp_str[temp_ulong] = 0x0;
+				} while(temp_int == sizeof(buf));
+
+
+				/* return a number instead of a string */
+				if(temp_int == -1)
+				{
+					if(!(ret = sts_value_from_number(script, -1)))
+					{
+						STS_ERROR_SIMPLE("could not create number retval in socket-tcp-recv");
+						if(temp_str) free(temp_str);
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+						return NULL;
+					}
+
+					if(temp_str) free(temp_str);
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+
+					return ret;
+				}
+				/* create a string with the recieved data */
+				else if(temp_uint != -1 && !(ret = sts_value_create(script, STS_STRING)))
+				{
+					STS_ERROR_SIMPLE("could not create string retval in socket-tcp-recv");
+					if(temp_str) free(temp_str);
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+					return NULL;
+				}
+
+				if(temp_str)
+				{
+					ret->string.length = temp_ulong;
+					ret->string.data = temp_str;
+				}
+				else
+				{
+					ret->string.length = 0;
+					ret->string.data = sts_memdup("", 0);
+				}
+				
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+			}
+			else {STS_ERROR_SIMPLE("socket-tcp-send action requires a socket"); return NULL;}
+		}
+		ACTION(else if, "socket-udp-send") /* sends a string buffer to the host in the socket (socket, destination address, destination port, data) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next && args->next->next->next  && args->next->next->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value;
+				EVAL_ARG(args->next->next->next);
+				third_arg_value = eval_value;
+				EVAL_ARG(args->next->next->next->next);
+
+				if(!IS_CLI_SOCKET(first_arg_value) || second_arg_value->type != STS_STRING || third_arg_value->type != STS_NUMBER || eval_value->type != STS_STRING)
+				{
+					fprintf(stderr, "the socket-udp-send action requires a socket, the destination, destination port, and the data to send\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-send action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp-send action");
+					if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-udp-send action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the fourth argument in the socket-udp-send action");
+					return NULL;
+				}
+
+				if(zed_net_get_address(&address, second_arg_value->string.data, third_arg_value->number))
+				{
+					fprintf(stderr, "could not get the address in socket-udp-send: %s\n", zed_net_get_error());
+					VALUE_FROM_NUMBER(ret, -1);
+				}
+				else
+					VALUE_FROM_NUMBER(ret, zed_net_udp_socket_send(&CLI_SOCKET(first_arg_value)->socket, address, eval_value->string.data, eval_value->string.length));
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-send action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp-send action");
+				if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-udp-send action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the fourth argument in the socket-udp-send action");
+			}
+			else {STS_ERROR_SIMPLE("socket-udp-send action requires a socket and a data string"); return NULL;}
+		}
+		ACTION(else if, "socket-udp-recv") /* returns a string of data from the socket. ret of 1 means would block, -1 means error, string is data */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+
+				if(!IS_CLI_SOCKET(eval_value))
+				{
+					fprintf(stderr, "the socket-udp-recv action requires a socket and the data to send\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
+					return NULL;
+				}
+
+				/* a blocking socket lets the other coroutines run while it waits */
+				if(!CLI_SOCKET(eval_value)->socket.non_blocking)
+					cli_coroutine_wait_fd(script, CLI_SOCKET(eval_value)->socket.handle, POLLIN);
+
+				/* first check if it would block and return a 1 instead of a string */
+
+				if(cli_socket_would_block(CLI_SOCKET(eval_value)) == 1)
+				{
+					if(!(ret = sts_value_from_number(script, 1)))
+					{
+						STS_ERROR_SIMPLE("could not create number retval in socket-udp-recv");
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
+						return NULL;
+					}
+
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
+
+					return ret;
+				}
+
+				do
+				{
+					if(cli_socket_would_block(CLI_SOCKET(eval_value)))
+						break;
+
+					temp_int = zed_net_udp_socket_receive(&CLI_SOCKET(eval_value)->socket, &address, buf, sizeof(buf));
+					
+					if(temp_int <= 0)
+					 break;
+
+					/* this is bad, but this whole project is for personal use primarily */
+					if(!(temp_str = realloc(temp_str, temp_ulong + temp_int + 1)))
+					{
+						STS_ERROR_SIMPLE("could not resize temporary buffer in socket-udp-recv");
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
+						return NULL;
+					}
+
+					memcpy(&temp_str[temp_ulong], buf, temp_int);
+
+					temp_ulong += temp_int;
+					temp_str[temp_ulong] = 0x0;
+				} while(temp_int == sizeof(buf));
+
+
+				/* return a number instead of a string */
+				if(temp_int == -1)
+				{
+					if(!(ret = sts_value_from_number(script, -1)))
+					{
+						STS_ERROR_SIMPLE("could not create number retval in socket-udp-recv");
+						if(temp_str) free(temp_str);
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
+						return NULL;
+					}
+
+					if(temp_str) free(temp_str);
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
+
+					return ret;
+				}
+				/* create a string with the recieved data */
+				else if(temp_uint != -1 && !(ret = sts_value_create(script, STS_STRING)))
+				{
+					STS_ERROR_SIMPLE("could not create string retval in socket-udp-recv");
+					if(temp_str) free(temp_str);
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
+					return NULL;
+				}
+
+				if(temp_str)
+				{
+					ret->string.length = temp_ulong;
+					ret->string.data = temp_str;
+				}
+				else
+				{
+					ret->string.length = 0;
+					ret->string.data = sts_memdup("", 0);
+				}
+				
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
 			}
-			else
+			else {STS_ERROR_SIMPLE("socket-tcp-send action requires a socket"); return NULL;}
+		}
+		ACTION(else if, "socket-udp-recv-batch") /* returns an array of up to max [address port data] arrays. ret of 1 means would block, -1 means error (socket, max) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
 			{
-				fprintf(stderr, "could not execute command provided\n");
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(!IS_CLI_SOCKET(first_arg_value) || eval_value->type != STS_NUMBER || eval_value->number < 1.0)
+				{
+					fprintf(stderr, "the socket-udp-recv-batch action requires a socket and the most datagrams to receive\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv-batch action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp-recv-batch action");
+					return NULL;
+				}
+
+				/* also keeps huge numbers from overflowing the conversion */
+				if(!(ret = cli_socket_recv_batch(script, CLI_SOCKET(first_arg_value), eval_value->number > CLI_UDP_BATCH_MAX ? CLI_UDP_BATCH_MAX : (unsigned int)eval_value->number)))
+				{
+					STS_ERROR_SIMPLE("could not create retval in socket-udp-recv-batch");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv-batch action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp-recv-batch action");
+					return NULL;
+				}
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv-batch action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp-recv-batch action");
+			}
+			else {STS_ERROR_SIMPLE("socket-udp-recv-batch action requires a socket and the most datagrams to receive"); return NULL;}
+		}
+		ACTION(else if, "socket-udp-send-batch") /* sends an array of [address port data] arrays. Returns how many were sent or -1 (socket, datagrams) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(IS_CLI_SOCKET(first_arg_value) && eval_value->type == STS_ARRAY)
+					for(i = 0; i < eval_value->array.length; ++i)
+					{
+						temp_value = eval_value->array.data[i];
+
+						if(temp_value->type != STS_ARRAY || temp_value->array.length < 3 || temp_value->array.data[0]->type != STS_STRING || temp_value->array.data[1]->type != STS_NUMBER || temp_value->array.data[2]->type != STS_STRING)
+							break;
+					}
+
+				if(!IS_CLI_SOCKET(first_arg_value) || eval_value->type != STS_ARRAY || i != eval_value->array.length)
+				{
+					fprintf(stderr, "the socket-udp-send-batch action requires a socket and an array of [address port data] arrays\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-send-batch action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp-send-batch action");
+					return NULL;
+				}
+
+				VALUE_FROM_NUMBER(ret, cli_socket_send_batch(script, CLI_SOCKET(first_arg_value), eval_value));
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-send-batch action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp-send-batch action");
+			}
+			else {STS_ERROR_SIMPLE("socket-udp-send-batch action requires a socket and an array of datagrams"); return NULL;}
+		}
+		ACTION(else if, "socket-tcp-would-block") /* tests if a socket will block */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+
+				if(!IS_CLI_SOCKET(eval_value))
+				{
+					fprintf(stderr, "the socket-tcp-would-block action requires a socket\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-would-block action");
+					return NULL;
+				}
+
+				VALUE_FROM_NUMBER(ret, cli_socket_would_block(CLI_SOCKET(eval_value)));
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-would-block action");
+			}
+			else {STS_ERROR_SIMPLE("socket-tcp-would-block action requires a socket"); return NULL;}
+		}
+		ACTION(else if, "socket-read-line") /* returns the next line without the newline. ret of 1 means would block, -1 means error or closed */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+
+				if(!IS_CLI_SOCKET(eval_value))
+				{
+					fprintf(stderr, "the socket-read-line action requires a socket\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-read-line action");
+					return NULL;
+				}
+
+				if((ret = cli_socket_read(script, CLI_SOCKET(eval_value), "\n", 1, 0)) && ret->type == STS_STRING && ret->string.length && ret->string.data[ret->string.length - 1] == '\r')
+					ret->string.data[--ret->string.length] = 0x0;
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-read-line action");
+
+				if(!ret)
+					return NULL;
+			}
+			else {STS_ERROR_SIMPLE("socket-read-line action requires a socket"); return NULL;}
+		}
+		ACTION(else if, "socket-read-n") /* returns exactly n bytes unless the socket closes first. ret of 1 means would block, -1 means error or closed (socket, n) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(!IS_CLI_SOCKET(first_arg_value) || eval_value->type != STS_NUMBER || eval_value->number < 1.0)
+					fprintf(stderr, "the socket-read-n action requires a socket and a number of bytes\n");
+				else
+					ret = cli_socket_read(script, CLI_SOCKET(first_arg_value), NULL, 0, (unsigned long)eval_value->number);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-read-n action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-read-n action");
+
+				if(!ret)
+					return NULL;
+			}
+			else {STS_ERROR_SIMPLE("socket-read-n action requires a socket and a number of bytes"); return NULL;}
+		}
+		ACTION(else if, "socket-read-until") /* returns everything before the delimiter and drops the delimiter. ret of 1 means would block, -1 means error or closed (socket, delim) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(!IS_CLI_SOCKET(first_arg_value) || eval_value->type != STS_STRING || !eval_value->string.length)
+					fprintf(stderr, "the socket-read-until action requires a socket and a delimiter string\n");
+				else
+					ret = cli_socket_read(script, CLI_SOCKET(first_arg_value), eval_value->string.data, eval_value->string.length, 0);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-read-until action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-read-until action");
+
+				if(!ret)
+					return NULL;
+			}
+			else {STS_ERROR_SIMPLE("socket-read-until action requires a socket and a delimiter string"); return NULL;}
+		}
+		ACTION(else if, "socket-set-recv-buffer") /* sets how much the socket-read-* functions read at once (socket, size) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(!IS_CLI_SOCKET(first_arg_value) || eval_value->type != STS_NUMBER || eval_value->number < 1.0)
+					fprintf(stderr, "the socket-set-recv-buffer action requires a socket and a size\n");
+				else
+				{
+					temp_ulong = (unsigned long)eval_value->number;
+
+					/* never smaller than what is already buffered */
+					if(CLI_SOCKET(first_arg_value)->buffer.data)
+					{
+						if(temp_ulong < CLI_SOCKET(first_arg_value)->buffer.end - CLI_SOCKET(first_arg_value)->buffer.start)
+							temp_ulong = CLI_SOCKET(first_arg_value)->buffer.end - CLI_SOCKET(first_arg_value)->buffer.start;
+
+						memmove(CLI_SOCKET(first_arg_value)->buffer.data, &CLI_SOCKET(first_arg_value)->buffer.data[CLI_SOCKET(first_arg_value)->buffer.start], CLI_SOCKET(first_arg_value)->buffer.end - CLI_SOCKET(first_arg_value)->buffer.start);
+						CLI_SOCKET(first_arg_value)->buffer.end -= CLI_SOCKET(first_arg_value)->buffer.start;
+						CLI_SOCKET(first_arg_value)->buffer.start = 0;
+
+						if((temp_str = realloc(CLI_SOCKET(first_arg_value)->buffer.data, temp_ulong)))
+							CLI_SOCKET(first_arg_value)->buffer.data = temp_str;
+						else
+							temp_ulong = CLI_SOCKET(first_arg_value)->buffer.size;
+
+						temp_str = NULL;
+					}
+
+					CLI_SOCKET(first_arg_value)->buffer.size = temp_ulong;
+					VALUE_FROM_NUMBER(ret, temp_ulong);
+				}
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-set-recv-buffer action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-set-recv-buffer action");
+
+				if(!ret)
+					return NULL;
 			}
+			else {STS_ERROR_SIMPLE("socket-set-recv-buffer action requires a socket and a size"); return NULL;}
+		}
+		ACTION(else if, "socket-tcp-accept") /* returns a socket upon connection (socket, out_client_socket) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(!IS_CLI_SOCKET(first_arg_value))
+				{
+					fprintf(stderr, "the socket-tcp-accept action requires a socket\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-accept action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-accept action");
+					return NULL;
+				}
+
+				if(!(temp_value = cli_socket_new(script)))
+				{
+					STS_ERROR_SIMPLE("could not create return socket");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-accept action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-accept action");
+					return NULL;
+				}
+
+				if(!CLI_SOCKET(first_arg_value)->socket.non_blocking)
+					cli_coroutine_wait_fd(script, CLI_SOCKET(first_arg_value)->socket.handle, POLLIN);
+
+				if((temp_int = zed_net_tcp_accept(&CLI_SOCKET(first_arg_value)->socket, &CLI_SOCKET(temp_value)->socket, &address)))
+				{
+					if(!sts_value_reference_decrement(script, temp_value)) STS_ERROR_SIMPLE("could not decrement references for the old temp value in the socket-tcp-accept action");
+
+					/* just dont touch the outsocket value */
+				}
+				else
+				{
+					/* set the 2nd arg reference to the new socket */
+
+					if(sts_value_copy(script, eval_value, temp_value, 0))
+					{
+						STS_ERROR_SIMPLE("could not set outsock to the client socket");
+						if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-accept action");
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-accept action");
+						return NULL;
+					}
+
+					if(!sts_value_reference_decrement(script, temp_value)) STS_ERROR_SIMPLE("could not decrement references for the old temp value in the socket-tcp-accept action");
+				}
+
+				VALUE_FROM_NUMBER(ret, temp_int);
 
-			free(temp_str);
-			if(!sts_value_reference_decrement(script, first_arg_value))
-				STS_ERROR_SIMPLE("could not decrement references for first argument in pipeout action");
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-would-block action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-would-block action");
+			}
+			else {STS_ERROR_SIMPLE("socket-tcp-accept action requires a socket and out_socket which is passed byref"); return NULL;}
 		}
-		ACTION(else if, "file-read") /* reads files into a string */
+		ACTION(else if, "socket-enable-ssl-client") /* handshake with server */
 		{
 			GOTO_SET(&cli_actions);
 			if(args->next)
 			{
 				EVAL_ARG(args->next);
-				if(eval_value->type != STS_STRING)
+				if(!IS_CLI_SOCKET(eval_value))
 				{
-					fprintf(stderr, "the file-read action requires a string argument for the path\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-read action");
+					STS_ERROR_SIMPLE("socket-enable-ssl-client: arg0 isnt socket");
+					sts_value_reference_decrement(script, eval_value);
 					return NULL;
 				}
 
-				if(!(file = fopen(eval_value->string.data, "rb")))
+				if(!(CLI_SOCKET(eval_value)->ssl = SSL_CTX_new(SSLv3_client_method())))
 				{
-					VALUE_INIT(ret, STS_NIL);
+					STS_ERROR_SIMPLE("socket-enable-ssl-client: ubable to init ssl");
+					++temp_uint;
 				}
-				else
-				{
-					fseek(file, 0, SEEK_END);
-					temp_uint = ftell(file);
-					fseek(file, 0, SEEK_SET);
-
-					if(!(temp_str = calloc(temp_uint + 1, sizeof(char))))
-					{
-						fprintf(stderr, "could not alocate string in read-file\n");
-						VALUE_INIT(ret, STS_NIL);
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-read action");
-						return ret;
-					}
-					
-					if(fread(temp_str, temp_uint, sizeof(char), file) <= 0)
-					{
-						fprintf(stderr, "could not read file in read-file\n");
-					}
-
-					VALUE_INIT(ret, STS_STRING);
-					ret->string.data = temp_str;
-					ret->string.length = temp_uint;
 
-					fclose(file);
+				if(SSL_set_fd(CLI_SOCKET(eval_value)->ssl, CLI_SOCKET(eval_value)->socket.handle) != 1)
+				{
+					STS_ERROR_SIMPLE("socket-enable-ssl-client: unable to set fd");
+					++temp_uint;
+				}
+				if(tls_sni_set(CLI_SOCKET(eval_value)->ssl, CLI_SOCKET(eval_value)->name) != 1)
+				{
+					STS_ERROR_SIMPLE("socket-enable-ssl-client: unable to set sni");
+					++temp_uint;
+				}
+				if(SSL_connect(CLI_SOCKET(eval_value)->ssl) != 1)
+				{
+					STS_ERROR_SIMPLE("socket-enable-ssl-client: unable to handshake");
+					++temp_uint;
 				}
 
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-read action");
+				VALUE_FROM_NUMBER(ret, temp_uint);
+
+				if(!sts_value_reference_decrement(script, eval_value))
+					STS_ERROR_SIMPLE("socket-enable-ssl-client: argument isnt socket");
 			}
-			else {STS_ERROR_SIMPLE("file-read action requires a single string path argument"); return NULL;}
+			else {STS_ERROR_SIMPLE("socket-enable-ssl-client expects socket"); return NULL;}
 		}
-		ACTION(else if, "file-write") /* writes a string to a file */
+		#ifndef CLI_NO_POLLER
+		ACTION(else if, "poller-new") /* creates a poller that waits on many sockets and watches at once */
 		{
 			GOTO_SET(&cli_actions);
-			if(args->next && args->next->next)
+
+			if(!(ret = cli_poller_new(script)))
+				return NULL;
+		}
+		ACTION(else if, "poller-add") /* registers a socket or watch, or changes what a socket is registered for. Watches ignore events. Returns nonzero on error (poller, socket, events) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next && args->next->next->next)
 			{
-				EVAL_ARG(args->next); first_arg_value = eval_value;
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
 				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value;
+				EVAL_ARG(args->next->next->next);
 
-				if(first_arg_value->type != STS_STRING && eval_value->type != STS_STRING)
+				if(!IS_CLI_POLLER(first_arg_value) || !IS_CLI_POLLABLE(second_arg_value) || eval_value->type != STS_STRING)
 				{
-					fprintf(stderr, "file-write requires 2 string arguments only\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in file-write action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-write action");
+					fprintf(stderr, "the poller-add action requires a poller, a socket or watch, and a string of events\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the poller-add action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the poller-add action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the poller-add action");
 					return NULL;
 				}
 
-				if(!(file = fopen(first_arg_value->string.data, "wb")))
-				{
-					VALUE_INIT(ret, STS_NIL);
-				}
+				#ifndef CLI_NO_WATCH
+				if(IS_CLI_WATCH(second_arg_value))
+					temp_int = cli_poller_register_watch(CLI_POLLER(first_arg_value), CLI_WATCH(second_arg_value));
 				else
-				{
-					VALUE_FROM_NUMBER(ret, fwrite(eval_value->string.data, sizeof(char), eval_value->string.length, file));
-					fclose(file);
-				}
-				
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in file-write action");
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-write action");
+				#endif
+					temp_int = cli_poller_register(CLI_POLLER(first_arg_value), CLI_SOCKET(second_arg_value), cli_poller_events_from_string(eval_value->string.data));
+
+				VALUE_FROM_NUMBER(ret, temp_int);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the poller-add action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the poller-add action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the poller-add action");
 			}
-			else {STS_ERROR_SIMPLE("file-write action requires at least 2 string arguments"); return NULL;}
+			else {STS_ERROR_SIMPLE("poller-add action requires a poller, a socket or watch, and a string of events"); return NULL;}
 		}
-		ACTION(else if, "file-append") /* appends a string to a file */
+		ACTION(else if, "poller-remove") /* unregisters a socket or watch from whatever poller it is in */
 		{
 			GOTO_SET(&cli_actions);
-			if(args->next && args->next->next)
+			if(args->next)
 			{
-				EVAL_ARG(args->next); first_arg_value = eval_value;
-				EVAL_ARG(args->next->next);
+				EVAL_ARG(args->next);
 
-				if(first_arg_value->type != STS_STRING && eval_value->type != STS_STRING)
+				if(!IS_CLI_POLLABLE(eval_value))
 				{
-					fprintf(stderr, "file-append requires 2 string arguments only\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in file-append action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-append action");
+					fprintf(stderr, "the poller-remove action requires a socket or watch\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the poller-remove action");
 					return NULL;
 				}
 
-				if(!(file = fopen(first_arg_value->string.data, "ab")))
+				#ifndef CLI_NO_WATCH
+				if(IS_CLI_WATCH(eval_value))
 				{
-					VALUE_INIT(ret, STS_NIL);
+					if(CLI_WATCH(eval_value)->poller)
+						cli_poller_unregister_watch(CLI_WATCH(eval_value));
 				}
 				else
-				{
-					VALUE_FROM_NUMBER(ret, fwrite(eval_value->string.data, sizeof(char), eval_value->string.length, file));
-					fclose(file);
-				}
-				
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in file-append action");
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in file-append action");
+				#endif
+				if(CLI_SOCKET(eval_value)->poller)
+					cli_poller_unregister(CLI_SOCKET(eval_value));
+
+				VALUE_FROM_NUMBER(ret, 0);
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the poller-remove action");
 			}
-			else {STS_ERROR_SIMPLE("file-append action requires at least 2 string arguments"); return NULL;}
+			else {STS_ERROR_SIMPLE("poller-remove action requires a socket or watch"); return NULL;}
 		}
-		ACTION(else if, "stdin-read") /* if <=0, it reads until eof. If >0, it will read at least that many characters */
+		ACTION(else if, "poller-wait") /* returns an array of the sockets and watches that are ready, waiting up to timeout milliseconds. -1 waits forever (poller, timeout) */
 		{
 			GOTO_SET(&cli_actions);
-			if(args->next)
+			if(args->next && args->next->next)
 			{
 				EVAL_ARG(args->next);
-				if(eval_value->type != STS_NUMBER && eval_value->type != STS_STRING)
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+
+				if(!IS_CLI_POLLER(first_arg_value) || eval_value->type != STS_NUMBER)
 				{
-					fprintf(stderr, "the stdin-read action requires a number argument for the amount to read or a character (single char long string) for the character to read until\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the stdin-read action");
+					fprintf(stderr, "the poller-wait action requires a poller and a timeout\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the poller-wait action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the poller-wait action");
 					return NULL;
 				}
 
-				if(eval_value->type == STS_NUMBER)
+				poller = CLI_POLLER(first_arg_value);
+				temp_uint = poller->count ? poller->count : 1;
+
+				if(temp_uint > poller->events_allocated)
 				{
-					while((size = fread(buf, 1, ((unsigned int)eval_value->number <= 0) ? sizeof(buf) : (unsigned int)eval_value->number, stdin)) > 0)
+					if(!(work_area = realloc(poller->events, sizeof(struct epoll_event) * temp_uint)))
+						STS_ERROR_SIMPLE("could not resize poller events");
+					else
 					{
-						if(!(temp_str = realloc(temp_str, total + size + 1)))
-						{
-							fprintf(stderr, "could not resize stdin buffer\n");
-							break;
-						}
+						poller->events = work_area;
+						poller->events_allocated = temp_uint;
+					}
 
-						memmove(&temp_str[total], buf, size);
-						total += size;
-						temp_str[total] = 0x0;
+					work_area = NULL;
+				}
 
-						if(eval_value->number > 0 && total == eval_value->number)
-							break;
-					}
+				/* the other coroutines keep running while this would block. Buffered sockets are ready already */
+				if(eval_value->number < 0.0 && !poller->buffered)
+					cli_coroutine_wait_fd(script, poller->fd, POLLIN);
+
+				if(poller->events_allocated && (temp_int = epoll_wait(poller->fd, poller->events, poller->events_allocated, poller->buffered ? 0 : (int)eval_value->number)) == -1)
+				{
+					if(errno != EINTR)
+						fprintf(stderr, "epoll_wait failed in poller-wait\n");
+					temp_int = 0;
 				}
-				else
+
+				if((ret = sts_value_create(script, STS_ARRAY)))
 				{
-					while((size = fread(buf, 1, 1, stdin)) > 0)
+					/* their fd may not be readable anymore, so they are added here and skipped below */
+					for(polled = poller->buffered ? poller->sockets : NULL; polled; polled = polled->poller_next)
 					{
-						if(!(temp_str = realloc(temp_str, total + size + 1))) /* not very quick */
-						{
-							fprintf(stderr, "could not resize stdin buffer\n");
+						if(!polled->buffered)
+							continue;
+
+						polled->ready_events = EPOLLIN;
+
+						if(!(temp_value = cli_socket_value(script, polled)))
 							break;
+
+						sts_array_append_insert(script, ret, temp_value, ret->array.length);
+					}
+
+					for(i = 0; i < temp_int; ++i)
+					{
+						#ifndef CLI_NO_WATCH
+						if(poller->events[i].data.u64 & CLI_POLLER_WATCH_TAG)
+						{
+							if(!(temp_value = cli_watch_value(script, (cli_watch_t *)(uintptr_t)(poller->events[i].data.u64 & ~(uint64_t)CLI_POLLER_WATCH_TAG))))
+								break;
+
+							sts_array_append_insert(script, ret, temp_value, ret->array.length);
+							continue;
 						}
+						#endif
 
-						memmove(&temp_str[total], buf, size);
-						total += size;
-						temp_str[total] = 0x0;
+						polled = poller->events[i].data.ptr;
 
-						if(*eval_value->string.data == temp_str[total - 1])
+						if(polled->buffered)
 						{
-							temp_str[total - 1] = 0x0;
-							break;
+							polled->ready_events |= poller->events[i].events;
+							continue;
 						}
+
+						polled->ready_events = poller->events[i].events;
+
+						if(!(temp_value = cli_socket_value(script, polled)))
+							break;
+
+						sts_array_append_insert(script, ret, temp_value, ret->array.length);
 					}
 				}
 
-				VALUE_INIT(ret, STS_STRING);
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the poller-wait action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the poller-wait action");
 
-				ret->string.data = temp_str;
-				ret->string.length = total;
-
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in stdin-read action");
+				if(!ret)
+					return NULL;
 			}
-			else {STS_ERROR_SIMPLE("stdin-read action requires a single string path argument"); return NULL;}
+			else {STS_ERROR_SIMPLE("poller-wait action requires a poller and a timeout"); return NULL;}
 		}
-		ACTION(else if, "stdout-write") /* writes raw strings to stdout */
+		ACTION(else if, "socket-ready-events") /* returns "r", "w", "rw", or "" for what the last poller-wait found the socket ready for */
 		{
 			GOTO_SET(&cli_actions);
-			ACTION_BEGIN_ARGLOOP
-				switch(eval_value->type)
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+
+				if(!IS_CLI_SOCKET(eval_value))
 				{
-					case STS_NUMBER: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%1.17g", eval_value->number, " ", 0); break;
-					case STS_NIL: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%s", "nil", " ", 0); break;
-					case STS_ARRAY: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "[array passed and is %u elements long]", eval_value->array.length,  " ", 0); break;
-					case STS_STRING: STS_STRING_ASSEMBLE(temp_str, temp_uint, eval_value->string.data, eval_value->string.length, " ", 0); break;
-					case STS_EXTERNAL: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%p", eval_value->external.data_ptr, " ", 0); break;
-					case STS_FUNCTION: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "[function passed and it takes %u arguments]", eval_value->function.argument_identifiers->array.length, " ", 0); break;
-					case STS_BOOLEAN: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%s", eval_value->boolean ? "true" : "false", " ", 0); break;
+					fprintf(stderr, "the socket-ready-events action requires a socket\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-ready-events action");
+					return NULL;
 				}
-			ACTION_END_ARGLOOP
-			for(i = 0; i < temp_uint; ++i)
-				fputc(temp_str[i], stdout);
-			STS_FREE(temp_str);
-			VALUE_FROM_NUMBER(ret, 1);
+
+				i = 0;
+				if(CLI_SOCKET(eval_value)->ready_events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+					buf[i++] = 'r';
+				if(CLI_SOCKET(eval_value)->ready_events & EPOLLOUT)
+					buf[i++] = 'w';
+				buf[i] = 0x0;
+
+				if(!(ret = sts_value_from_string(script, buf)))
+					STS_ERROR_SIMPLE("could not create string in socket-ready-events");
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-ready-events action");
+
+				if(!ret)
+					return NULL;
+			}
+			else {STS_ERROR_SIMPLE("socket-ready-events action requires a socket"); return NULL;}
 		}
-		ACTION(else if, "stderr-write") /* writes raw strings to stderr */
+		#endif /* CLI_NO_POLLER */
+		#endif /* CLI_NO_SOCKETS */
+		ACTION(else if, "crypto-argon2i") /* hashes a string with salt and returns the hash string buffer */
 		{
 			GOTO_SET(&cli_actions);
-			ACTION_BEGIN_ARGLOOP
-				switch(eval_value->type)
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value; /* password str */
+				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value; /* salt str */
+				EVAL_ARG(args->next->next->next);
+				third_arg_value = eval_value; /* number of blocks in work area */
+				EVAL_ARG(args->next->next->next->next); /* number of iterations */
+				
+
+				if(first_arg_value->type != STS_STRING || second_arg_value->type != STS_STRING || third_arg_value->type != STS_NUMBER || eval_value->type != STS_NUMBER)
 				{
-					case STS_NUMBER: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%1.17g", eval_value->number, " ", 0); break;
-					case STS_NIL: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%s", "nil", " ", 0); break;
-					case STS_ARRAY: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "[array passed and is %u elements long]", eval_value->array.length,  " ", 0); break;
-					case STS_STRING: STS_STRING_ASSEMBLE(temp_str, temp_uint, eval_value->string.data, eval_value->string.length, " ", 0); break;
-					case STS_EXTERNAL: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%p", eval_value->external.data_ptr, " ", 0); break;
-					case STS_FUNCTION: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "[function passed and it takes %u arguments]", eval_value->function.argument_identifiers->array.length, " ", 0); break;
-					case STS_BOOLEAN: STS_STRING_ASSEMBLE_FMT(temp_str, temp_uint, "%s", eval_value->boolean ? "true" : "false", " ", 0); break;
+					fprintf(stderr, "the crypto-argon2i action requires a string, string, number, and a final number\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					return NULL;
+				}
+
+				if(!(ret = sts_value_create(script, STS_STRING)))
+				{
+					fprintf(stderr, "could not create return string in crypto-argon2i action\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					return NULL;
+				}
+
+				/* made output hashes 32 bytes instead of 64 because it may be useful to sign messages with it as well. Might be a bad idea, but you would have to know the salt. We'll see */
+				if(!(ret->string.data = malloc(32 + 1)))
+				{
+					fprintf(stderr, "could not create return string data in crypto-argon2i action\n");
+					free(ret);
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					return NULL;
+				}
+
+				ret->string.data[32] = 0;
+				ret->string.length = 32;
+
+				if(!(work_area = malloc(third_arg_value->number * 1024)))
+				{
+					fprintf(stderr, "could not work area in crypto-argon2i action\n");
+					sts_value_reference_decrement(script, ret);
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					return NULL;
 				}
-			ACTION_END_ARGLOOP
-			for(i = 0; i < temp_uint; ++i)
-				fputc(temp_str[i], stderr);
-			STS_FREE(temp_str);
-			VALUE_FROM_NUMBER(ret, 1);
+
+				crypto_argon2i(ret->string.data, ret->string.length, work_area, third_arg_value->number, eval_value->number, first_arg_value->string.data, first_arg_value->string.length, second_arg_value->string.data, second_arg_value->string.length);
+
+				free(work_area);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+				if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+			}
+			else {STS_ERROR_SIMPLE("crypto-argon2i action requires a string, string, number, and number"); return NULL;}
 		}
-		ACTION(else if, "getenv") /* gets a string from the system shell environment */
+		ACTION(else if, "crypto-argon2i-async") /* same as crypto-argon2i, but runs on the thread pool and returns a future right away */
 		{
 			GOTO_SET(&cli_actions);
-			if(args->next)
+			if(args->next && args->next->next && args->next->next->next && args->next->next->next->next)
 			{
 				EVAL_ARG(args->next);
-				if(eval_value->type != STS_STRING)
+				first_arg_value = eval_value; /* password str */
+				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value; /* salt str */
+				EVAL_ARG(args->next->next->next);
+				third_arg_value = eval_value; /* number of blocks in work area */
+				EVAL_ARG(args->next->next->next->next); /* number of iterations */
+
+				if(first_arg_value->type != STS_STRING || second_arg_value->type != STS_STRING || third_arg_value->type != STS_NUMBER || eval_value->type != STS_NUMBER)
 				{
-					fprintf(stderr, "the getenv action requires a string argument for the env variable\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in getenv action");
+					fprintf(stderr, "the crypto-argon2i-async action requires a string, string, number, and a final number\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i-async");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i-async");
+					if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i-async");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i-async");
 					return NULL;
 				}
 
-				if(!(temp_str = getenv(eval_value->string.data)))
-				{
-					VALUE_INIT(ret, STS_NIL);
-				}
-				else
+				/* the work area is the scratch memory of the worker, so it is only allocated again when a bigger one is asked for */
+				if((future = cli_future_new(&cli_future_argon2i, (unsigned long)third_arg_value->number * 1024, first_arg_value, second_arg_value)))
 				{
-					VALUE_INIT(ret, STS_STRING);
-					if(!(ret->string.data = strdup(temp_str)))
+					future->numbers[0] = third_arg_value->number;
+					future->numbers[1] = eval_value->number;
+
+					if(cli_future_start(script, future) || !(ret = sts_value_create(script, STS_EXTERNAL)))
+						cli_future_release(future);
+					else
 					{
-						fprintf(stderr, "couldnt duplicate environment variable value\n");
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in getenv action");
-						return NULL;
+						ret->external.refdec = &cli_future_refdec;
+						ret->external.refinc = &cli_future_refinc;
+						ret->external.data_ptr = future;
 					}
-					ret->string.length = strlen(temp_str);
 				}
 
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in getenv action");
-			}
-			else {STS_ERROR_SIMPLE("getenv action requires a single string path argument"); return NULL;}
-		}
-		ACTION(else if, "setenv") /* write a new or overwrite old env variable */
-		{
-			GOTO_SET(&cli_actions);
-			if(args->next && args->next->next)
-			{
-				EVAL_ARG(args->next); first_arg_value = eval_value;
-				EVAL_ARG(args->next->next);
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i-async");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i-async");
+				if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i-async");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i-async");
 
-				if(first_arg_value->type != STS_STRING && eval_value->type != STS_STRING)
+				if(!ret)
 				{
-					fprintf(stderr, "setenv requires 2 string arguments only\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in setenv action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in setenv action");
+					STS_ERROR_SIMPLE("could not start crypto-argon2i-async");
 					return NULL;
 				}
-
-				VALUE_FROM_NUMBER(ret, (double)setenv(first_arg_value->string.data, eval_value->string.data, 1));
-				
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in setenv action");
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in setenv action");
 			}
-			else {STS_ERROR_SIMPLE("setenv action requires at least 2 string arguments"); return NULL;}
+			else {STS_ERROR_SIMPLE("crypto-argon2i-async action requires a string, string, number, and number"); return NULL;}
 		}
-		ACTION(else if, "sleep") /* sleeps for the number of seconds provided */
+		ACTION(else if, "future-ready") /* returns 1 if a future is done and future-wait would not block, otherwise 0 */
 		{
-			#ifdef __unix__
-			struct timespec ts;
-			#endif
 			GOTO_SET(&cli_actions);
 			if(args->next)
 			{
 				EVAL_ARG(args->next);
-				if(eval_value->type != STS_NUMBER )
+
+				if(!IS_CLI_FUTURE(eval_value))
 				{
-					fprintf(stderr, "the sleep action requires a number argument for the number of seconds to sleep\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the sleep action");
+					fprintf(stderr, "the future-ready action requires a future\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the future-ready action");
 					return NULL;
 				}
 
-				#ifdef __unix__
-				ts.tv_sec = eval_value->number;
-				ts.tv_nsec = fmod(eval_value->number, 1.0) * 1000000000.0;
-				nanosleep(&ts, NULL);
-				#elif defined(WIN32)
-				Sleep(eval_value->number);
-				#else
-				sleep((unsigned int)eval_value->number);
-				#endif
-				VALUE_FROM_NUMBER(ret, 1.0);
+				VALUE_FROM_NUMBER(ret, cli_future_done(CLI_FUTURE(eval_value)));
 
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in sleep action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the future-ready action");
 			}
-			else {STS_ERROR_SIMPLE("sleep action requires a single number argument"); return NULL;}
+			else {STS_ERROR_SIMPLE("future-ready action requires a future"); return NULL;}
 		}
-		ACTION(else if, "json") /* parses json into sts values or outputs a stringified version */
+		ACTION(else if, "future-wait") /* waits for a future while other coroutines run and returns its result, or nil if the job failed */
 		{
 			GOTO_SET(&cli_actions);
-			/* parsing from string */
-			if(args->next && !args->next->next)
+			if(args->next)
 			{
 				EVAL_ARG(args->next);
-				if(eval_value->type != STS_STRING )
+
+				if(!IS_CLI_FUTURE(eval_value))
 				{
-					fprintf(stderr, "the json action, if passed one argument, requires a string\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the json action");
+					fprintf(stderr, "the future-wait action requires a future\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the future-wait action");
 					return NULL;
 				}
 
-				if(!(ret = sts_value_from_json(script, NULL, eval_value->string.data, eval_value->string.length)))
+				ret = cli_future_wait(script, CLI_FUTURE(eval_value));
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the future-wait action");
+
+				if(!ret)
 				{
-					STS_ERROR_SIMPLE("could not parse json into value");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the json action");
+					STS_ERROR_SIMPLE("could not create the result in future-wait");
 					return NULL;
 				}
-
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in json action");
 			}
-			else if(args->next && args->next->next)
+			else {STS_ERROR_SIMPLE("future-wait action requires a future"); return NULL;}
+		}
+		ACTION(else if, "crypto-hash") /* hashes a message with blake2b */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
 			{
 				EVAL_ARG(args->next);
-				first_arg_value = eval_value;
-				EVAL_ARG(args->next->next);
 
-				if(eval_value->type != STS_NUMBER)
+				if(eval_value->type != STS_STRING)
 				{
-					fprintf(stderr, "the json action, if passed two arguments, requires the second to be a number (boolean)\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the json action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the json action");
+					fprintf(stderr, "crypto-hash requires a string\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-hash action");
 					return NULL;
 				}
 
-				if(sts_json_from_value(script, &temp_str, first_arg_value, eval_value->number, 0, &temp_ulong))
+				if(!(ret = sts_value_create(script, STS_STRING)))
 				{
-					STS_ERROR_SIMPLE("could not create json string from value");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the json action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the json action");
+					fprintf(stderr, "could not create ret value in crypto-hash\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-hash action");
 					return NULL;
 				}
 
-
-				if(!(ret = sts_value_create(script, STS_STRING)))
+				if(!(ret->string.data = calloc(1, 32 + 1)))
 				{
-					STS_ERROR_SIMPLE("could not create sts string for json string");
-					free(temp_str);
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the json action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the json action");
+					free(ret);
+					fprintf(stderr, "could not create ret value data in crypto-hash\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-hash action");
 					return NULL;
 				}
 
-				/* dont duplicate the string just created with nstring */
-				ret->string.data = temp_str;
-				ret->string.length = temp_ulong;
+				ret->string.length = 32;
 
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the json action");
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the json action");
+				crypto_blake2b_general(ret->string.data, ret->string.length, NULL, 0, eval_value->string.data, eval_value->string.length);
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-hash action");
 			}
-			else {STS_ERROR_SIMPLE("json action requires either single string or any value and a number for pretty printing"); return NULL;}
+			else {STS_ERROR_SIMPLE("crypto-hash action requires a string"); return NULL;}
 		}
-		#ifndef CLI_NO_SOCKETS
-		ACTION(else if, "socket-tcp") /* creates new tcp socket. args are (port, non_blocking, listening) */
+		ACTION(else if, "crypto-hash-init") /* starts a blake2b context that is fed in pieces. Gives the same hash crypto-hash would for all of the pieces together (optional key) */
 		{
 			GOTO_SET(&cli_actions);
-			if(args->next && args->next->next && args->next->next->next)
+			if(args->next)
 			{
 				EVAL_ARG(args->next);
 				first_arg_value = eval_value;
-				EVAL_ARG(args->next->next);
-				second_arg_value = eval_value;
-				EVAL_ARG(args->next->next->next);
 
-				if(first_arg_value->type != STS_NUMBER || second_arg_value->type != STS_NUMBER || eval_value->type != STS_NUMBER)
+				if(first_arg_value->type != STS_STRING || first_arg_value->string.length > 64)
 				{
-					fprintf(stderr, "the socket-tcp action requires 3 number arguments\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp action");
+					fprintf(stderr, "the crypto-hash-init action requires an optional key string of up to 64 bytes\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in crypto-hash-init action");
 					return NULL;
 				}
+			}
 
-				if(!(ret = cli_socket_new(script)))
-				{
-					STS_ERROR_SIMPLE("could not create return socket-tcp");
-
-					/* return nil */
-
-					if(!(ret = sts_value_create(script, STS_NIL)))
-						STS_ERROR_SIMPLE("could not create nil socket in socket-tcp");
-					
-
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp action");
-					return ret;
-				}
-
-				if(zed_net_tcp_socket_open(&CLI_SOCKET(ret)->socket, first_arg_value->number, second_arg_value->number, eval_value->number))
-				{
-					STS_ERROR_SIMPLE("could not open socket");
-
-					/* return nil */
+			if(!(work_area = calloc(1, sizeof(cli_hash_t))) || !(ret = sts_value_create(script, STS_EXTERNAL)))
+			{
+				if(work_area) free(work_area);
+				STS_ERROR_SIMPLE("could not create crypto-hash-init context");
+				if(first_arg_value && !sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in crypto-hash-init action");
+				return NULL;
+			}
 
-					if(!sts_value_reference_decrement(ret, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the old ret in the socket-tcp action");
+			((cli_hash_t *)work_area)->references = 1;
+			crypto_blake2b_general_init(&((cli_hash_t *)work_area)->context, 32, first_arg_value ? (uint8_t *)first_arg_value->string.data : NULL, first_arg_value ? first_arg_value->string.length : 0);
 
-					if(!(ret = sts_value_create(script, STS_NIL)))
-						STS_ERROR_SIMPLE("could not create nil socket in socket-tcp");
-					
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp action");
-					return ret;
-				}
+			ret->external.refdec = &cli_hash_refdec;
+			ret->external.refinc = &cli_hash_refinc;
+			ret->external.data_ptr = work_area;
 
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp action");
-				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp action");
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp action");
-			}
-			else {STS_ERROR_SIMPLE("socket-tcp action requires 3 arguments"); return NULL;}
+			if(first_arg_value && !sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in crypto-hash-init action");
 		}
-		ACTION(else if, "socket-udp") /* creates new udp socket. args are (port, non_blocking) */
+		ACTION(else if, "crypto-hash-update") /* feeds a string into a crypto-hash-init context. Returns 0 or -1 if the context was already finished (context, string) */
 		{
 			GOTO_SET(&cli_actions);
 			if(args->next && args->next->next)
@@ -1198,950 +7713,1008 @@ sts_value_t *cli_actions(sts_script_t *script, sts_value_t *action, sts_node_t *
 				EVAL_ARG(args->next);
 				first_arg_value = eval_value;
 				EVAL_ARG(args->next->next);
-				second_arg_value = eval_value;
 
-				if(first_arg_value->type != STS_NUMBER || second_arg_value->type != STS_NUMBER)
+				if(!IS_CLI_HASH(first_arg_value) || eval_value->type != STS_STRING)
 				{
-					fprintf(stderr, "the socket-udp action requires 2 number arguments\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp action");
+					fprintf(stderr, "the crypto-hash-update action requires a crypto-hash-init context and a string\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in crypto-hash-update action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in crypto-hash-update action");
 					return NULL;
 				}
 
-				if(!(ret = cli_socket_new(script)))
-				{
-					STS_ERROR_SIMPLE("could not create return socket-udp");
-
-					/* return nil */
-
-					if(!(ret = sts_value_create(script, STS_NIL)))
-						STS_ERROR_SIMPLE("could not create nil socket in socket-tcp");
-
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp action");
-					return ret;
-				}
+				if(!CLI_HASH(first_arg_value)->finished)
+					crypto_blake2b_update(&CLI_HASH(first_arg_value)->context, (uint8_t *)eval_value->string.data, eval_value->string.length);
 
-				if(zed_net_udp_socket_open(&CLI_SOCKET(ret)->socket, first_arg_value->number, second_arg_value->number))
-				{
-					STS_ERROR_SIMPLE("could not open socket");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp action");
-					return NULL;
-				}
+				VALUE_FROM_NUMBER(ret, CLI_HASH(first_arg_value)->finished ? -1 : 0);
 
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp action");
-				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp action");
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in crypto-hash-update action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in crypto-hash-update action");
 			}
-			else {STS_ERROR_SIMPLE("socket-udp action requires 3 arguments"); return NULL;}
+			else {STS_ERROR_SIMPLE("crypto-hash-update action requires a context and a string"); return NULL;}
 		}
-		ACTION(else if, "socket-set-broadcast") /* applies SO_BROADCAST socket option, (socket state) */
+		ACTION(else if, "crypto-hash-final") /* returns the 32 byte blake2b hash of everything fed to a context, or nil if it was already finished */
 		{
 			GOTO_SET(&cli_actions);
-			if(args->next && args->next->next)
+			if(args->next)
 			{
-				int opt;
 				EVAL_ARG(args->next);
-				first_arg_value = eval_value;
-				EVAL_ARG(args->next->next);
-				second_arg_value = eval_value;
 
-				if(!IS_CLI_SOCKET(first_arg_value) || second_arg_value->type != STS_NUMBER)
+				if(!IS_CLI_HASH(eval_value))
 				{
-					fprintf(stderr, "the socket-set-broadcast action requires a socket argument and state\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-set-broadcast action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-set-broadcast action");
+					fprintf(stderr, "the crypto-hash-final action requires a crypto-hash-init context\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in crypto-hash-final action");
 					return NULL;
 				}
-				
-				opt = second_arg_value->number;
-				if(setsockopt(CLI_SOCKET(first_arg_value)->socket.handle, SOL_SOCKET, SO_BROADCAST, &opt, sizeof(int)))
-					VALUE_FROM_NUMBER(ret, 1);
-				else
-					VALUE_FROM_NUMBER(ret, 0);
 
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-set-broadcast action");
-				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-set-broadcast action");
+				if(CLI_HASH(eval_value)->finished)
+					ret = sts_value_create(script, STS_NIL);
+				else if((ret = sts_value_create(script, STS_STRING)) && (ret->string.data = calloc(1, 32 + 1)))
+				{
+					ret->string.length = 32;
+					crypto_blake2b_final(&CLI_HASH(eval_value)->context, (uint8_t *)ret->string.data);
+					CLI_HASH(eval_value)->finished = 1;
+				}
+				else if(ret)
+				{
+					free(ret);
+					ret = NULL;
+				}
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in crypto-hash-final action");
+
+				if(!ret)
+				{
+					STS_ERROR_SIMPLE("could not create the hash in crypto-hash-final");
+					return NULL;
+				}
 			}
-			else {STS_ERROR_SIMPLE("socket-set-broadcast action requires 2 arguments"); return NULL;}
+			else {STS_ERROR_SIMPLE("crypto-hash-final action requires a context"); return NULL;}
 		}
-		ACTION(else if, "socket-tcp-connect") /* connects to tcp server (socket, host, port) */
+		ACTION(else if, "fast-hash") /* non cryptographic 64 bit XXH64 hash of a string as a number of its top 53 bits. For checksums and bucketing (string, optional seed) */
 		{
 			GOTO_SET(&cli_actions);
-			if(args->next && args->next->next && args->next->next->next)
+			if(args->next)
 			{
 				EVAL_ARG(args->next);
 				first_arg_value = eval_value;
-				EVAL_ARG(args->next->next);
-				second_arg_value = eval_value;
-				EVAL_ARG(args->next->next->next);
-
-				if(!IS_CLI_SOCKET(first_arg_value) || second_arg_value->type != STS_STRING || eval_value->type != STS_NUMBER)
-				{
-					fprintf(stderr, "the socket-tcp-connect action requires a socket, astring argument for the address, and a number argument for the port\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-connect action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-connect action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp-connect action");
-					return NULL;
-				}
-				
-				temp_uint = 0;
-
-				if(zed_net_get_address(&address, second_arg_value->string.data, eval_value->number))
-				{
-					fprintf(stderr, "could not get the address in socket-tcp-connect: %s\n", zed_net_get_error());
-					temp_uint = 1;
-				}
-				else if(zed_net_tcp_connect(&CLI_SOCKET(first_arg_value)->socket, address))
+				if(args->next->next)
 				{
-					fprintf(stderr, "could not connect to host in socket-tcp-connect: %s\n", zed_net_get_error());
-					temp_uint = 2;
+					EVAL_ARG(args->next->next);
+					second_arg_value = eval_value;
 				}
 
-				if(!(CLI_SOCKET(first_arg_value)->name = sts_memdup(second_arg_value->string.data, second_arg_value->string.length)))
+				if(first_arg_value->type != STS_STRING || (second_arg_value && second_arg_value->type != STS_NUMBER))
 				{
-					STS_ERROR_SIMPLE("could not duplicate the host string in socket-tcp-connect");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-connect action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-connect action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp-connect action");
+					fprintf(stderr, "the fast-hash action requires a string and an optional number seed\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in fast-hash action");
+					if(second_arg_value && !sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in fast-hash action");
 					return NULL;
 				}
 
-				VALUE_FROM_NUMBER(ret, temp_uint);
+				cli_xxh64_init(&xxh64_state, second_arg_value ? (uint64_t)second_arg_value->number : 0);
+				cli_xxh64_update(&xxh64_state, (unsigned char *)first_arg_value->string.data, first_arg_value->string.length);
+				VALUE_FROM_NUMBER(ret, CLI_XXH_NUMBER(cli_xxh64_digest(&xxh64_state)));
 
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-connect action");
-				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-connect action");
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-tcp-connect action");
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in fast-hash action");
+				if(second_arg_value && !sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in fast-hash action");
 			}
-			else {STS_ERROR_SIMPLE("socket-tcp-connect action requires 4 arguments"); return NULL;}
+			else {STS_ERROR_SIMPLE("fast-hash action requires a string"); return NULL;}
 		}
-		ACTION(else if, "socket-tcp-send") /* sends a string buffer to the host in the socket (socket, data) */
+		ACTION(else if, "file-hash") /* hashes a file without reading it all into memory. Returns the 32 byte blake2b hash, the fast-hash number if fast is set, or nil if it can't be read (path, optional fast) */
 		{
 			GOTO_SET(&cli_actions);
-			if(args->next && args->next->next)
+			if(args->next)
 			{
 				EVAL_ARG(args->next);
 				first_arg_value = eval_value;
-				EVAL_ARG(args->next->next);
+				if(args->next->next)
+				{
+					EVAL_ARG(args->next->next);
+					second_arg_value = eval_value;
+				}
 
-				if(!IS_CLI_SOCKET(first_arg_value) || eval_value->type != STS_STRING)
+				if(first_arg_value->type != STS_STRING || (second_arg_value && second_arg_value->type != STS_NUMBER && second_arg_value->type != STS_BOOLEAN))
 				{
-					fprintf(stderr, "the socket-tcp-send action requires a socket and the data to send\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-send action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-send action");
+					fprintf(stderr, "the file-hash action requires a path and optionally if it uses fast-hash\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-hash action");
+					if(second_arg_value && !sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in file-hash action");
 					return NULL;
 				}
 
-				if(CLI_SOCKET(first_arg_value)->ssl)
-					VALUE_FROM_NUMBER(ret, SSL_write(CLI_SOCKET(first_arg_value)->ssl, eval_value->string.data, eval_value->string.length));
+				temp_uint = second_arg_value && (second_arg_value->type == STS_NUMBER ? second_arg_value->number != 0.0 : second_arg_value->boolean);
+
+				if(cli_file_hash(first_arg_value->string.data, temp_uint, hash, &fast_hash))
+					ret = sts_value_create(script, STS_NIL);
+				else if(temp_uint)
+					ret = sts_value_from_number(script, CLI_XXH_NUMBER(fast_hash));
 				else
-					VALUE_FROM_NUMBER(ret, zed_net_tcp_socket_send(&CLI_SOCKET(first_arg_value)->socket, eval_value->string.data, eval_value->string.length));
+					ret = sts_value_from_nstring(script, (char *)hash, 32);
 
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-send action");
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-send action");
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in file-hash action");
+				if(second_arg_value && !sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in file-hash action");
+
+				if(!ret)
+				{
+					STS_ERROR_SIMPLE("could not create the hash in file-hash");
+					return NULL;
+				}
 			}
-			else {STS_ERROR_SIMPLE("socket-tcp-send action requires a socket and a data string"); return NULL;}
+			else {STS_ERROR_SIMPLE("file-hash action requires a path"); return NULL;}
 		}
-		ACTION(else if, "socket-tcp-recv") /* returns a string of data from the socket. ret of 1 means would block, -1 means error, string is data */
+		ACTION(else if, "crypto-sign-public") /* create a public key from a private key */
 		{
 			GOTO_SET(&cli_actions);
 			if(args->next)
 			{
 				EVAL_ARG(args->next);
 
-				if(!IS_CLI_SOCKET(eval_value))
+				if(eval_value->type != STS_STRING)
 				{
-					fprintf(stderr, "the socket-tcp-recv action requires a socket and the data to send\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+					fprintf(stderr, "crypto-sign-public action requires a 32 byte string\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign-public action");
 					return NULL;
 				}
 
-				/* first check if it would block and return a 1 instead of a string */
-
-				if(zed_net_check_would_block(&CLI_SOCKET(eval_value)->socket) == 1)
+				if(eval_value->string.length != 32)
 				{
-					if(!(ret = sts_value_from_number(script, 1)))
+					fprintf(stderr, "crypto-sign-public action requires a 32 byte string\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign-public action");
+					
+					VALUE_FROM_NUMBER(ret, 0);
+				}
+				else /* can create a key */
+				{
+					if(!(ret = sts_value_create(script, STS_STRING)))
 					{
-						STS_ERROR_SIMPLE("could not create number retval in socket-tcp-recv");
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+						fprintf(stderr, "could not create string in crypto-sign-public\n");
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign-public action");
 						return NULL;
 					}
 
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+					if(!(ret->string.data = calloc(1, 32 + 1)))
+					{
+						fprintf(stderr, "could not create string data in crypto-sign-public\n");
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign-public action");
+						return NULL;
+					}
 
-					return ret;
+					ret->string.length = 32;
+
+					crypto_sign_public_key(ret->string.data, eval_value->string.data);
 				}
 
-				do
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign-public action");
+			}
+			else {STS_ERROR_SIMPLE("socket-tcp-would-block action requires a socket"); return NULL;}
+		}
+		ACTION(else if, "crypto-sign") /* signs a message. According to the monocypher manual, its ed25519 but with blake2b */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value; /* message str */
+				EVAL_ARG(args->next->next); /* private key str */
+
+
+				if(first_arg_value->type != STS_STRING || eval_value->type != STS_STRING)
 				{
-					if(zed_net_check_would_block(&CLI_SOCKET(eval_value)->socket))
-						break;
+					fprintf(stderr, "crypto-sign requires a string\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-sign action");
+					return NULL;
+				}
 
-					if(CLI_SOCKET(eval_value)->ssl)
-						temp_int = SSL_read(CLI_SOCKET(eval_value)->ssl, buf, sizeof(buf));
-					else
-						temp_int = zed_net_tcp_socket_receive(&CLI_SOCKET(eval_value)->socket, buf, sizeof(buf));
+				if(eval_value->string.length != 32)
+				{
+					fprintf(stderr, "crypto-sign requires a 32 byte private key\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-sign action");
 					
-					if(temp_int <= 0)
-					 break;
-
-					/* this is bad, but this whole project is for personal use primarily */
-					if(!(temp_str = realloc(temp_str, temp_ulong + temp_int + 1)))
+					VALUE_FROM_NUMBER(ret, 0);
+				}
+				else /* can go ahead and sign the key */
+				{
+					if(!(ret = sts_value_create(script, STS_STRING)))
 					{
-						STS_ERROR_SIMPLE("could not resize temporary buffer in socket-tcp-recv");
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+						fprintf(stderr, "could not create ret value in crypto-sign\n");
+						if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign action");
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-sign action");
 						return NULL;
 					}
 
-					memcpy(&temp_str[temp_ulong], buf, temp_int);
-
-					temp_ulong += temp_int;
-					temp_str[temp_ulong] = 0x0;
-				} while(temp_int == sizeof(buf));
-
-
-				/* return a number instead of a string */
-				if(temp_int == -1)
-				{
-					if(!(ret = sts_value_from_number(script, -1)))
+					/* crypto sign is the only one that generates a 64 byte key */
+					if(!(ret->string.data = calloc(1, 64 + 1)))
 					{
-						STS_ERROR_SIMPLE("could not create number retval in socket-tcp-recv");
-						if(temp_str) free(temp_str);
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+						free(ret);
+						fprintf(stderr, "could not create ret value data in crypto-sign\n");
+						if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign action");
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-sign action");
 						return NULL;
 					}
 
-					if(temp_str) free(temp_str);
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+					ret->string.length = 64;
 
-					return ret;
+					crypto_sign(ret->string.data, eval_value->string.data, NULL, first_arg_value->string.data, first_arg_value->string.length);
 				}
-				/* create a string with the recieved data */
-				else if(temp_uint != -1 && !(ret = sts_value_create(script, STS_STRING)))
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-sign action");
+			}
+			else {STS_ERROR_SIMPLE("crypto-sign action requires a string"); return NULL;}
+		}
+		ACTION(else if, "crypto-check") /* checks the signature of a message using its public key. According to the monocypher manual, its ed25519 but with blake2b */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value; /* message str */
+				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value; /* signature str */
+				EVAL_ARG(args->next->next->next); /* public key str */
+
+
+				if(first_arg_value->type != STS_STRING || eval_value->type != STS_STRING)
 				{
-					STS_ERROR_SIMPLE("could not create string retval in socket-tcp-recv");
-					if(temp_str) free(temp_str);
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+					fprintf(stderr, "crypto-check requires a string\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-check action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
 					return NULL;
 				}
 
-				if(temp_str)
+				if(second_arg_value->string.length != 64)
 				{
-					ret->string.length = temp_ulong;
-					ret->string.data = temp_str;
+					fprintf(stderr, "crypto-check requires a 64 byte signature\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-check action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
+					
+					VALUE_FROM_NUMBER(ret, 0);
 				}
-				else
+				else if(eval_value->string.length != 32)
 				{
-					ret->string.length = 0;
-					ret->string.data = sts_memdup("", 0);
+					fprintf(stderr, "crypto-check requires a 32 byte public key\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-check action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
+					
+					VALUE_FROM_NUMBER(ret, 0);
 				}
-				
+				else /* can go ahead and check the key */
+					VALUE_FROM_NUMBER(ret, crypto_check(second_arg_value->string.data, eval_value->string.data, first_arg_value->string.data, first_arg_value->string.length) ? 0 : 1);
 
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-recv action");
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-check action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
 			}
-			else {STS_ERROR_SIMPLE("socket-tcp-send action requires a socket"); return NULL;}
+			else {STS_ERROR_SIMPLE("crypto-check action requires a string"); return NULL;}
 		}
-		ACTION(else if, "socket-udp-send") /* sends a string buffer to the host in the socket (socket, destination address, destination port, data) */
+		ACTION(else if, "base64-encode") /* encodes a string as base64 */
 		{
 			GOTO_SET(&cli_actions);
-			if(args->next && args->next->next && args->next->next->next  && args->next->next->next->next)
+			if(args->next)
 			{
 				EVAL_ARG(args->next);
-				first_arg_value = eval_value;
-				EVAL_ARG(args->next->next);
-				second_arg_value = eval_value;
-				EVAL_ARG(args->next->next->next);
-				third_arg_value = eval_value;
-				EVAL_ARG(args->next->next->next->next);
 
-				if(!IS_CLI_SOCKET(first_arg_value) || second_arg_value->type != STS_STRING || third_arg_value->type != STS_NUMBER || eval_value->type != STS_STRING)
+				if(eval_value->type != STS_STRING)
 				{
-					fprintf(stderr, "the socket-udp-send action requires a socket, the destination, destination port, and the data to send\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-send action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp-send action");
-					if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-udp-send action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the fourth argument in the socket-udp-send action");
+					fprintf(stderr, "the base64-encode action requires a string\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-encode action");
 					return NULL;
 				}
 
-				if(zed_net_get_address(&address, second_arg_value->string.data, third_arg_value->number))
+				if(!(ret = sts_value_create(script, STS_STRING)))
 				{
-					fprintf(stderr, "could not get the address in socket-udp-send: %s\n", zed_net_get_error());
-					VALUE_FROM_NUMBER(ret, -1);
+					fprintf(stderr, "could not create string value in base64-encode action\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-encode action");
+					return NULL;
+				}
+
+				ret->string.length = CLI_BASE64_ENCODED_LENGTH(eval_value->string.length);
+
+				/* every byte gets written, so there is nothing to clear */
+				if(!(ret->string.data = malloc(ret->string.length + 1)))
+				{
+					free(ret);
+					fprintf(stderr, "could not create string value data in base64-encode action\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-encode action");
+					return NULL;
 				}
-				else
-					VALUE_FROM_NUMBER(ret, zed_net_udp_socket_send(&CLI_SOCKET(first_arg_value)->socket, address, eval_value->string.data, eval_value->string.length));
 
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-send action");
-				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-udp-send action");
-				if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the socket-udp-send action");
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the fourth argument in the socket-udp-send action");
+				cli_base64_encode(ret->string.data, (unsigned char *)eval_value->string.data, eval_value->string.length);
+				ret->string.data[ret->string.length] = 0;
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-encode action");
 			}
-			else {STS_ERROR_SIMPLE("socket-udp-send action requires a socket and a data string"); return NULL;}
+			else {STS_ERROR_SIMPLE("base64-encode requires a string"); return NULL;}
 		}
-		ACTION(else if, "socket-udp-recv") /* returns a string of data from the socket. ret of 1 means would block, -1 means error, string is data */
+		ACTION(else if, "base64-decode") /* decodes a base64 encoded string. Returns nil if it isn't valid base64 */
 		{
 			GOTO_SET(&cli_actions);
 			if(args->next)
 			{
 				EVAL_ARG(args->next);
 
-				if(!IS_CLI_SOCKET(eval_value))
+				if(eval_value->type != STS_STRING)
 				{
-					fprintf(stderr, "the socket-udp-recv action requires a socket and the data to send\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
+					fprintf(stderr, "the base64-decode action requires a string\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-decode action");
 					return NULL;
 				}
 
-				/* first check if it would block and return a 1 instead of a string */
+				temp_int = cli_base64_decoded_length(eval_value->string.data, eval_value->string.length, &temp_ulong);
 
-				if(zed_net_check_would_block(&CLI_SOCKET(eval_value)->socket) == 1)
+				/* every byte gets written, so there is nothing to clear */
+				if(!temp_int && !(work_area = malloc(temp_ulong + 1)))
 				{
-					if(!(ret = sts_value_from_number(script, 1)))
-					{
-						STS_ERROR_SIMPLE("could not create number retval in socket-udp-recv");
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
-						return NULL;
-					}
-
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
-
-					return ret;
+					fprintf(stderr, "could not create string value data in base64-decode action\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-decode action");
+					return NULL;
 				}
 
-				do
-				{
-					if(zed_net_check_would_block(&CLI_SOCKET(eval_value)->socket))
-						break;
-
-					temp_int = zed_net_udp_socket_receive(&CLI_SOCKET(eval_value)->socket, &address, buf, sizeof(buf));
-					
-					if(temp_int <= 0)
-					 break;
-
-					/* this is bad, but this whole project is for personal use primarily */
-					if(!(temp_str = realloc(temp_str, temp_ulong + temp_int + 1)))
-					{
-						STS_ERROR_SIMPLE("could not resize temporary buffer in socket-udp-recv");
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
-						return NULL;
-					}
-
-					memcpy(&temp_str[temp_ulong], buf, temp_int);
-
-					temp_ulong += temp_int;
-					temp_str[temp_ulong] = 0x0;
-				} while(temp_int == sizeof(buf));
-
-
-				/* return a number instead of a string */
-				if(temp_int == -1)
-				{
-					if(!(ret = sts_value_from_number(script, -1)))
-					{
-						STS_ERROR_SIMPLE("could not create number retval in socket-udp-recv");
-						if(temp_str) free(temp_str);
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
-						return NULL;
-					}
-
-					if(temp_str) free(temp_str);
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
-
-					return ret;
-				}
-				/* create a string with the recieved data */
-				else if(temp_uint != -1 && !(ret = sts_value_create(script, STS_STRING)))
+				if(temp_int || cli_base64_decode(work_area, eval_value->string.data, eval_value->string.length))
 				{
-					STS_ERROR_SIMPLE("could not create string retval in socket-udp-recv");
-					if(temp_str) free(temp_str);
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
-					return NULL;
+					if(work_area) free(work_area);
+					ret = sts_value_create(script, STS_NIL);
 				}
-
-				if(temp_str)
+				else if((ret = sts_value_create(script, STS_STRING)))
 				{
+					ret->string.data = work_area;
+					ret->string.data[temp_ulong] = 0;
 					ret->string.length = temp_ulong;
-					ret->string.data = temp_str;
 				}
 				else
+					free(work_area);
+
+				if(!ret)
 				{
-					ret->string.length = 0;
-					ret->string.data = sts_memdup("", 0);
+					fprintf(stderr, "could not create string value in base64-decode action\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-decode action");
+					return NULL;
 				}
-				
 
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-udp-recv action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-decode action");
 			}
-			else {STS_ERROR_SIMPLE("socket-tcp-send action requires a socket"); return NULL;}
+			else {STS_ERROR_SIMPLE("base64-decode requires a string"); return NULL;}
 		}
-		ACTION(else if, "socket-tcp-would-block") /* tests if a socket will block */
+		ACTION(else if, "exit") /* exits the interpreter with a return value */
 		{
 			GOTO_SET(&cli_actions);
 			if(args->next)
 			{
 				EVAL_ARG(args->next);
+				sts_output_flush(script); /* exit skips the cleanup that would flush it otherwise */
+				if(eval_value->type == STS_NUMBER )
+					exit(eval_value->number);
+				exit(0);
 
-				if(!IS_CLI_SOCKET(eval_value))
-				{
-					fprintf(stderr, "the socket-tcp-would-block action requires a socket\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-would-block action");
-					return NULL;
-				}
-
-				VALUE_FROM_NUMBER(ret, zed_net_check_would_block(&CLI_SOCKET(eval_value)->socket));
-
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-would-block action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in exit action");
 			}
-			else {STS_ERROR_SIMPLE("socket-tcp-would-block action requires a socket"); return NULL;}
+			sts_output_flush(script);
+			exit(0);
 		}
-		ACTION(else if, "socket-tcp-accept") /* returns a socket upon connection (socket, out_client_socket) */
+		ACTION(else if, "directory-list") /* array of strings containing filenames of a directory string */
 		{
 			GOTO_SET(&cli_actions);
-			if(args->next && args->next->next)
+			if(args->next)
 			{
+				#ifdef CLI_WINDOWS
+				WIN32_FIND_DATA fd;
+				HANDLE hf;
+				char *t_str = NULL;
+				size_t t_str_len = 0;
+				#else
+				DIR *d = NULL;
+				struct dirent *de = NULL;
+				#endif
+
 				EVAL_ARG(args->next);
-				first_arg_value = eval_value;
-				EVAL_ARG(args->next->next);
 
-				if(!IS_CLI_SOCKET(first_arg_value))
+				if(eval_value->type != STS_STRING)
 				{
-					fprintf(stderr, "the socket-tcp-accept action requires a socket\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-accept action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-accept action");
+					fprintf(stderr, "the directory-list action requires a string\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
 					return NULL;
 				}
 
-				if(!(temp_value = cli_socket_new(script)))
+				if(!(ret = sts_value_create(script, STS_ARRAY)))
 				{
-					STS_ERROR_SIMPLE("could not create return socket");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-accept action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-accept action");
+					fprintf(stderr, "could not create array value in directory-list action\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
 					return NULL;
 				}
 
-				if((temp_int = zed_net_tcp_accept(&CLI_SOCKET(first_arg_value)->socket, &CLI_SOCKET(temp_value)->socket, &address)))
-				{
-					if(!sts_value_reference_decrement(script, temp_value)) STS_ERROR_SIMPLE("could not decrement references for the old temp value in the socket-tcp-accept action");
-
-					/* just dont touch the outsocket value */
-				}
-				else
-				{
-					/* set the 2nd arg reference to the new socket */
-
-					if(sts_value_copy(script, eval_value, temp_value, 0))
+				#ifdef CLI_WINDOWS
+					t_str_len = eval_value->string.length + 2;
+					if(!(t_str = calloc(1, t_str_len + 1)))
 					{
-						STS_ERROR_SIMPLE("could not set outsock to the client socket");
-						if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-accept action");
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-accept action");
+						fprintf(stderr, "could not create t_str directory-list action\n");
+						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
 						return NULL;
 					}
+					strncat(t_str, eval_value->string.data, eval_value->string.length);
+					strncat(t_str, "\\*", 2);
+					if((hf = FindFirstFile(t_str, &fd)) == INVALID_HANDLE_VALUE)
+					{
+						sts_value_reference_decrement(script, ret);
 
-					if(!sts_value_reference_decrement(script, temp_value)) STS_ERROR_SIMPLE("could not decrement references for the old temp value in the socket-tcp-accept action");
-				}
+						if(!(ret = sts_value_create(script, STS_NIL)))
+						{
+							fprintf(stderr, "could not create nil value in directory-list action\n");
+							free(t_str);
+							if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
+							return NULL;
+						}
+					}
+					else
+					{
+						do
+						{
+							sts_value_t *str = NULL;
+							if(!(str = sts_value_from_string(script, df.cFileName)))
+							{
+								fprintf(stderr, "could not add string to array value in directory-list action\n");
+								free(t_str);
+								if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
+								return NULL;
+							}
 
-				VALUE_FROM_NUMBER(ret, temp_int);
+							sts_array_append_insert(script, ret, str, ret->array.length);
+						} while(FindNextFile(hf, &fd));
+					}
+					free(t_str);
+				#else
+					if(!(d = opendir(eval_value->string.data)))
+					{
+						sts_value_reference_decrement(script, ret);
 
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the socket-tcp-would-block action");
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the socket-tcp-would-block action");
+						if(!(ret = sts_value_create(script, STS_NIL)))
+						{
+							fprintf(stderr, "could not create nil value in directory-list action\n");
+							if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
+							return NULL;
+						}
+					}
+					else
+						while((de = readdir(d)))
+						{
+							sts_value_t *str = NULL;
+							if(!(str = sts_value_from_string(script, de->d_name)))
+							{
+								fprintf(stderr, "could not add string to array value in directory-list action\n");
+								if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
+								return NULL;
+							}
+
+							sts_array_append_insert(script, ret, str, ret->array.length);
+						}
+				#endif
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
 			}
-			else {STS_ERROR_SIMPLE("socket-tcp-accept action requires a socket and out_socket which is passed byref"); return NULL;}
+			else {STS_ERROR_SIMPLE("directory-list requires a string"); return NULL;}
 		}
-		ACTION(else if, "socket-enable-ssl-client") /* handshake with server */
+		ACTION(else if, "directory-walk") /* returns [path type size mtime] for everything under a directory, reading directories on the thread pool. Returns nil if the directory can't be read (path, optional depth, optional glob) */
 		{
 			GOTO_SET(&cli_actions);
 			if(args->next)
 			{
 				EVAL_ARG(args->next);
-				if(!IS_CLI_SOCKET(eval_value))
+				first_arg_value = eval_value;
+				if(args->next->next)
 				{
-					STS_ERROR_SIMPLE("socket-enable-ssl-client: arg0 isnt socket");
-					sts_value_reference_decrement(script, eval_value);
-					return NULL;
+					EVAL_ARG(args->next->next);
+					second_arg_value = eval_value;
 				}
-
-				if(!(CLI_SOCKET(eval_value)->ssl = SSL_CTX_new(SSLv3_client_method())))
+				if(args->next->next && args->next->next->next)
 				{
-					STS_ERROR_SIMPLE("socket-enable-ssl-client: ubable to init ssl");
-					++temp_uint;
+					EVAL_ARG(args->next->next->next);
+					third_arg_value = eval_value;
 				}
 
-				if(SSL_set_fd(CLI_SOCKET(eval_value)->ssl, CLI_SOCKET(eval_value)->socket.handle) != 1)
-				{
-					STS_ERROR_SIMPLE("socket-enable-ssl-client: unable to set fd");
-					++temp_uint;
-				}
-				if(tls_sni_set(CLI_SOCKET(eval_value)->ssl, CLI_SOCKET(eval_value)->name) != 1)
-				{
-					STS_ERROR_SIMPLE("socket-enable-ssl-client: unable to set sni");
-					++temp_uint;
-				}
-				if(SSL_connect(CLI_SOCKET(eval_value)->ssl) != 1)
+				if(first_arg_value->type != STS_STRING || (second_arg_value && (second_arg_value->type != STS_NUMBER || second_arg_value->number == 0.0)) || (third_arg_value && third_arg_value->type != STS_STRING))
 				{
-					STS_ERROR_SIMPLE("socket-enable-ssl-client: unable to handshake");
-					++temp_uint;
+					fprintf(stderr, "the directory-walk action requires a path, and optionally a nonzero depth and a glob\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in directory-walk action");
+					if(second_arg_value && !sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in directory-walk action");
+					if(third_arg_value && !sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in directory-walk action");
+					return NULL;
 				}
 
-				VALUE_FROM_NUMBER(ret, temp_uint);
+				#ifndef CLI_NO_DIRECTORY_WALK
+				if(!(ret = cli_walk(script, first_arg_value->string.data, first_arg_value->string.length, second_arg_value && second_arg_value->number > 0.0 ? (int)second_arg_value->number : -1, third_arg_value ? third_arg_value->string.data : NULL)))
+					STS_ERROR_SIMPLE("could not walk directory");
+				#else
+				STS_ERROR_SIMPLE("directory-walk is not available in this build");
+				#endif
 
-				if(!sts_value_reference_decrement(script, eval_value))
-					STS_ERROR_SIMPLE("socket-enable-ssl-client: argument isnt socket");
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in directory-walk action");
+				if(second_arg_value && !sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in directory-walk action");
+				if(third_arg_value && !sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in directory-walk action");
+
+				if(!ret)
+					return NULL;
 			}
-			else {STS_ERROR_SIMPLE("socket-enable-ssl-client expects socket"); return NULL;}
+			else {STS_ERROR_SIMPLE("directory-walk action requires a path"); return NULL;}
+		}
+		#ifndef CLI_NO_WATCH
+		ACTION(else if, "watch-new") /* creates a watch that collects changes to files and directories */
+		{
+			GOTO_SET(&cli_actions);
+
+			if(!(ret = cli_watch_value(script, NULL)))
+				return NULL;
 		}
-		#endif /* CLI_NO_SOCKETS */
-		ACTION(else if, "crypto-argon2i") /* hashes a string with salt and returns the hash string buffer */
+		ACTION(else if, "watch-add") /* starts watching a file or directory, or changes what it is watched for. Returns nonzero on error (watch, path, optional events) */
 		{
 			GOTO_SET(&cli_actions);
-			if(args->next)
+			if(args->next && args->next->next)
 			{
 				EVAL_ARG(args->next);
-				first_arg_value = eval_value; /* password str */
+				first_arg_value = eval_value;
 				EVAL_ARG(args->next->next);
-				second_arg_value = eval_value; /* salt str */
-				EVAL_ARG(args->next->next->next);
-				third_arg_value = eval_value; /* number of blocks in work area */
-				EVAL_ARG(args->next->next->next->next); /* number of iterations */
-				
-
-				if(first_arg_value->type != STS_STRING || second_arg_value->type != STS_STRING || third_arg_value->type != STS_NUMBER || eval_value->type != STS_NUMBER)
+				second_arg_value = eval_value;
+				if(args->next->next->next)
 				{
-					fprintf(stderr, "the crypto-argon2i action requires a string, string, number, and a final number\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					return NULL;
+					EVAL_ARG(args->next->next->next);
+					third_arg_value = eval_value;
 				}
 
-				if(!(ret = sts_value_create(script, STS_STRING)))
+				if(!IS_CLI_WATCH(first_arg_value) || second_arg_value->type != STS_STRING || (third_arg_value && third_arg_value->type != STS_STRING))
 				{
-					fprintf(stderr, "could not create return string in crypto-argon2i action\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					fprintf(stderr, "the watch-add action requires a watch, a path, and optionally a string of events\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the watch-add action");
+					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the watch-add action");
+					if(third_arg_value && !sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the watch-add action");
 					return NULL;
 				}
 
-				/* made output hashes 32 bytes instead of 64 because it may be useful to sign messages with it as well. Might be a bad idea, but you would have to know the salt. We'll see */
-				if(!(ret->string.data = malloc(32 + 1)))
-				{
-					fprintf(stderr, "could not create return string data in crypto-argon2i action\n");
-					free(ret);
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					return NULL;
-				}
+				VALUE_FROM_NUMBER(ret, cli_watch_add(CLI_WATCH(first_arg_value), second_arg_value->string.data, cli_watch_events_from_string(third_arg_value ? third_arg_value->string.data : "")));
 
-				ret->string.data[32] = 0;
-				ret->string.length = 32;
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the watch-add action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the watch-add action");
+				if(third_arg_value && !sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the watch-add action");
+			}
+			else {STS_ERROR_SIMPLE("watch-add action requires a watch and a path"); return NULL;}
+		}
+		ACTION(else if, "watch-remove") /* stops watching a path. Returns nonzero if it wasnt watched (watch, path) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
 
-				if(!(work_area = malloc(third_arg_value->number * 1024)))
+				if(!IS_CLI_WATCH(first_arg_value) || eval_value->type != STS_STRING)
 				{
-					fprintf(stderr, "could not work area in crypto-argon2i action\n");
-					sts_value_reference_decrement(script, ret);
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+					fprintf(stderr, "the watch-remove action requires a watch and a path\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the watch-remove action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the watch-remove action");
 					return NULL;
 				}
 
-				crypto_argon2i(ret->string.data, ret->string.length, work_area, third_arg_value->number, eval_value->number, first_arg_value->string.data, first_arg_value->string.length, second_arg_value->string.data, second_arg_value->string.length);
-
-				free(work_area);
+				VALUE_FROM_NUMBER(ret, cli_watch_remove(CLI_WATCH(first_arg_value), eval_value->string.data));
 
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-				if(!sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for an argument in crypto-argon2i");
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the watch-remove action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the watch-remove action");
 			}
-			else {STS_ERROR_SIMPLE("crypto-argon2i action requires a string, string, number, and number"); return NULL;}
+			else {STS_ERROR_SIMPLE("watch-remove action requires a watch and a path"); return NULL;}
 		}
-		ACTION(else if, "crypto-hash") /* hashes a message with blake2b */
+		ACTION(else if, "watch-wait") /* returns an array of [path event name] for every change since the last call, waiting up to timeout milliseconds for one. -1 waits forever (watch, timeout) */
 		{
+			struct pollfd ready;
 			GOTO_SET(&cli_actions);
-			if(args->next)
+			if(args->next && args->next->next)
 			{
 				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
 
-				if(eval_value->type != STS_STRING)
+				if(!IS_CLI_WATCH(first_arg_value) || eval_value->type != STS_NUMBER)
 				{
-					fprintf(stderr, "crypto-hash requires a string\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-hash action");
+					fprintf(stderr, "the watch-wait action requires a watch and a timeout\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the watch-wait action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the watch-wait action");
 					return NULL;
 				}
 
-				if(!(ret = sts_value_create(script, STS_STRING)))
+				if(eval_value->number != 0.0)
 				{
-					fprintf(stderr, "could not create ret value in crypto-hash\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-hash action");
-					return NULL;
+					/* the other coroutines keep running while this would block */
+					if(eval_value->number < 0.0)
+						cli_coroutine_wait_fd(script, CLI_WATCH(first_arg_value)->fd, POLLIN);
+
+					ready.fd = CLI_WATCH(first_arg_value)->fd;
+					ready.events = POLLIN;
+					ready.revents = 0;
+					while(poll(&ready, 1, (int)eval_value->number) == -1 && errno == EINTR);
 				}
 
-				if(!(ret->string.data = calloc(1, 32 + 1)))
+				if((ret = sts_value_create(script, STS_ARRAY)) && cli_watch_read(script, CLI_WATCH(first_arg_value), ret))
 				{
-					free(ret);
-					fprintf(stderr, "could not create ret value data in crypto-hash\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-hash action");
-					return NULL;
+					STS_ERROR_SIMPLE("could not read watch events");
+					sts_value_reference_decrement(script, ret);
+					ret = NULL;
 				}
 
-				ret->string.length = 32;
-
-				crypto_blake2b_general(ret->string.data, ret->string.length, NULL, 0, eval_value->string.data, eval_value->string.length);
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the watch-wait action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the watch-wait action");
 
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-hash action");
+				if(!ret)
+					return NULL;
 			}
-			else {STS_ERROR_SIMPLE("crypto-hash action requires a string"); return NULL;}
+			else {STS_ERROR_SIMPLE("watch-wait action requires a watch and a timeout"); return NULL;}
 		}
-		ACTION(else if, "crypto-sign-public") /* create a public key from a private key */
+		#endif /* CLI_NO_WATCH */
+		ACTION(else if, "clock-monotonic") /* returns seconds from an arbitrary point that only ever goes forward. Meant for timing */
 		{
+			#ifndef CLI_WINDOWS
+			struct timespec ts;
+			#endif
 			GOTO_SET(&cli_actions);
-			if(args->next)
+
+			#ifdef CLI_WINDOWS
+			VALUE_FROM_NUMBER(ret, (double)GetTickCount64() / 1000.0);
+			#else
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			VALUE_FROM_NUMBER(ret, (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0);
+			#endif
+		}
+		ACTION(else if, "parallel-map") /* calls a function on every member of an array using a pool of threads and returns the results in order (function, array, workers) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
 			{
 				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value;
 
-				if(eval_value->type != STS_STRING)
+				if(args->next->next->next)
 				{
-					fprintf(stderr, "crypto-sign-public action requires a 32 byte string\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign-public action");
-					return NULL;
+					EVAL_ARG(args->next->next->next);
+					third_arg_value = eval_value;
 				}
 
-				if(eval_value->string.length != 32)
+				if(first_arg_value->type != STS_FUNCTION || second_arg_value->type != STS_ARRAY || (third_arg_value && third_arg_value->type != STS_NUMBER))
 				{
-					fprintf(stderr, "crypto-sign-public action requires a 32 byte string\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign-public action");
-					
-					VALUE_FROM_NUMBER(ret, 0);
+					fprintf(stderr, "the parallel-map action requires a function, an array, and optionally a number of workers\n");
 				}
-				else /* can create a key */
+				#ifndef CLI_NO_THREADS
+				else if(CLI_STATE(script) && (CLI_STATE(script)->pool || (CLI_STATE(script)->pool = sts_pool_create(script, 0))))
 				{
-					if(!(ret = sts_value_create(script, STS_STRING)))
-					{
-						fprintf(stderr, "could not create string in crypto-sign-public\n");
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign-public action");
-						return NULL;
-					}
+					if(!(ret = sts_parallel_map(CLI_STATE(script)->pool, script, first_arg_value, second_arg_value, third_arg_value ? (unsigned int)third_arg_value->number : 0)))
+						STS_ERROR_SIMPLE("could not map function in parallel");
+				}
+				#endif
+				else if((ret = sts_value_create(script, STS_ARRAY))) /* no pool, which is also the case inside a worker, so just map here */
+				{
+					if(!(temp_value = sts_value_create(script, STS_ARRAY)))
+						STS_ERROR_SIMPLE("could not create argument array in parallel-map");
 
-					if(!(ret->string.data = calloc(1, 32 + 1)))
+					for(i = 0; temp_value && i < second_arg_value->array.length; ++i)
 					{
-						fprintf(stderr, "could not create string data in crypto-sign-public\n");
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign-public action");
-						return NULL;
-					}
+						STS_VALUE_REFINC(script, second_arg_value->array.data[i]);
+						sts_array_append_insert(script, temp_value, second_arg_value->array.data[i], 0);
 
-					ret->string.length = 32;
+						if(!(eval_value = sts_function_call(script, first_arg_value, temp_value)))
+						{
+							STS_ERROR_SIMPLE("function failed in parallel-map");
+							sts_value_reference_decrement(script, ret);
+							ret = NULL;
+							break;
+						}
 
-					crypto_sign_public_key(ret->string.data, eval_value->string.data);
+						sts_array_append_insert(script, ret, eval_value, ret->array.length);
+						sts_array_remove(script, temp_value, 0);
+					}
+
+					if(temp_value && !sts_value_reference_decrement(script, temp_value)) STS_ERROR_SIMPLE("could not decrement references for the argument array in the parallel-map action");
+					if(ret && !temp_value){ sts_value_reference_decrement(script, ret); ret = NULL;}
 				}
 
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign-public action");
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the parallel-map action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the parallel-map action");
+				if(third_arg_value && !sts_value_reference_decrement(script, third_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the third argument in the parallel-map action");
+
+				if(!ret)
+					return NULL;
 			}
-			else {STS_ERROR_SIMPLE("socket-tcp-would-block action requires a socket"); return NULL;}
+			else {STS_ERROR_SIMPLE("parallel-map action requires a function and an array"); return NULL;}
 		}
-		ACTION(else if, "crypto-sign") /* signs a message. According to the monocypher manual, its ed25519 but with blake2b */
+		#ifndef CLI_NO_COROUTINES
+		ACTION(else if, "spawn") /* starts a coroutine and returns a handle that can be awaited (function, args...) */
 		{
 			GOTO_SET(&cli_actions);
 			if(args->next)
 			{
 				EVAL_ARG(args->next);
-				first_arg_value = eval_value; /* message str */
-				EVAL_ARG(args->next->next); /* private key str */
-
+				first_arg_value = eval_value;
 
-				if(first_arg_value->type != STS_STRING || eval_value->type != STS_STRING)
+				if(first_arg_value->type != STS_FUNCTION || !CLI_STATE(script))
 				{
-					fprintf(stderr, "crypto-sign requires a string\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-sign action");
+					fprintf(stderr, "the spawn action requires a function and can not be used on a worker\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the spawn action");
 					return NULL;
 				}
 
-				if(eval_value->string.length != 32)
+				if(!(temp_value = sts_value_create(script, STS_ARRAY)))
 				{
-					fprintf(stderr, "crypto-sign requires a 32 byte private key\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-sign action");
-					
-					VALUE_FROM_NUMBER(ret, 0);
+					STS_ERROR_SIMPLE("could not create argument array in spawn");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the spawn action");
+					return NULL;
 				}
-				else /* can go ahead and sign the key */
+
+				for(arg = args->next->next; arg; arg = arg->next)
 				{
-					if(!(ret = sts_value_create(script, STS_STRING)))
+					if(!(eval_value = sts_eval(script, arg, locals, previous, 1, 0)))
 					{
-						fprintf(stderr, "could not create ret value in crypto-sign\n");
-						if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign action");
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-sign action");
+						STS_ERROR_SIMPLE("could not evaluate argument in spawn");
+						sts_value_reference_decrement(script, temp_value);
+						sts_value_reference_decrement(script, first_arg_value);
 						return NULL;
 					}
 
-					/* crypto sign is the only one that generates a 64 byte key */
-					if(!(ret->string.data = calloc(1, 64 + 1)))
-					{
-						free(ret);
-						fprintf(stderr, "could not create ret value data in crypto-sign\n");
-						if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign action");
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-sign action");
-						return NULL;
-					}
+					sts_array_append_insert(script, temp_value, eval_value, temp_value->array.length);
+				}
 
-					ret->string.length = 64;
+				if((coroutine = cli_coroutine_spawn(script, first_arg_value, temp_value)) && !(ret = cli_coroutine_value(script, coroutine, &cli_coroutine_refdec, &cli_coroutine_refinc)))
+					cli_coroutine_release(script, coroutine);
 
-					crypto_sign(ret->string.data, eval_value->string.data, NULL, first_arg_value->string.data, first_arg_value->string.length);
-				}
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the spawn action");
+				if(!sts_value_reference_decrement(script, temp_value)) STS_ERROR_SIMPLE("could not decrement references for the argument array in the spawn action");
 
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-sign action");
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-sign action");
+				if(!ret)
+					return NULL;
 			}
-			else {STS_ERROR_SIMPLE("crypto-sign action requires a string"); return NULL;}
+			else {STS_ERROR_SIMPLE("spawn action requires a function"); return NULL;}
 		}
-		ACTION(else if, "crypto-check") /* checks the signature of a message using its public key. According to the monocypher manual, its ed25519 but with blake2b */
+		ACTION(else if, "yield") /* lets every other coroutine run before continuing */
+		{
+			GOTO_SET(&cli_actions);
+
+			if(CLI_STATE(script))
+				cli_coroutine_wait(script, NULL, -1, 0);
+
+			VALUE_INIT(ret, STS_NIL);
+		}
+		ACTION(else if, "await") /* waits for a coroutine to finish and returns what its function returned. Also takes a future like future-wait does */
 		{
 			GOTO_SET(&cli_actions);
 			if(args->next)
 			{
 				EVAL_ARG(args->next);
-				first_arg_value = eval_value; /* message str */
-				EVAL_ARG(args->next->next);
-				second_arg_value = eval_value; /* signature str */
-				EVAL_ARG(args->next->next->next); /* public key str */
 
-
-				if(first_arg_value->type != STS_STRING || eval_value->type != STS_STRING)
+				if(!IS_CLI_FUTURE(eval_value) && (!IS_CLI_COROUTINE(eval_value) || !CLI_STATE(script) || CLI_COROUTINE(eval_value) == CLI_STATE(script)->scheduler.current))
 				{
-					fprintf(stderr, "crypto-check requires a string\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-check action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
+					fprintf(stderr, "the await action requires a future or a coroutine other than the current one, and can not await a coroutine on a worker\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the await action");
 					return NULL;
 				}
 
-				if(second_arg_value->string.length != 64)
-				{
-					fprintf(stderr, "crypto-check requires a 64 byte signature\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-check action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
-					
-					VALUE_FROM_NUMBER(ret, 0);
-				}
-				else if(eval_value->string.length != 32)
+				if(IS_CLI_FUTURE(eval_value))
+					ret = cli_future_wait(script, CLI_FUTURE(eval_value));
+				else
 				{
-					fprintf(stderr, "crypto-check requires a 32 byte public key\n");
-					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-check action");
-					if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
-					
-					VALUE_FROM_NUMBER(ret, 0);
+					while(CLI_COROUTINE(eval_value)->state != CLI_COROUTINE_DONE)
+						if(!cli_coroutine_wait(script, &CLI_COROUTINE(eval_value)->awaiting, -1, 0))
+						{
+							fprintf(stderr, "deadlock in await. Every coroutine is waiting\n");
+							break;
+						}
+
+					if((ret = CLI_COROUTINE(eval_value)->result))
+						STS_VALUE_REFINC(script, ret);
 				}
-				else /* can go ahead and check the key */
-					VALUE_FROM_NUMBER(ret, crypto_check(second_arg_value->string.data, eval_value->string.data, first_arg_value->string.data, first_arg_value->string.length) ? 0 : 1);
 
-				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the crypto-check action");
-				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the crypto-check action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the await action");
+
+				if(!ret)
+					VALUE_INIT(ret, STS_NIL);
 			}
-			else {STS_ERROR_SIMPLE("crypto-check action requires a string"); return NULL;}
+			else {STS_ERROR_SIMPLE("await action requires a coroutine or a future"); return NULL;}
 		}
-		ACTION(else if, "base64-encode") /* encodes a string as base64 */
+		ACTION(else if, "channel-new") /* creates a channel that holds up to capacity values before channel-send waits (capacity) */
 		{
-			#define B64_SIZE(len) (4 * ((len + 2) / 3))
 			GOTO_SET(&cli_actions);
 			if(args->next)
 			{
 				EVAL_ARG(args->next);
 
-				if(eval_value->type != STS_STRING)
+				if(eval_value->type != STS_NUMBER || eval_value->number < 1.0 || !CLI_STATE(script))
 				{
-					fprintf(stderr, "the base64-encode action requires a string\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-encode action");
+					fprintf(stderr, "the channel-new action requires a capacity of at least 1 and can not be used on a worker\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the channel-new action");
 					return NULL;
 				}
 
-				if(!(ret = sts_value_create(script, STS_STRING)))
+				if(!(channel = calloc(1, sizeof(cli_channel_t))) || !(channel->values = malloc(sizeof(sts_value_t *) * (unsigned int)eval_value->number)))
 				{
-					fprintf(stderr, "could not create string value in base64-encode action\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-encode action");
+					STS_ERROR_SIMPLE("could not allocate channel");
+					if(channel) free(channel);
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the channel-new action");
 					return NULL;
 				}
 
-				ret->string.length = B64_SIZE(eval_value->string.length);
+				channel->references = 1;
+				channel->capacity = (unsigned int)eval_value->number;
 
-				if(!(ret->string.data = calloc(1, ret->string.length + 1)))
+				if(!(ret = cli_coroutine_value(script, channel, &cli_channel_refdec, &cli_channel_refinc)))
 				{
-					free(ret);
-					fprintf(stderr, "could not create string value data in base64-encode action\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-encode action");
+					free(channel->values);
+					free(channel);
+				}
+
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the channel-new action");
+
+				if(!ret)
 					return NULL;
+			}
+			else {STS_ERROR_SIMPLE("channel-new action requires a capacity"); return NULL;}
+		}
+		ACTION(else if, "channel-send") /* puts a value in a channel, waiting while it is full (channel, value) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
+				second_arg_value = eval_value;
+
+				if(!IS_CLI_CHANNEL(first_arg_value) || !CLI_STATE(script))
+					fprintf(stderr, "the channel-send action requires a channel and a value and can not be used on a worker\n");
+				else
+				{
+					channel = CLI_CHANNEL(first_arg_value);
+
+					while(channel->length == channel->capacity)
+						if(!cli_coroutine_wait(script, &channel->senders, -1, 0))
+						{
+							fprintf(stderr, "deadlock in channel-send. Every coroutine is waiting\n");
+							break;
+						}
+
+					if(channel->length < channel->capacity)
+					{
+						STS_VALUE_REFINC(script, second_arg_value);
+						channel->values[(channel->start + channel->length++) % channel->capacity] = second_arg_value;
+						cli_coroutine_wake(&CLI_STATE(script)->scheduler, &channel->receivers, 0);
+						if(channel->length < channel->capacity) /* pass it on in case a woken sender got here first */
+							cli_coroutine_wake(&CLI_STATE(script)->scheduler, &channel->senders, 0);
+						if(channel->length) /* pass it on in case a woken receiver got here first */
+							cli_coroutine_wake(&CLI_STATE(script)->scheduler, &channel->receivers, 0);
+
+						VALUE_FROM_NUMBER(ret, 1.0);
+					}
 				}
 
-				base64_encode_ext(ret->string.data, ret->string.length + 1, eval_value->string.data, eval_value->string.length);
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the channel-send action");
+				if(!sts_value_reference_decrement(script, second_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the channel-send action");
 
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-encode action");
+				if(!ret)
+					return NULL;
 			}
-			else {STS_ERROR_SIMPLE("base64-encode requires a string"); return NULL;}
+			else {STS_ERROR_SIMPLE("channel-send action requires a channel and a value"); return NULL;}
 		}
-		ACTION(else if, "base64-decode") /* decodes a base64 encoded string */
+		ACTION(else if, "channel-recv") /* takes the oldest value out of a channel, waiting while it is empty */
 		{
-			/* doesnt use that padding detection removal thing in the static function because thats extra branching and honestly a few extra bytes allocated just doesnt matter */
-			#define B64_DSIZE(len) (len / 4 * 3)
-
 			GOTO_SET(&cli_actions);
 			if(args->next)
 			{
 				EVAL_ARG(args->next);
 
-				if(eval_value->type != STS_STRING)
+				if(!IS_CLI_CHANNEL(eval_value) || !CLI_STATE(script))
+					fprintf(stderr, "the channel-recv action requires a channel and can not be used on a worker\n");
+				else
 				{
-					fprintf(stderr, "the base64-decode action requires a string\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-decode action");
-					return NULL;
-				}
+					channel = CLI_CHANNEL(eval_value);
 
-				if(!(ret = sts_value_create(script, STS_STRING)))
-				{
-					fprintf(stderr, "could not create string value in base64-decode action\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-decode action");
-					return NULL;
+					while(!channel->length)
+						if(!cli_coroutine_wait(script, &channel->receivers, -1, 0))
+						{
+							fprintf(stderr, "deadlock in channel-recv. Every coroutine is waiting\n");
+							break;
+						}
+
+					if(channel->length)
+					{
+						ret = channel->values[channel->start]; /* the channel reference becomes the return reference */
+						channel->start = (channel->start + 1) % channel->capacity;
+						channel->length--;
+						cli_coroutine_wake(&CLI_STATE(script)->scheduler, &channel->senders, 0);
+						if(channel->length) /* pass it on in case a woken receiver got here first */
+							cli_coroutine_wake(&CLI_STATE(script)->scheduler, &channel->receivers, 0);
+					}
 				}
 
-				ret->string.length = B64_DSIZE(eval_value->string.length);
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the channel-recv action");
+
+				if(!ret)
+					return NULL;
+			}
+			else {STS_ERROR_SIMPLE("channel-recv action requires a channel"); return NULL;}
+		}
+		#ifndef CLI_NO_TIMERS
+		ACTION(else if, "timer-after") /* calls a function once ms milliseconds have passed. Returns a timer (ms, function) */
+		{
+			GOTO_SET(&cli_actions);
+			if(args->next && args->next->next)
+			{
+				EVAL_ARG(args->next);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
 
-				if(!(ret->string.data = calloc(1, ret->string.length + 1)))
+				if(first_arg_value->type != STS_NUMBER || eval_value->type != STS_FUNCTION || !CLI_STATE(script))
 				{
-					free(ret);
-					fprintf(stderr, "could not create string value data in base64-decode action\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-decode action");
+					fprintf(stderr, "the timer-after action requires a number of milliseconds and a function and can not be used on a worker\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the timer-after action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the timer-after action");
 					return NULL;
 				}
 
-				base64_decode_ext(ret->string.data, ret->string.length + 1, eval_value->string.data);
+				ret = cli_timer_start(script, eval_value, first_arg_value->number, 0);
 
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the base64-decode action");
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the timer-after action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the timer-after action");
+
+				if(!ret)
+					return NULL;
 			}
-			else {STS_ERROR_SIMPLE("base64-decode requires a string"); return NULL;}
+			else {STS_ERROR_SIMPLE("timer-after action requires a number of milliseconds and a function"); return NULL;}
 		}
-		ACTION(else if, "exit") /* exits the interpreter with a return value */
+		ACTION(else if, "timer-every") /* calls a function every ms milliseconds until the timer is cancelled. Returns a timer (ms, function) */
 		{
 			GOTO_SET(&cli_actions);
-			if(args->next)
+			if(args->next && args->next->next)
 			{
 				EVAL_ARG(args->next);
-				if(eval_value->type == STS_NUMBER )
-					exit(eval_value->number);
-				exit(0);
+				first_arg_value = eval_value;
+				EVAL_ARG(args->next->next);
 
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in exit action");
+				if(first_arg_value->type != STS_NUMBER || eval_value->type != STS_FUNCTION || !CLI_STATE(script))
+				{
+					fprintf(stderr, "the timer-every action requires a number of milliseconds and a function and can not be used on a worker\n");
+					if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the timer-every action");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the timer-every action");
+					return NULL;
+				}
+
+				ret = cli_timer_start(script, eval_value, first_arg_value->number, 1);
+
+				if(!sts_value_reference_decrement(script, first_arg_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the timer-every action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the second argument in the timer-every action");
+
+				if(!ret)
+					return NULL;
 			}
-			exit(0);
+			else {STS_ERROR_SIMPLE("timer-every action requires a number of milliseconds and a function"); return NULL;}
 		}
-		ACTION(else if, "directory-list") /* array of strings containing filenames of a directory string */
+		ACTION(else if, "timer-cancel") /* stops a timer from firing again. Returns nonzero if it already fired or was cancelled (timer) */
 		{
 			GOTO_SET(&cli_actions);
 			if(args->next)
 			{
-				#ifdef CLI_WINDOWS
-				WIN32_FIND_DATA fd;
-				HANDLE hf;
-				char *t_str = NULL;
-				size_t t_str_len = 0;
-				#else
-				DIR *d = NULL;
-				struct dirent *de = NULL;
-				#endif
-
 				EVAL_ARG(args->next);
 
-				if(eval_value->type != STS_STRING)
-				{
-					fprintf(stderr, "the directory-list action requires a string\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
-					return NULL;
-				}
-
-				if(!(ret = sts_value_create(script, STS_ARRAY)))
+				if(!IS_CLI_TIMER(eval_value))
 				{
-					fprintf(stderr, "could not create array value in directory-list action\n");
-					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
+					fprintf(stderr, "the timer-cancel action requires a timer\n");
+					if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the timer-cancel action");
 					return NULL;
 				}
 
-				#ifdef CLI_WINDOWS
-					t_str_len = eval_value->string.length + 2;
-					if(!(t_str = calloc(1, t_str_len + 1)))
-					{
-						fprintf(stderr, "could not create t_str directory-list action\n");
-						if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
-						return NULL;
-					}
-					strncat(t_str, eval_value->string.data, eval_value->string.length);
-					strncat(t_str, "\\*", 2);
-					if((hf = FindFirstFile(t_str, &fd)) == INVALID_HANDLE_VALUE)
-					{
-						sts_value_reference_decrement(script, ret);
-
-						if(!(ret = sts_value_create(script, STS_NIL)))
-						{
-							fprintf(stderr, "could not create nil value in directory-list action\n");
-							free(t_str);
-							if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
-							return NULL;
-						}
-					}
-					else
-					{
-						do
-						{
-							sts_value_t *str = NULL;
-							if(!(str = sts_value_from_string(script, df.cFileName)))
-							{
-								fprintf(stderr, "could not add string to array value in directory-list action\n");
-								free(t_str);
-								if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
-								return NULL;
-							}
-
-							sts_array_append_insert(script, ret, str, ret->array.length);
-						} while(FindNextFile(hf, &fd));
-					}
-					free(t_str);
-				#else
-					if(!(d = opendir(eval_value->string.data)))
-					{
-						sts_value_reference_decrement(script, ret);
-
-						if(!(ret = sts_value_create(script, STS_NIL)))
-						{
-							fprintf(stderr, "could not create nil value in directory-list action\n");
-							if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
-							return NULL;
-						}
-					}
-					else
-						while((de = readdir(d)))
-						{
-							sts_value_t *str = NULL;
-							if(!(str = sts_value_from_string(script, de->d_name)))
-							{
-								fprintf(stderr, "could not add string to array value in directory-list action\n");
-								if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
-								return NULL;
-							}
-
-							sts_array_append_insert(script, ret, str, ret->array.length);
-						}
-				#endif
+				VALUE_FROM_NUMBER(ret, cli_timers_cancel(script, &CLI_STATE(script)->timers, CLI_TIMER(eval_value)));
 
-				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the directory-list action");
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for the first argument in the timer-cancel action");
 			}
-			else {STS_ERROR_SIMPLE("directory-list requires a string"); return NULL;}
+			else {STS_ERROR_SIMPLE("timer-cancel action requires a timer"); return NULL;}
 		}
+		#endif /* CLI_NO_TIMERS */
+		#endif
 		ACTION(else if, "platform") /* returns the most likely platform */
 		{
 			#ifdef CLI_WINDOWS
@@ -2167,6 +8740,7 @@ sts_value_t *cli_actions(sts_script_t *script, sts_value_t *action, sts_node_t *
 				}
 			ACTION_END_ARGLOOP
 
+			sts_output_flush(script); /* the command writes to the same stdout */
 			VALUE_FROM_NUMBER(ret, (double)system(temp_str));
 
 			free(temp_str);
@@ -2190,6 +8764,7 @@ sts_value_t *cli_actions(sts_script_t *script, sts_value_t *action, sts_node_t *
 			}
 		ACTION_END_ARGLOOP
 
+		sts_output_flush(script); /* the command writes to the same stdout */
 		VALUE_FROM_NUMBER(ret, (double)system(temp_str));
 
 		free(temp_str);
@@ -2200,13 +8775,257 @@ sts_value_t *cli_actions(sts_script_t *script, sts_value_t *action, sts_node_t *
 }
 
 #ifndef NO_CLI_MAIN
+#ifndef CLI_NO_SERVE
+/* sts --serve N script.sts runs the top level of the script once and then forks N workers, so every worker starts
+out with the functions and globals it made. Each worker listens on its own socket bound to serve-port with
+SO_REUSEPORT, which has the kernel spread the connections over them, and calls on-connection with every client.
+The parent only restarts workers that exit until it is interrupted */
+
+volatile sig_atomic_t cli_serve_stopping = 0;
+
+void cli_serve_stop(int signal_number)
+{
+	cli_serve_stopping = 1;
+}
+
+int cli_serve_listen(unsigned short port)
+{
+	struct sockaddr_in address;
+	int fd, on = 1;
+
+
+	if((fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0)) == -1)
+		return -1;
+
+	memset(&address, 0, sizeof(struct sockaddr_in));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(port);
+
+	if(setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(int)) || setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(int)) || bind(fd, (struct sockaddr *)&address, sizeof(struct sockaddr_in)) || listen(fd, SOMAXCONN))
+	{
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+/* accepts forever. Every connection gets its own coroutine, so a worker keeps serving the others while one waits */
+void cli_serve_worker(sts_script_t *script, unsigned short port, sts_value_t *function)
+{
+	sts_value_t *client = NULL, *arguments = NULL;
+	#ifndef CLI_NO_COROUTINES
+	cli_coroutine_t *coroutine = NULL;
+	#else
+	sts_value_t *result = NULL;
+	#endif
+	int fd, handle;
+
+
+	if((fd = cli_serve_listen(port)) == -1)
+	{
+		fprintf(stderr, "worker %d could not listen on port %u: %s\n", (int)getpid(), port, strerror(errno));
+		return;
+	}
+
+	for(;;)
+	{
+		cli_coroutine_wait_fd(script, fd, POLLIN);
+
+		if((handle = accept4(fd, NULL, NULL, SOCK_CLOEXEC)) == -1)
+		{
+			if(errno != EINTR && errno != ECONNABORTED && errno != EAGAIN)
+			{
+				fprintf(stderr, "worker %d could not accept: %s\n", (int)getpid(), strerror(errno));
+				sleep(CLI_SERVE_RESTART_DELAY); /* out of descriptors most likely. Give the clients time to finish */
+			}
+			continue;
+		}
+
+		if(!(client = cli_socket_new(script)))
+		{
+			close(handle);
+			continue;
+		}
+		CLI_SOCKET(client)->socket.handle = handle;
+
+		if(!(arguments = sts_value_create(script, STS_ARRAY)))
+		{
+			sts_value_reference_decrement(script, client);
+			continue;
+		}
+		sts_array_append_insert(script, arguments, client, arguments->array.length);
+
+		#ifndef CLI_NO_COROUTINES
+		/* started right away so a flood of connections can't keep the ones already accepted from running */
+		if((coroutine = cli_coroutine_spawn(script, function, arguments)))
+		{
+			cli_coroutine_release(script, coroutine);
+			cli_coroutine_round(script, -1, 0);
+		}
+		else
+			fprintf(stderr, "could not start on-connection\n");
+		#else
+		if((result = sts_function_call(script, function, arguments)))
+			sts_value_reference_decrement(script, result);
+		else
+			fprintf(stderr, "on-connection failed\n");
+		#endif
+
+		sts_value_reference_decrement(script, arguments);
+		sts_output_flush(script);
+	}
+}
+
+pid_t cli_serve_fork(sts_script_t *script, unsigned short port, sts_value_t *function)
+{
+	pid_t ret;
+
+
+	if((ret = fork()))
+		return ret;
+
+	signal(SIGINT, SIG_DFL);
+	signal(SIGTERM, SIG_DFL);
+
+	#ifndef CLI_NO_THREADS
+	CLI_STATE(script)->pool = NULL; /* its threads were not forked. The worker starts its own the first time it needs one */
+	#endif
+
+	cli_serve_worker(script, port, function);
+
+	sts_output_flush(script);
+	exit(1);
+}
+
+/* forks the worker of a slot again after a worker died or could not be forked */
+void cli_serve_restart(sts_script_t *script, unsigned short port, sts_value_t *function, pid_t *pid, time_t *started, unsigned int slot)
+{
+	*pid = -1; /* the old one is reaped, so it must not be signalled when stopping */
+
+	/* one that dies right away would otherwise be restarted as fast as it can fork */
+	if(time(NULL) - *started < CLI_SERVE_RESTART_DELAY)
+		sleep(CLI_SERVE_RESTART_DELAY);
+
+	if(cli_serve_stopping)
+		return;
+
+	*started = time(NULL);
+	if((*pid = cli_serve_fork(script, port, function)) == -1)
+		fprintf(stderr, "could not fork worker %u: %s\n", slot, strerror(errno));
+}
+
+int cli_serve(sts_script_t *script, unsigned int workers)
+{
+	struct sigaction action;
+	sts_map_row_t *row = NULL;
+	sts_value_t *function = NULL;
+	time_t *started = NULL;
+	pid_t *pids = NULL, pid;
+	unsigned short port;
+	unsigned int i;
+	int status;
+
+
+	if(!(row = sts_map_get(&script->globals->locals, "on-connection", strlen("on-connection"))) || (function = row->value)->type != STS_FUNCTION)
+	{
+		fprintf(stderr, "--serve needs the script to define an on-connection function\n");
+		return 1;
+	}
+
+	if(!(row = sts_map_get(&script->globals->locals, "serve-port", strlen("serve-port"))) || ((sts_value_t *)row->value)->type != STS_NUMBER)
+	{
+		fprintf(stderr, "--serve needs the script to set serve-port to a number\n");
+		return 1;
+	}
+	port = (unsigned short)((sts_value_t *)row->value)->number;
+
+	if(!(pids = calloc(workers, sizeof(pid_t))) || !(started = calloc(workers, sizeof(time_t))))
+	{
+		fprintf(stderr, "could not allocate the worker list\n");
+		if(pids) free(pids);
+		return 1;
+	}
+
+	/* no restarting, so waitpid is interrupted when it is time to stop */
+	memset(&action, 0, sizeof(struct sigaction));
+	action.sa_handler = &cli_serve_stop;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+
+	/* anything buffered would be written again by every worker */
+	sts_output_flush(script);
+	fflush(NULL);
+
+	/* workers would share the timerfd and fire every timer once each, and the supervisor never runs them. Dropping
+	them here also lets it exit once the workers are stopped instead of running timer-every ones forever */
+	#ifndef CLI_NO_TIMERS
+	cli_timers_finish(script);
+	#endif
+
+	for(i = 0; i < workers; ++i)
+	{
+		started[i] = time(NULL);
+		if((pids[i] = cli_serve_fork(script, port, function)) == -1)
+			fprintf(stderr, "could not fork worker %u: %s\n", i, strerror(errno));
+	}
+
+	fprintf(stderr, "serving port %u with %u workers\n", port, workers);
+
+	while(!cli_serve_stopping)
+	{
+		for(i = 0; i < workers && pids[i] != -1; ++i);
+
+		/* while a slot has no worker, dead workers are only looked for between tries at forking it again */
+		if((pid = waitpid(-1, &status, i < workers ? WNOHANG : 0)) <= 0)
+		{
+			if(pid == -1 && errno == EINTR)
+				continue;
+			if(i == workers)
+				break;
+
+			cli_serve_restart(script, port, function, &pids[i], &started[i], i);
+			continue;
+		}
+
+		for(i = 0; i < workers && pids[i] != pid; ++i);
+		if(i == workers || cli_serve_stopping)
+			continue;
+
+		if(WIFSIGNALED(status))
+			fprintf(stderr, "worker %d was killed by signal %d. Restarting it\n", (int)pid, WTERMSIG(status));
+		else
+			fprintf(stderr, "worker %d exited with %d. Restarting it\n", (int)pid, WEXITSTATUS(status));
+
+		cli_serve_restart(script, port, function, &pids[i], &started[i], i);
+	}
+
+	for(i = 0; i < workers; ++i)
+		if(pids[i] > 0)
+			kill(pids[i], SIGTERM);
+	for(i = 0; i < workers; ++i)
+		if(pids[i] > 0)
+			waitpid(pids[i], &status, 0);
+
+	free(pids);
+	free(started);
+
+	return 0;
+}
+#endif
+
 int main(int argc, char **argv)
 {
 	int retval = 1;
 	sts_script_t script;
-	char *script_text = NULL;
-	unsigned int i, offset = 0, line = 0, length = 0;
+	cli_state_t state;
+	char *script_text = NULL, *mapped_text = NULL;
+	unsigned int i, offset = 0, line = 0, length = 0, first = 1;
 	sts_value_t *ret = NULL, *temp_val = NULL, *args = NULL;
+	#ifndef CLI_NO_SERVE
+	unsigned int serve = 0;
+	#endif
 
 
 
@@ -2217,16 +9036,24 @@ int main(int argc, char **argv)
 		STS_ERROR_SIMPLE("could not initialize networking");
 		return 1;
 	}
+
+	#ifndef CLI_WINDOWS
+	signal(SIGPIPE, SIG_IGN); /* a peer hanging up shows up as a send error instead of killing the interpreter */
+	#endif
 	#endif
 	
 	
 	memset(&script, 0, sizeof(sts_script_t));
+	memset(&state, 0, sizeof(cli_state_t));
+
+	script.userdata = &state;
 
 	/* set a read file callback */
 	script.read_file = &read_file;
 
 	/* initialize the router */
 	script.router = &cli_actions;
+	script.output.mode = isatty(STDOUT_FILENO) ? STS_OUTPUT_LINE : STS_OUTPUT_FULL; /* like stdio does it */
 
 	script.import_file = &import;
 	
@@ -2236,10 +9063,24 @@ int main(int argc, char **argv)
 		#ifndef CLI_NO_SOCKETS
 		zed_net_shutdown();
 		#endif
-		return repl(&script);
+		retval = repl(&script);
+		cli_state_cleanup(&state);
+		return retval;
 	}
 	else /* parse the arguments */
 	{
+		#ifndef CLI_NO_SERVE
+		if(!strcmp(argv[1], "--serve"))
+		{
+			if(argc < 4 || (int)(serve = atoi(argv[2])) < 1)
+			{
+				fprintf(stderr, "usage: %s --serve workers file.sts [args...]\n", argv[0]);
+				return 1;
+			}
+			first = 3;
+		}
+		#endif
+
 		/* need to initialize the globals here because theres something set before eval can do it instead */
 		STS_SCOPE_PUSH(script.globals, {fprintf(stderr, "could not initialize global scope"); return 1;});
 
@@ -2253,7 +9094,7 @@ int main(int argc, char **argv)
 		args->references++;
 		args->type = STS_ARRAY;
 
-		for(i = 2; i < argc; ++i)
+		for(i = first + 1; i < argc; ++i)
 		{
 			if(!(temp_val = calloc(1, sizeof(sts_value_t))))
 			{
@@ -2276,18 +9117,26 @@ int main(int argc, char **argv)
 		}
 	}
 	
-	/* open and read script text */
+	/* open and read script text. A mapped script is parsed straight from the page cache */
 	
-	if(!(script_text = read_file(&script, argv[1], &length)))
+	if(!(script_text = mapped_text = cli_map_file(argv[first], &length)) && !(script_text = read_file(&script, argv[first], &length)))
 	{
-		fprintf(stderr, "could not read file for parsing: %s\n", argv[1]);
+		fprintf(stderr, "could not read file for parsing: %s\n", argv[first]);
 		goto error;
 	}
 	
 	/* parse and eval */
 	
 	/* parse script */
-	if(!(script.script = sts_parse(&script, NULL, script_text, argv[1], &offset, &line)))
+	script.script = sts_parse(&script, NULL, script_text, argv[first], &offset, &line);
+
+	/* the ast has copies of everything it needs, so the script can't crash the interpreter by being truncated while it runs */
+	if(mapped_text)
+		cli_map_release(mapped_text);
+	else
+		free(script_text);
+
+	if(!script.script)
 	{
 		fprintf(stderr, "parser error\n");
 		goto error;
@@ -2302,10 +9151,17 @@ int main(int argc, char **argv)
 	if(ret && !sts_value_reference_decrement(&script, ret)) fprintf(stderr, "could not clean up returned value\n");
 	else if(!ret) fprintf(stderr, "script error\n");
 
+	/* the top level only set things up. The workers are forked from here */
+	#ifndef CLI_NO_SERVE
+	if(serve && ret)
+		retval = cli_serve(&script, serve);
+	#endif
+
 	/* cleanup */
+	cli_coroutine_finish(&script);
 	if(!sts_destroy(&script))
 		fprintf(stderr, "problem cleaning up script");
-	free(script_text);
+	cli_state_cleanup(&state);
 
 	
 	
@@ -2316,6 +9172,7 @@ int main(int argc, char **argv)
 	
 	return retval;
 error:
+	cli_state_cleanup(&state);
 	#ifndef CLI_NO_SOCKETS
 	zed_net_shutdown();
 	#endif
@@ -0,0 +1,160 @@
+/* this file is released into the public domain */
+
+/* stress test for sharing one frozen stdlib.sts between many scripts on many threads. The owner parses and
+evaluates stdlib.sts once, freezes it, and then every thread runs scripts that evaluate the frozen ast and a script
+of their own that parses literals against the shared intern table. Any race shows up in ThreadSanitizer
+
+build from the repo root with each of these, then run it from the repo root
+cc -g -O1 -fsanitize=thread -I. -o freeze_stress examples/embedding/freeze_stress.c -lm -lpthread
+cc -g -O1 -fsanitize=thread -I. -DSTS_GOTO_JIT -o freeze_stress examples/embedding/freeze_stress.c -lm -lpthread
+cc -g -O1 -fsanitize=thread -I. -DSTS_CYCLE_COLLECTOR -o freeze_stress examples/embedding/freeze_stress.c -lm -lpthread
+cc -g -O1 -fsanitize=thread -I. -DSTS_GOTO_JIT -DSTS_CYCLE_COLLECTOR -o freeze_stress examples/embedding/freeze_stress.c -lm -lpthread
+
+usage: ./freeze_stress (threads) (scripts per thread) (path to stdlib.sts) */
+
+#define STS_IMPLEMENTATION
+#include "simpletinyscript.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+
+sts_script_t owner;
+sts_node_t *stdlib_ast = NULL;
+unsigned int scripts = 25;
+
+/* every literal here is parsed by each script, so the ones stdlib.sts already has come from the shared table */
+char *user_text = "local m (hashmap a 1 b 2)\n"
+	"hashmap-set $m c (array 1 2 \"three\")\n"
+	"local t (string-tokenize \"a,b,c,d\" \",\")\n"
+	"local i 0\n"
+	"loop(< $i 50) {++ $i; eval \"local q (string-combine $t \\\"-\\\")\"}\n"
+	"pass (+ $i (sizeof $t))";
+
+char *read_file(sts_script_t *script, char *file, unsigned int *size)
+{
+	FILE *f = NULL;
+	char *ret = NULL;
+	long length;
+
+
+	if(!(f = fopen(file, "rb")))
+		return NULL;
+
+	fseek(f, 0, SEEK_END);
+	length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	if((ret = calloc(1, length + 1)) && fread(ret, 1, length, f) != (size_t)length)
+	{
+		free(ret);
+		ret = NULL;
+	}
+	fclose(f);
+
+	*size = (unsigned int)length;
+	return ret;
+}
+
+void *worker(void *data)
+{
+	sts_script_t script;
+	sts_node_t *ast = NULL;
+	sts_value_t *value = NULL;
+	unsigned int i, offset, line;
+
+
+	for(i = 0; i < scripts; ++i)
+	{
+		memset(&script, 0, sizeof(sts_script_t));
+		script.router = &sts_defaults;
+		script.read_file = &read_file;
+		script.shared = &owner;
+
+		if(!(value = sts_eval(&script, stdlib_ast, NULL, NULL, 0, 0)))
+		{
+			fprintf(stderr, "could not eval the frozen stdlib\n");
+			exit(1);
+		}
+		sts_value_reference_decrement(&script, value);
+
+		offset = line = 0;
+		if(!(ast = sts_parse(&script, NULL, user_text, "user", &offset, &line)))
+		{
+			fprintf(stderr, "could not parse the user script\n");
+			exit(1);
+		}
+
+		if(!(value = sts_eval(&script, ast, NULL, NULL, 0, 0)) || value->type != STS_NUMBER || value->number != 54.0)
+		{
+			fprintf(stderr, "wrong result from the user script\n");
+			exit(1);
+		}
+		sts_value_reference_decrement(&script, value);
+
+		sts_ast_delete(&script, ast);
+		if(!sts_destroy(&script))
+		{
+			fprintf(stderr, "could not destroy a script\n");
+			exit(1);
+		}
+	}
+
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	pthread_t *threads = NULL;
+	unsigned int count = 8, i, length = 0, offset = 0, line = 0;
+	sts_value_t *value = NULL;
+	char *text = NULL;
+
+
+	if(argc > 1) count = atoi(argv[1]);
+	if(argc > 2) scripts = atoi(argv[2]);
+
+	memset(&owner, 0, sizeof(sts_script_t));
+	owner.router = &sts_defaults;
+	owner.read_file = &read_file;
+
+	if(!(text = read_file(&owner, argc > 3 ? argv[3] : "stdlib.sts", &length)))
+	{
+		fprintf(stderr, "could not read stdlib.sts\n");
+		return 1;
+	}
+
+	if(!(stdlib_ast = sts_parse(&owner, NULL, text, "stdlib.sts", &offset, &line)))
+	{
+		fprintf(stderr, "could not parse stdlib.sts\n");
+		return 1;
+	}
+
+	/* evaluated once first so the goto jit has filled in its labels before the ast is frozen */
+	if((value = sts_eval(&owner, stdlib_ast, NULL, NULL, 0, 0)))
+		sts_value_reference_decrement(&owner, value);
+
+	sts_freeze(&owner, stdlib_ast);
+
+	if(!(threads = calloc(count, sizeof(pthread_t))))
+		return 1;
+
+	for(i = 0; i < count; ++i)
+		pthread_create(&threads[i], NULL, &worker, NULL);
+	for(i = 0; i < count; ++i)
+		pthread_join(threads[i], NULL);
+
+	/* every sharing script is gone, so the owner can clean up */
+	sts_thaw(&owner, stdlib_ast);
+	owner.script = stdlib_ast;
+	sts_destroy(&owner);
+
+	free(threads);
+	free(text);
+
+	printf("%u threads x %u scripts ok\n", count, scripts);
+
+	return 0;
+}
@@ -41,6 +41,23 @@ enum sts_row_types
 	STS_ROW_VOID
 };
 
+enum sts_output_modes
+{
+	STS_OUTPUT_LINE, /* hands the output over at every newline */
+	STS_OUTPUT_FULL, /* hands it over once the buffer reaches its size */
+	STS_OUTPUT_UNBUFFERED
+};
+
+#ifdef STS_CYCLE_COLLECTOR
+enum sts_gc_colors
+{
+	STS_GC_BLACK, /* in use or free */
+	STS_GC_GRAY, /* possible member of a cycle */
+	STS_GC_WHITE, /* member of a garbage cycle */
+	STS_GC_PURPLE /* possible root of a cycle */
+};
+#endif
+
 /* typedefs */
 
 typedef struct sts_script_t sts_script_t;
@@ -78,6 +95,7 @@ struct sts_node_t
 	#ifdef STS_GOTO_JIT
 	void *label;
 	sts_router_t router_id;
+	char frozen; /* frozen nodes may be shared between threads, so the jit leaves them alone */
 	#endif
 };
 
@@ -91,11 +109,15 @@ struct sts_name_container_t
 {
 	char *script_name;
 	unsigned int references;
+	char immortal;
 };
 
 struct sts_value_t
 {
-	char type, readonly:1;
+	char type, readonly:1, interned:1, immortal:1, mapped:1; /* interned values are weakly held by the intern table. Immortal values are never written to. Mapped strings point into a file mapping */
+	#ifdef STS_CYCLE_COLLECTOR
+	unsigned char gc_color:2, gc_buffered:1;
+	#endif
 	unsigned int references;
 	union
 	{
@@ -131,10 +153,30 @@ struct sts_script_t
 	void *userdata;
 	sts_node_t *script;
 	sts_scope_t *globals;
-	sts_map_row_t *interned; /* all parsed strings are interned */
+	sts_map_row_t *interned; /* all parsed strings are interned. Entries are dropped once only the table references them */
+	sts_script_t *shared; /* optional script with a frozen intern table that is searched before this one */
+	sts_map_row_t *snapshot; /* copies of the globals that sts_reset_to_snapshot in sts_embedding_extras.h puts back */
+	char snapshotted; /* set once there is a snapshot, since the one of empty globals is NULL */
 	char *(*read_file)(sts_script_t *script, char *file, unsigned int *size);
 	char *(*import_file)(sts_script_t *script, char *file);
 	sts_value_t *(*router)(sts_script_t *script, sts_value_t *action, sts_node_t *args, sts_scope_t *locals, sts_value_t **previous);
+	struct
+	{
+		char *data;
+		unsigned int length, allocated, size; /* a full buffer is handed over at size. 0 uses STS_OUTPUT_BUFFER_SIZE */
+		char mode;
+		void (*write)(sts_script_t *script, char *data, unsigned int length); /* takes the output instead of stdout, like to keep it in memory */
+	} output; /* what print and other script output goes through */
+	#ifdef STS_CYCLE_COLLECTOR
+	struct
+	{
+		sts_value_t **roots; /* arrays and functions that were decremented without being freed */
+		unsigned int roots_length, roots_allocated;
+		unsigned long allocations, threshold; /* a collection runs once allocations reaches the threshold. 0 uses STS_GC_THRESHOLD */
+		unsigned long collections, freed_values, freed_bytes;
+		double pause_last, pause_total; /* seconds */
+	} gc;
+	#endif
 };
 
 /* function prototypes */
@@ -160,9 +202,26 @@ sts_node_t *sts_ast_copy(sts_script_t *script, sts_node_t *node);
 /* delete an ast */
 void sts_ast_delete(sts_script_t *script, sts_node_t *node);
 
+/* make an ast, its values, and the interned strings of the script immutable so many scripts can eval it at once on different threads. Nothing may be parsed with the freezing script afterwards */
+int sts_freeze(sts_script_t *script, sts_node_t *ast);
+
+/* make a frozen ast mutable again so the owning script can be destroyed. Every script that used it has to be destroyed first */
+int sts_thaw(sts_script_t *script, sts_node_t *ast);
+
+/* queue script output and hand it to stdout or the output callback once the output mode says so */
+int sts_output_write(sts_script_t *script, char *data, unsigned int length);
+
+/* hand over all of the queued output now */
+int sts_output_flush(sts_script_t *script);
+
 /* decrement references recursively */
 int sts_value_reference_decrement(sts_script_t *script, sts_value_t *value);
 
+#ifdef STS_CYCLE_COLLECTOR
+/* free unreachable cycles among the possible roots. Returns the amount of values freed */
+unsigned long sts_gc_collect(sts_script_t *script);
+#endif
+
 /* copy values just once or recursively */
 int sts_value_copy(sts_script_t *script, sts_value_t *dest, sts_value_t *source, int recursive);
 
@@ -189,6 +248,9 @@ void *sts_memdup(void *src, unsigned int size);
 #include <ctype.h>
 #include <string.h>
 #include <math.h>
+#ifdef STS_CYCLE_COLLECTOR
+#include <time.h>
+#endif
 
 /* config */
 
@@ -222,11 +284,31 @@ void *sts_memdup(void *src, unsigned int size);
 #ifndef STS_FREE
 	#define STS_FREE free
 #endif
+
+#ifndef STS_UNMAP
+	#define STS_UNMAP(data, size) /* only embedders that create mapped strings need this and STS_MAP_SHARE, so neither is reached otherwise */
+#endif
+
+#ifndef STS_MAP_SHARE
+	#define STS_MAP_SHARE(data) (data)
+#endif
+
+#ifndef STS_OUTPUT_BUFFER_SIZE
+	#define STS_OUTPUT_BUFFER_SIZE 65536 /* size of a full output buffer when the script doesn't pick one */
+#endif
+
+#ifndef STS_GC_THRESHOLD
+	#define STS_GC_THRESHOLD 10000 /* value allocations between automatic collections */
+#endif
 /* util macros */
 
-#define STS_VALUE_REFINC(script_ptr, value_ptr) do{value_ptr->references++;}while(0)
+#define STS_VALUE_REFINC(script_ptr, value_ptr) do{if(!value_ptr->immortal) value_ptr->references++;}while(0)
 
-#define STS_CREATE_VALUE(value_ptr) (value_ptr = STS_CALLOC(1, sizeof(sts_value_t)))
+#ifdef STS_CYCLE_COLLECTOR
+	#define STS_CREATE_VALUE(value_ptr) ((value_ptr = STS_CALLOC(1, sizeof(sts_value_t))) ? (script->gc.allocations++, value_ptr) : NULL)
+#else
+	#define STS_CREATE_VALUE(value_ptr) (value_ptr = STS_CALLOC(1, sizeof(sts_value_t)))
+#endif
 
 #define STS_CREATE_NODE(node_ptr) (node_ptr = STS_CALLOC(1, sizeof(sts_node_t)))
 
@@ -250,6 +332,12 @@ void *sts_memdup(void *src, unsigned int size);
 		else{ if(!sts_value_reference_decrement(script, (value_ptr)->array.data[(position)])){ STS_ERROR_SIMPLE("could not refdec value at position specified"); on_error} memmove(&(value_ptr)->array.data[(position)], &(value_ptr)->array.data[(position) + 1], ((value_ptr)->array.length - ((position) + 1)) * sizeof(sts_value_t **)); (value_ptr)->array.length--;}	\
 	}while(0)
 
+/* mapped strings are one byte longer than their length so they always end in a 0 */
+#define STS_STRING_FREE(value) do{	\
+		if((value)->mapped){ STS_UNMAP((value)->string.data, (value)->string.length + 1); (value)->mapped = 0;}	\
+		else STS_FREE((value)->string.data);	\
+	}while(0)
+
 #define STS_VALUE_EXPECT_MUTABLE(value, on_not) do{	\
 		if((value)->readonly)	\
 		{	\
@@ -478,6 +566,9 @@ sts_value_t *sts_eval(sts_script_t *script, sts_node_t *ast, sts_scope_t *locals
 		case STS_NODE_EXPRESSION:
 			do
 			{
+				#ifdef STS_CYCLE_COLLECTOR
+				if(script->gc.allocations >= (script->gc.threshold ? script->gc.threshold : STS_GC_THRESHOLD)) sts_gc_collect(script);
+				#endif
 				if(ret) if(!sts_value_reference_decrement(script, ret)){STS_ERROR_SIMPLE("could not decrement references for previous value"); return NULL;} /* if this is a list of expressions, the previous value needs to be destroyed before another is run */
 				if(!ast->child){ret = *previous; STS_VALUE_REFINC(script, (*previous)); return ret;} /* substitute the previous value as the return value */
 				else if(ast->child->type != STS_NODE_EXPRESSION) /* an expression with a starting value */
@@ -503,18 +594,81 @@ sts_value_t *sts_eval(sts_script_t *script, sts_node_t *ast, sts_scope_t *locals
 	return ret;
 }
 
+int sts_output_flush(sts_script_t *script)
+{
+	int ret = 0;
+	if(script->output.length)
+	{
+		if(script->output.write) script->output.write(script, script->output.data, script->output.length);
+		else if(fwrite(script->output.data, 1, script->output.length, stdout) != script->output.length) ret = 1;
+		script->output.length = 0;
+	}
+	if(!script->output.write && fflush(stdout)) ret = 1;
+	return ret;
+}
+
+int sts_output_write(sts_script_t *script, char *data, unsigned int length)
+{
+	unsigned int size = script->output.size ? script->output.size : STS_OUTPUT_BUFFER_SIZE;
+	char *temp = NULL;
+	if(script->output.mode == STS_OUTPUT_UNBUFFERED || (!script->output.length && length >= size)) /* nothing would be gained from copying it first */
+	{
+		if(script->output.write){ script->output.write(script, data, length); return 0;}
+		return fwrite(data, 1, length, stdout) != length || fflush(stdout);
+	}
+	if(script->output.length + length > script->output.allocated)
+	{
+		if(!(temp = STS_REALLOC(script->output.data, script->output.length + length > size ? script->output.length + length : size))){ STS_ERROR_SIMPLE("could not grow the output buffer"); return 1;}
+		script->output.data = temp; script->output.allocated = script->output.length + length > size ? script->output.length + length : size;
+	}
+	memcpy(&script->output.data[script->output.length], data, length); script->output.length += length;
+	if(script->output.length >= size || (script->output.mode == STS_OUTPUT_LINE && memchr(data, '\n', length))) return sts_output_flush(script);
+	return 0;
+}
+
 int sts_destroy(sts_script_t *script)
 {
+	sts_map_row_t *row = NULL;
+	if(sts_output_flush(script)) STS_ERROR_SIMPLE("could not flush the script output");
+	STS_FREE(script->output.data); script->output.data = NULL; script->output.length = script->output.allocated = 0;
 	if(script->globals) STS_SCOPE_POP(script->globals, {STS_ERROR_SIMPLE("could not clean up globals");});
+	if(script->snapshot){ STS_DESTROY_MAP(script->snapshot, {STS_ERROR_SIMPLE("could not clean up the globals snapshot");}); script->snapshot = NULL;}
+	script->snapshotted = 0;
 	sts_ast_delete(script, script->script);
-	if(script->interned) STS_DESTROY_MAP(script->interned, {STS_ERROR_SIMPLE("could not clean up interned string data"); return 0;});
+	#ifdef STS_CYCLE_COLLECTOR
+	sts_gc_collect(script); /* nothing is reachable anymore, so whatever is left in the buffer is garbage or a freed shell */
+	STS_FREE(script->gc.roots); script->gc.roots = NULL; script->gc.roots_length = script->gc.roots_allocated = 0;
+	#endif
+	if(script->interned)
+	{
+		for(row = script->interned; row; row = row->next) ((sts_value_t *)row->value)->interned = 0; /* the table is going away, so nothing should try to unlink from it */
+		STS_DESTROY_MAP(script->interned, {STS_ERROR_SIMPLE("could not clean up interned string data"); return 0;});
+		script->interned = NULL;
+	}
 	return 1;
 }
 
 int sts_value_reference_decrement(sts_script_t *script, sts_value_t *value)
 {
 	unsigned int i;
+	sts_map_row_t *row = NULL, *previous = NULL;
+	#ifdef STS_CYCLE_COLLECTOR
+	sts_value_t **roots = NULL;
+	#endif
 	if(!value) return 0;
+	if(value->immortal) return 1;
+	if(value->interned && value->references == 2) /* the last user is letting go and only the intern table would be left, so unlink it */
+	{
+		for(row = script->interned; row && row->value != value; previous = row, row = row->next);
+		if(row)
+		{
+			if(previous) previous->next = row->next;
+			else script->interned = row->next;
+			STS_FREE(row);
+			value->references--;
+		}
+		value->interned = 0;
+	}
 	if(!value->references || !--value->references)
 	{
 		switch(value->type)
@@ -525,7 +679,7 @@ int sts_value_reference_decrement(sts_script_t *script, sts_value_t *value)
 				STS_FREE(value->array.data);
 			break;
 			case STS_STRING:
-				STS_FREE(value->string.data);
+				STS_STRING_FREE(value);
 			break;
 			case STS_EXTERNAL:
 				if(value->external.refdec) value->external.refdec(script, value);
@@ -540,11 +694,133 @@ int sts_value_reference_decrement(sts_script_t *script, sts_value_t *value)
 				}
 			break;
 		}
+		#ifdef STS_CYCLE_COLLECTOR
+		if(value->gc_buffered){ value->type = STS_NIL; value->gc_color = STS_GC_BLACK; return 1;} /* the root buffer still points here, so the collector frees the shell */
+		#endif
 		STS_FREE(value);
 	}
+	#ifdef STS_CYCLE_COLLECTOR
+	else if(value->type == STS_ARRAY || value->type == STS_FUNCTION) /* anything that survives a decrement could be part of a garbage cycle */
+	{
+		value->gc_color = STS_GC_PURPLE;
+		if(!value->gc_buffered)
+		{
+			if(script->gc.roots_length + 1 > script->gc.roots_allocated)
+			{
+				/* the buffer and everything in it stays as it was. This value just isnt a candidate until its next decrement */
+				if(!(roots = STS_REALLOC(script->gc.roots, (script->gc.roots_allocated + 64) * sizeof(sts_value_t *)))){ STS_ERROR_SIMPLE("could not grow the cycle collector root buffer"); return 1;}
+				script->gc.roots = roots;
+				script->gc.roots_allocated += 64;
+			}
+			script->gc.roots[script->gc.roots_length++] = value; value->gc_buffered = 1;
+		}
+	}
+	#endif
 	return 1;
 }
 
+#ifdef STS_CYCLE_COLLECTOR
+/* synchronous trial deletion (Bacon and Rajan, 2001). Only arrays and function argument arrays hold references to other values. Function bodies are never traced because literals cannot point back at a cycle */
+#define STS_GC_CHILDREN(value, child, body) do{ unsigned int gc_i;	\
+		if((value)->type == STS_ARRAY){ for(gc_i = 0; gc_i < (value)->array.length; ++gc_i){ (child) = (value)->array.data[gc_i]; if(!(child)->immortal){body} } }	\
+		else if((value)->type == STS_FUNCTION && (value)->function.argument_identifiers){ (child) = (value)->function.argument_identifiers; {body} }	\
+	}while(0)
+
+void sts_gc_mark_gray(sts_value_t *value)
+{
+	sts_value_t *child = NULL;
+	if(value->gc_color == STS_GC_GRAY) return;
+	value->gc_color = STS_GC_GRAY;
+	STS_GC_CHILDREN(value, child, {child->references--; sts_gc_mark_gray(child);});
+}
+
+void sts_gc_scan_black(sts_value_t *value)
+{
+	sts_value_t *child = NULL;
+	value->gc_color = STS_GC_BLACK;
+	STS_GC_CHILDREN(value, child, {child->references++; if(child->gc_color != STS_GC_BLACK) sts_gc_scan_black(child);});
+}
+
+void sts_gc_scan(sts_value_t *value)
+{
+	sts_value_t *child = NULL;
+	if(value->gc_color != STS_GC_GRAY) return;
+	if(value->references) sts_gc_scan_black(value);
+	else
+	{
+		value->gc_color = STS_GC_WHITE;
+		STS_GC_CHILDREN(value, child, {sts_gc_scan(child);});
+	}
+}
+
+/* white values are gathered first and freed afterwards so no freed value is ever looked at. gc_buffered marks a value as already gathered */
+int sts_gc_collect_white(sts_value_t *value, sts_value_t ***garbage, unsigned int *length, unsigned int *allocated)
+{
+	sts_value_t *child = NULL;
+	if(value->gc_color != STS_GC_WHITE || value->gc_buffered) return 1;
+	if(*length + 1 > *allocated)
+	{
+		if(!(*garbage = STS_REALLOC(*garbage, (*allocated + 64) * sizeof(sts_value_t *)))) return 0;
+		*allocated += 64;
+	}
+	(*garbage)[(*length)++] = value; value->gc_buffered = 1;
+	STS_GC_CHILDREN(value, child, {if(!sts_gc_collect_white(child, garbage, length, allocated)) return 0;});
+	return 1;
+}
+
+unsigned long sts_gc_collect(sts_script_t *script)
+{
+	unsigned int i, length = 0, garbage_length = 0, garbage_allocated = 0;
+	sts_value_t **roots = NULL, **garbage = NULL, *value = NULL, *child = NULL;
+	clock_t start = clock();
+	for(i = 0; i < script->gc.roots_length; ++i) /* mark roots */
+	{
+		value = script->gc.roots[i];
+		if(value->gc_color == STS_GC_PURPLE && value->references){ sts_gc_mark_gray(value); script->gc.roots[length++] = value;}
+		else
+		{
+			value->gc_buffered = 0;
+			if(value->gc_color == STS_GC_BLACK && !value->references) STS_FREE(value);
+		}
+	}
+	for(i = 0; i < length; ++i) sts_gc_scan(script->gc.roots[i]); /* scan roots */
+	roots = script->gc.roots; script->gc.roots = NULL; script->gc.roots_length = script->gc.roots_allocated = 0; /* releasing garbage can buffer new roots */
+	for(i = 0; i < length; ++i) roots[i]->gc_buffered = 0;
+	for(i = 0; i < length; ++i) /* collect roots */
+		if(!sts_gc_collect_white(roots[i], &garbage, &garbage_length, &garbage_allocated)){ STS_ERROR_SIMPLE("could not grow the cycle collector garbage list"); break;}
+	STS_FREE(roots);
+	for(i = 0; i < garbage_length; ++i) /* drop references to values that survive and release anything that isnt another value */
+	{
+		value = garbage[i];
+		STS_GC_CHILDREN(value, child, {if(child->gc_color != STS_GC_WHITE || !child->gc_buffered){ child->references++; if(!sts_value_reference_decrement(script, child)) STS_ERROR_SIMPLE("could not decrement references for a value outside of a garbage cycle");} });
+		script->gc.freed_bytes += sizeof(sts_value_t);
+		switch(value->type)
+		{
+			case STS_ARRAY: script->gc.freed_bytes += value->array.allocated * sizeof(sts_value_t *); break;
+			case STS_STRING: script->gc.freed_bytes += value->string.length; STS_STRING_FREE(value); break;
+			case STS_EXTERNAL: if(value->external.refdec) value->external.refdec(script, value); break;
+			case STS_FUNCTION:
+				if(value->function.body && ((--value->function.body->references) <= 0))
+				{
+					sts_ast_delete(script, value->function.body->node);
+					STS_FREE(value->function.body);
+				}
+			break;
+		}
+	}
+	for(i = 0; i < garbage_length; ++i)
+	{
+		if(garbage[i]->type == STS_ARRAY) STS_FREE(garbage[i]->array.data);
+		STS_FREE(garbage[i]);
+	}
+	STS_FREE(garbage);
+	script->gc.freed_values += garbage_length;
+	script->gc.collections++; script->gc.allocations = 0;
+	script->gc.pause_last = (double)(clock() - start) / CLOCKS_PER_SEC; script->gc.pause_total += script->gc.pause_last;
+	return garbage_length;
+}
+#endif
+
 sts_value_t *sts_defaults(sts_script_t *script, sts_value_t *action, sts_node_t *args, sts_scope_t *locals, sts_value_t **previous)
 {
 	unsigned int i = 0, can_loop = 0, temp_uint = 0, temp0_uint = 0;
@@ -553,8 +829,8 @@ sts_value_t *sts_defaults(sts_script_t *script, sts_value_t *action, sts_node_t
 	sts_map_row_t *row = NULL, *new_locals = NULL;
 	sts_ast_container_t *temp_container = NULL;
 	sts_value_t *ret = NULL, *eval_value = NULL, *temp_value_arg = NULL, *temp_value = NULL;
-	#define EVAL_ARG(argument) do{if(!(eval_value = sts_eval(script, argument, locals, previous, 1, 0))){STS_ERROR_SIMPLE("could not eval argument"); } }while(0)
-	#define EVAL_ARG_ALL(argument) do{if(!(eval_value = sts_eval(script, argument, locals, previous, 0, 0))){STS_ERROR_SIMPLE("could not eval argument"); } }while(0)
+	#define EVAL_ARG(argument) do{if(!(eval_value = sts_eval(script, argument, locals, previous, 1, 0))){STS_ERROR_SIMPLE("could not eval argument"); return NULL;} }while(0)
+	#define EVAL_ARG_ALL(argument) do{if(!(eval_value = sts_eval(script, argument, locals, previous, 0, 0))){STS_ERROR_SIMPLE("could not eval argument"); return NULL;} }while(0)
 	#define VALUE_FROM_NUMBER(value_ptr, set_number) do{if(!(STS_CREATE_VALUE(value_ptr))) STS_ERROR_SIMPLE("could not create value for number"); else{value_ptr->references = 1; value_ptr->type = STS_NUMBER; value_ptr->number = (double)(set_number);} }while(0)
 	#define VALUE_INIT(value_ptr, set_type) do{if(!(STS_CREATE_VALUE(value_ptr))) STS_ERROR_SIMPLE("could not create and initialize value"); else{value_ptr->references = 1; value_ptr->type = set_type;} }while(0)
 	#define ACTION(test, str) test(strcmp(str, action->string.data) == 0)
@@ -564,7 +840,7 @@ sts_value_t *sts_defaults(sts_script_t *script, sts_value_t *action, sts_node_t
 	#ifdef STS_GOTO_JIT
 		#define GOTO_LABEL_CAT_(a, b) a ## b
 		#define GOTO_LABEL_CAT(a, b) GOTO_LABEL_CAT_(a, b)
-		#define GOTO_SET(id) do{args->label = && GOTO_LABEL_CAT(sts_jit_, __LINE__); args->router_id = (void *)(id); GOTO_LABEL_CAT(sts_jit_, __LINE__):;}while(0)
+		#define GOTO_SET(id) do{if(!args->frozen){args->label = && GOTO_LABEL_CAT(sts_jit_, __LINE__); args->router_id = (void *)(id);} GOTO_LABEL_CAT(sts_jit_, __LINE__):;}while(0)
 		#define GOTO_JMP(id) do{if(args->router_id == (void *)(id)){goto *(args->label);}}while(0)
 		#define GOTO_ACTIVATED (args->router_id)
 	#else
@@ -593,8 +869,7 @@ sts_value_t *sts_defaults(sts_script_t *script, sts_value_t *action, sts_node_t
 				}
 			ACTION_END_ARGLOOP
 			STS_STRING_ASSEMBLE(temp_str, temp_uint, "\n", 1, "", 0);
-			for(i = 0; i < temp_uint; ++i)
-				fputc(temp_str[i], stdout);
+			if(sts_output_write(script, temp_str, temp_uint)) STS_ERROR_SIMPLE("could not write the output of the print action");
 			STS_FREE(temp_str);
 			VALUE_FROM_NUMBER(ret, 1);
 		}
@@ -1100,6 +1375,74 @@ sts_value_t *sts_defaults(sts_script_t *script, sts_value_t *action, sts_node_t
 			}
 			else {STS_ERROR_SIMPLE("call action requires at least 1 argument"); return NULL;}
 		}
+		ACTION(else if, "runtime-intern-stats") /* returns the interned string count and the bytes they hold */
+		{
+			GOTO_SET(&sts_defaults);
+			for(row = script->interned; row; row = row->next)
+			{
+				++temp_uint; temp0_uint += ((sts_value_t *)row->value)->string.length;
+			}
+			VALUE_INIT(ret, STS_ARRAY); if(!ret){STS_ERROR_SIMPLE("could not create array for runtime-intern-stats action"); return NULL;}
+			VALUE_FROM_NUMBER(temp_value, temp_uint); STS_ARRAY_APPEND_INSERT(ret, temp_value, 0);
+			VALUE_FROM_NUMBER(temp_value, temp0_uint); STS_ARRAY_APPEND_INSERT(ret, temp_value, 1);
+		}
+		ACTION(else if, "output-mode") /* "line", "full" with an optional buffer size, or "none". Returns the old mode */
+		{
+			GOTO_SET(&sts_defaults);
+			VALUE_INIT(ret, STS_STRING); if(!ret){STS_ERROR_SIMPLE("could not create string for output-mode action"); return NULL;}
+			temp_str = script->output.mode == STS_OUTPUT_LINE ? "line" : script->output.mode == STS_OUTPUT_FULL ? "full" : "none";
+			ret->string.data = sts_memdup(temp_str, strlen(temp_str)); ret->string.length = strlen(temp_str); temp_str = NULL;
+			if(args->next)
+			{
+				EVAL_ARG(args->next); temp_value_arg = eval_value;
+				if(args->next->next) EVAL_ARG(args->next->next); else eval_value = NULL;
+				if(temp_value_arg->type != STS_STRING || (strcmp(temp_value_arg->string.data, "line") && strcmp(temp_value_arg->string.data, "full") && strcmp(temp_value_arg->string.data, "none")) || (eval_value && (eval_value->type != STS_NUMBER || eval_value->number < 0)))
+					STS_ERROR_SIMPLE("output-mode action requires \"line\", \"full\", or \"none\" and optionally a positive buffer size");
+				else
+				{
+					if(sts_output_flush(script)) STS_ERROR_SIMPLE("could not flush the script output in output-mode action");
+					script->output.mode = !strcmp(temp_value_arg->string.data, "line") ? STS_OUTPUT_LINE : !strcmp(temp_value_arg->string.data, "full") ? STS_OUTPUT_FULL : STS_OUTPUT_UNBUFFERED;
+					if(eval_value) script->output.size = (unsigned int)eval_value->number;
+				}
+				if(!sts_value_reference_decrement(script, temp_value_arg)) STS_ERROR_SIMPLE("could not decrement references for first argument in output-mode action");
+				if(eval_value && !sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for second argument in output-mode action");
+			}
+		}
+		ACTION(else if, "output-flush") /* hands over everything print has queued */
+		{
+			GOTO_SET(&sts_defaults);
+			VALUE_FROM_NUMBER(ret, sts_output_flush(script));
+		}
+		#ifdef STS_CYCLE_COLLECTOR
+		ACTION(else if, "gc-collect") /* runs the cycle collector now and returns the amount of values freed */
+		{
+			GOTO_SET(&sts_defaults);
+			VALUE_FROM_NUMBER(ret, sts_gc_collect(script));
+		}
+		ACTION(else if, "gc-stats") /* [collections values_freed bytes_freed last_pause_ms total_pause_ms possible_roots] */
+		{
+			GOTO_SET(&sts_defaults);
+			VALUE_INIT(ret, STS_ARRAY); if(!ret){STS_ERROR_SIMPLE("could not create array for gc-stats action"); return NULL;}
+			VALUE_FROM_NUMBER(temp_value, script->gc.collections); STS_ARRAY_APPEND_INSERT(ret, temp_value, 0);
+			VALUE_FROM_NUMBER(temp_value, script->gc.freed_values); STS_ARRAY_APPEND_INSERT(ret, temp_value, 1);
+			VALUE_FROM_NUMBER(temp_value, script->gc.freed_bytes); STS_ARRAY_APPEND_INSERT(ret, temp_value, 2);
+			VALUE_FROM_NUMBER(temp_value, script->gc.pause_last * 1000.0); STS_ARRAY_APPEND_INSERT(ret, temp_value, 3);
+			VALUE_FROM_NUMBER(temp_value, script->gc.pause_total * 1000.0); STS_ARRAY_APPEND_INSERT(ret, temp_value, 4);
+			VALUE_FROM_NUMBER(temp_value, script->gc.roots_length); STS_ARRAY_APPEND_INSERT(ret, temp_value, 5);
+		}
+		ACTION(else if, "gc-threshold") /* sets how many allocations trigger a collection and returns the old amount. 0 restores the default */
+		{
+			GOTO_SET(&sts_defaults);
+			VALUE_FROM_NUMBER(ret, script->gc.threshold ? script->gc.threshold : STS_GC_THRESHOLD);
+			if(args->next)
+			{
+				EVAL_ARG(args->next);
+				if(eval_value->type != STS_NUMBER || eval_value->number < 0) STS_ERROR_SIMPLE("gc-threshold action requires a positive number");
+				else script->gc.threshold = (unsigned long)eval_value->number;
+				if(!sts_value_reference_decrement(script, eval_value)) STS_ERROR_SIMPLE("could not decrement references for first argument in gc-threshold action");
+			}
+		}
+		#endif
 		ACTION(else if, "&&")
 		{
 			GOTO_SET(&sts_defaults);
@@ -1289,8 +1632,8 @@ int sts_ast_apply_name(sts_script_t *script, sts_node_t *node, sts_name_containe
 {
 	do
 	{
-		if(node->name && (--node->name->references) <= 0) STS_FREE(node->name);
-		node->name = name; name->references++;
+		if(node->name && !node->name->immortal && (--node->name->references) <= 0) STS_FREE(node->name);
+		node->name = name; if(!name->immortal) name->references++;
 		if(node->child && sts_ast_apply_name(script, node->child, name)) return 1;
 	} while((node = node->next));
 
@@ -1324,7 +1667,7 @@ sts_node_t *sts_ast_copy(sts_script_t *script, sts_node_t *node)
 		progress_node->type = node->type;
 		progress_node->value = node->value;
 		progress_node->name = node->name;
-		node->name->references++;
+		if(!node->name->immortal) node->name->references++;
 		switch(node->type)
 		{
 			case STS_NODE_EXPRESSION:
@@ -1364,13 +1707,47 @@ void sts_ast_delete(sts_script_t *script, sts_node_t *node)
 					STS_ERROR_SIMPLE("could not decrement references in ast");
 			break;
 		}
-		if((--node->name->references) <= 0){ STS_FREE(node->name->script_name); STS_FREE(node->name);}
+		if(!node->name->immortal && (--node->name->references) <= 0){ STS_FREE(node->name->script_name); STS_FREE(node->name);}
 		temp = node;
 		node = node->next;
 		STS_FREE(temp);
 	} while(node);
 }
 
+int sts_freeze(sts_script_t *script, sts_node_t *ast)
+{
+	sts_map_row_t *row = NULL;
+	for(row = script->interned; row; row = row->next){ ((sts_value_t *)row->value)->readonly = 1; ((sts_value_t *)row->value)->immortal = 1;}
+	if(!ast) return 1;
+	do
+	{
+		if(ast->child && !sts_freeze(script, ast->child)) return 0;
+		else if(ast->value){ ast->value->readonly = 1; ast->value->immortal = 1;}
+		if(ast->name) ast->name->immortal = 1;
+		#ifdef STS_GOTO_JIT
+		ast->frozen = 1;
+		#endif
+	} while((ast = ast->next));
+	return 1;
+}
+
+int sts_thaw(sts_script_t *script, sts_node_t *ast)
+{
+	sts_map_row_t *row = NULL;
+	for(row = script->interned; row; row = row->next) ((sts_value_t *)row->value)->immortal = 0;
+	if(!ast) return 1;
+	do
+	{
+		if(ast->child && !sts_thaw(script, ast->child)) return 0;
+		else if(ast->value) ast->value->immortal = 0;
+		if(ast->name) ast->name->immortal = 0;
+		#ifdef STS_GOTO_JIT
+		ast->frozen = 0;
+		#endif
+	} while((ast = ast->next));
+	return 1;
+}
+
 int sts_value_copy(sts_script_t *script, sts_value_t *dest, sts_value_t *source, int recursive)
 {
 	sts_value_t *temp = NULL; unsigned int i; int ret = 0;
@@ -1384,7 +1761,7 @@ int sts_value_copy(sts_script_t *script, sts_value_t *dest, sts_value_t *source,
 			}
 			if(dest->array.data) STS_FREE(dest->array.data); dest->array.data = NULL; dest->array.length = dest->array.allocated = 0;
 		break;
-		case STS_STRING: if(dest->string.data) STS_FREE(dest->string.data); break;
+		case STS_STRING: if(dest->string.data) STS_STRING_FREE(dest); break;
 		case STS_EXTERNAL: if(dest->external.refdec) if(dest->external.refdec((script), dest)) STS_ERROR_SIMPLE("could not decrement external data"); break;
 		case STS_FUNCTION:
 			if(dest->function.argument_identifiers) if(!sts_value_reference_decrement(script, dest->function.argument_identifiers)) STS_ERROR_SIMPLE("could not decrement references for argument identifiers in the destination value");
@@ -1420,7 +1797,11 @@ int sts_value_copy(sts_script_t *script, sts_value_t *dest, sts_value_t *source,
 				}
 			}
 		break;
-		case STS_STRING: if(source->string.data) dest->string.data = sts_memdup(source->string.data, source->string.length); dest->string.length = source->string.length; break;
+		case STS_STRING:
+			if(source->mapped){ dest->string.data = STS_MAP_SHARE(source->string.data); dest->mapped = 1;} /* strings are never written in place, so copies share the mapping */
+			else if(source->string.data) dest->string.data = sts_memdup(source->string.data, source->string.length);
+			dest->string.length = source->string.length;
+		break;
 		case STS_EXTERNAL: memmove(&dest->external, &source->external, sizeof(source->external)); if(source->external.refinc) source->external.refinc((script), source); break;
 		case STS_FUNCTION:
 			dest->function.body = source->function.body;
@@ -1472,6 +1853,11 @@ sts_value_t *sts_value_string_intern(sts_script_t *script, sts_value_t *value)
 		STS_ERROR_SIMPLE("cannot intern non-string value");
 		return NULL;
 	}
+	if(script->shared && (row = sts_map_get(&script->shared->interned, value->string.data, value->string.length))) /* frozen strings are immortal, so nothing needs to be counted */
+	{
+		sts_value_reference_decrement(script, value);
+		return row->value;
+	}
 	if(!(row = sts_map_get(&script->interned, value->string.data, value->string.length)))
 	{
 		if(!sts_map_add_set(&script->interned, value->string.data, value->string.length, value))
@@ -1479,7 +1865,7 @@ sts_value_t *sts_value_string_intern(sts_script_t *script, sts_value_t *value)
 			STS_ERROR_SIMPLE("could not intern string");
 			return NULL;
 		}
-		value->readonly = 1;
+		value->readonly = 1; value->interned = 1;
 	}
 	else
 	{
@@ -42,6 +42,29 @@ int sts_hashmap_del(sts_script_t *script, sts_value_t *hashmap, char *key, unsig
 
 sts_value_t *sts_hashmap_get(sts_script_t *script, sts_value_t *hashmap, char *key, unsigned int key_length);
 
+/* deep copies a value so that it belongs to another script, which can be on another thread. Externals can't be copied and arrays must not contain themselves */
+sts_value_t *sts_value_marshal(sts_script_t *script, sts_value_t *value);
+
+/* deep copies an ast including its literals. Pass NULL as the name to give the copy its own name container */
+sts_node_t *sts_ast_marshal(sts_script_t *script, sts_node_t *node, sts_name_container_t *name);
+
+/* calls a function value with an array of arguments from the global scope */
+sts_value_t *sts_function_call(sts_script_t *script, sts_value_t *function, sts_value_t *arguments);
+
+/* copies an array and every array in it. visited maps each source array to its copy, so an array reached twice, or
+from inside itself, is copied once. Free visited with STS_DESTROY_MAP, it holds no references */
+sts_value_t *sts_array_copy_visited(sts_script_t *script, sts_value_t *source, sts_map_row_t **visited);
+
+/* copies every value of a map into a new one in the same order. Arrays are copied recursively, keeping arrays that are
+shared or contain themselves that way in the copy. Returns 0 on success */
+int sts_map_copy_values(sts_script_t *script, sts_map_row_t **dest, sts_map_row_t *source);
+
+/* keeps a copy of the globals, like after a warm up that imported stdlib.sts, replacing any older snapshot. Returns 1 on success */
+int sts_snapshot(sts_script_t *script);
+
+/* throws away the globals along with everything only they reference and puts a fresh copy of the snapshot in their place. Returns 1 on success */
+int sts_reset_to_snapshot(sts_script_t *script);
+
 #endif /* end STS_EMBEDDING_EXTRAS_H__ */
 
 #ifdef STS_EMBEDDING_EXTRAS_IMPLEMENTATION
@@ -408,4 +431,398 @@ sts_value_t *sts_hashmap_get(sts_script_t *script, sts_value_t *hashmap, char *k
 	return ret;
 }
 
-#endif
\ No newline at end of file
+sts_value_t *sts_value_marshal(sts_script_t *script, sts_value_t *value)
+{
+	sts_value_t *ret = NULL, *temp = NULL;
+	unsigned int i;
+
+
+	if(!value)
+		return NULL;
+
+	switch(value->type)
+	{
+		case STS_STRING:
+			return sts_value_from_nstring(script, value->string.data, value->string.length);
+		case STS_ARRAY:
+			if(!(ret = sts_value_create(script, STS_ARRAY)))
+			{
+				STS_ERROR_SIMPLE("could not create array to marshal into");
+				return NULL;
+			}
+
+			for(i = 0; i < value->array.length; ++i)
+			{
+				if(!(temp = sts_value_marshal(script, value->array.data[i])))
+				{
+					STS_ERROR_SIMPLE("could not marshal array member");
+					sts_value_reference_decrement(script, ret);
+					return NULL;
+				}
+
+				sts_array_append_insert(script, ret, temp, ret->array.length);
+			}
+		break;
+		case STS_FUNCTION:
+			if(!(ret = sts_value_create(script, STS_FUNCTION)))
+			{
+				STS_ERROR_SIMPLE("could not create function to marshal into");
+				return NULL;
+			}
+
+			if(!(ret->function.argument_identifiers = sts_value_marshal(script, value->function.argument_identifiers)) || !(ret->function.body = calloc(1, sizeof(sts_ast_container_t))))
+			{
+				STS_ERROR_SIMPLE("could not marshal function arguments");
+				sts_value_reference_decrement(script, ret);
+				return NULL;
+			}
+
+			ret->function.body->references = 1;
+
+			if(!(ret->function.body->node = sts_ast_marshal(script, value->function.body->node, NULL)))
+			{
+				STS_ERROR_SIMPLE("could not marshal function body");
+				sts_value_reference_decrement(script, ret);
+				return NULL;
+			}
+		break;
+		case STS_EXTERNAL:
+			STS_ERROR_SIMPLE("external values cannot be marshalled");
+			return NULL;
+		default:
+			if(!(ret = sts_value_create(script, value->type)))
+			{
+				STS_ERROR_SIMPLE("could not create value to marshal into");
+				return NULL;
+			}
+
+			if(value->type == STS_NUMBER)
+				ret->number = value->number;
+			else if(value->type == STS_BOOLEAN)
+				ret->boolean = value->boolean;
+		break;
+	}
+
+
+	return ret;
+}
+
+sts_node_t *sts_ast_marshal(sts_script_t *script, sts_node_t *node, sts_name_container_t *name)
+{
+	sts_node_t *ret = NULL, *progress = NULL, *temp = NULL;
+
+
+	if(!node)
+		return NULL;
+
+	if(!name)
+	{
+		if(!(name = calloc(1, sizeof(sts_name_container_t))) || !(name->script_name = sts_memdup(node->name->script_name, strlen(node->name->script_name))))
+		{
+			STS_ERROR_SIMPLE("could not create name container for marshalled ast");
+			if(name) free(name);
+			return NULL;
+		}
+	}
+
+	do
+	{
+		if(!STS_CREATE_NODE(temp))
+		{
+			STS_ERROR_SIMPLE("could not create marshalled node");
+			break;
+		}
+
+		temp->type = node->type;
+		temp->line = node->line;
+		temp->name = name;
+		name->references++;
+
+		if(progress)
+			progress->next = temp;
+		else
+			ret = temp;
+		progress = temp;
+
+		if(node->child && !(temp->child = sts_ast_marshal(script, node->child, name)))
+		{
+			STS_ERROR_SIMPLE("could not marshal child node");
+			break;
+		}
+
+		if(node->value)
+		{
+			if(!(temp->value = sts_value_marshal(script, node->value)))
+			{
+				STS_ERROR_SIMPLE("could not marshal node value");
+				break;
+			}
+
+			/* literals act just like they would if they were parsed by the script */
+			if(temp->value->type == STS_STRING && !(temp->value = sts_value_string_intern(script, temp->value)))
+			{
+				STS_ERROR_SIMPLE("could not intern marshalled literal");
+				break;
+			}
+
+			temp->value->readonly = 1;
+		}
+	} while((node = node->next));
+
+	if(node) /* broke out early */
+	{
+		sts_ast_delete(script, ret);
+		return NULL;
+	}
+
+
+	return ret;
+}
+
+sts_value_t *sts_function_call(sts_script_t *script, sts_value_t *function, sts_value_t *arguments)
+{
+	sts_scope_t *locals = NULL;
+	sts_value_t *ret = NULL, *extra = NULL, *argument = NULL;
+	unsigned int i;
+
+
+	if(!function || function->type != STS_FUNCTION)
+	{
+		STS_ERROR_SIMPLE("function value is null or not a function");
+		return NULL;
+	}
+
+	if(arguments && arguments->type != STS_ARRAY)
+	{
+		STS_ERROR_SIMPLE("function arguments must be an array");
+		return NULL;
+	}
+
+	if((arguments ? arguments->array.length : 0) < function->function.argument_identifiers->array.length)
+	{
+		STS_ERROR_SIMPLE("too few arguments provided to function");
+		return NULL;
+	}
+
+	if(!script->globals)
+		STS_SCOPE_PUSH(script->globals, {return NULL;});
+
+	locals = script->globals;
+
+	if(!(extra = sts_value_create(script, STS_ARRAY)))
+	{
+		STS_ERROR_SIMPLE("could not create elipses value");
+		return NULL;
+	}
+
+	STS_SCOPE_PUSH(locals, {sts_value_reference_decrement(script, extra); return NULL;});
+
+	if(!sts_map_add_set(&locals->locals, "...", strlen("..."), extra))
+	{
+		STS_ERROR_SIMPLE("could not add elipses to function scope");
+		sts_value_reference_decrement(script, extra);
+		STS_SCOPE_POP(locals, {});
+		return NULL;
+	}
+
+	for(i = 0; arguments && i < arguments->array.length; ++i)
+	{
+		argument = arguments->array.data[i];
+		STS_VALUE_REFINC(script, argument);
+
+		if(i < function->function.argument_identifiers->array.length)
+		{
+			if(!sts_map_add_set(&locals->locals, function->function.argument_identifiers->array.data[i]->string.data, function->function.argument_identifiers->array.data[i]->string.length, argument))
+			{
+				STS_ERROR_SIMPLE("could not add argument to function scope");
+				sts_value_reference_decrement(script, argument);
+				STS_SCOPE_POP(locals, {});
+				return NULL;
+			}
+		}
+		else
+			sts_array_append_insert(script, extra, argument, extra->array.length);
+	}
+
+	ret = sts_eval(script, function->function.body->node, locals, NULL, 0, 0);
+
+	STS_SCOPE_POP(locals, {STS_ERROR_SIMPLE("could not pop function scope");});
+
+
+	return ret;
+}
+
+sts_value_t *sts_array_copy_visited(sts_script_t *script, sts_value_t *source, sts_map_row_t **visited)
+{
+	sts_value_t *ret = NULL, *value = NULL;
+	sts_map_row_t *row = NULL;
+	unsigned int i;
+
+
+	if((row = sts_map_get(visited, &source, sizeof(sts_value_t *))))
+	{
+		ret = row->value;
+		STS_VALUE_REFINC(script, ret);
+		return ret;
+	}
+
+	if(!(ret = sts_value_create(script, STS_ARRAY)))
+		return NULL;
+
+	if(!(row = sts_map_add_set(visited, &source, sizeof(sts_value_t *), ret)))
+	{
+		STS_ERROR_SIMPLE("could not remember a copied array");
+		sts_value_reference_decrement(script, ret);
+		return NULL;
+	}
+	row->type = STS_ROW_VOID;
+
+	for(i = 0; i < source->array.length; ++i)
+	{
+		if(source->array.data[i]->type == STS_ARRAY)
+			value = sts_array_copy_visited(script, source->array.data[i], visited);
+		else if((value = sts_value_create(script, source->array.data[i]->type)) && sts_value_copy(script, value, source->array.data[i], 0))
+		{
+			sts_value_reference_decrement(script, value);
+			value = NULL;
+		}
+
+		if(!value)
+		{
+			STS_ERROR_SIMPLE("could not copy array member");
+			sts_value_reference_decrement(script, ret);
+			return NULL;
+		}
+
+		sts_array_append_insert(script, ret, value, ret->array.length);
+	}
+
+	return ret;
+}
+
+int sts_map_copy_values(sts_script_t *script, sts_map_row_t **dest, sts_map_row_t *source)
+{
+	sts_map_row_t *row = NULL, *last = NULL, *visited = NULL;
+	sts_value_t *value = NULL;
+
+
+	*dest = NULL;
+
+	for(; source; source = source->next)
+	{
+		if(!STS_CREATE_ROW(row))
+		{
+			STS_ERROR_SIMPLE("could not create row to copy into");
+			break;
+		}
+
+		row->hash = source->hash;
+		row->type = source->type;
+		row->value = source->value;
+
+		/* set writes into the value a name holds, so every value needs its own copy. Everything but arrays
+		shares what it points to, and the array elements are copied since insert and replace work in place */
+		if(source->type == STS_ROW_VALUE && source->value && ((sts_value_t *)source->value)->type == STS_ARRAY)
+		{
+			if(!(value = sts_array_copy_visited(script, source->value, &visited)))
+			{
+				STS_FREE(row);
+				break;
+			}
+
+			row->value = value;
+		}
+		else if(source->type == STS_ROW_VALUE && source->value)
+		{
+			if(!(value = sts_value_create(script, ((sts_value_t *)source->value)->type)))
+			{
+				STS_FREE(row);
+				break;
+			}
+
+			if(sts_value_copy(script, value, source->value, 0))
+			{
+				STS_ERROR_SIMPLE("could not copy map value");
+				sts_value_reference_decrement(script, value);
+				STS_FREE(row);
+				break;
+			}
+
+			row->value = value;
+		}
+
+		if(last)
+			last->next = row;
+		else
+			*dest = row;
+		last = row;
+	}
+
+	if(visited)
+		STS_DESTROY_MAP(visited, {});
+
+	if(source)
+	{
+		if(*dest)
+			STS_DESTROY_MAP(*dest, {});
+		*dest = NULL;
+		return 1;
+	}
+
+	return 0;
+}
+
+int sts_snapshot(sts_script_t *script)
+{
+	sts_map_row_t *snapshot = NULL;
+
+
+	if(!script->globals)
+		STS_SCOPE_PUSH(script->globals, {return 0;});
+
+	if(sts_map_copy_values(script, &snapshot, script->globals->locals))
+		return 0;
+
+	if(script->snapshot)
+		STS_DESTROY_MAP(script->snapshot, {STS_ERROR_SIMPLE("could not clean up the old snapshot");});
+	script->snapshot = snapshot;
+	script->snapshotted = 1;
+
+	return 1;
+}
+
+int sts_reset_to_snapshot(sts_script_t *script)
+{
+	sts_map_row_t *globals = NULL;
+
+
+	if(!script->globals)
+	{
+		STS_ERROR_SIMPLE("the script has no globals to reset");
+		return 0;
+	}
+
+	if(!script->snapshotted)
+	{
+		STS_ERROR_SIMPLE("the script has no snapshot to reset to");
+		return 0;
+	}
+
+	/* the snapshot is copied again so it stays untouched for the next reset */
+	if(sts_map_copy_values(script, &globals, script->snapshot))
+		return 0;
+
+	/* everything made since the snapshot is either referenced from the old globals or was already freed when the
+	scope it lived in was popped, so dropping them releases it all */
+	if(script->globals->locals)
+		STS_DESTROY_MAP(script->globals->locals, {STS_ERROR_SIMPLE("could not clean up the globals");});
+	script->globals->locals = globals;
+
+	#ifdef STS_CYCLE_COLLECTOR
+	sts_gc_collect(script); /* cycles are the exception, and nothing outside of the globals can reach them anymore */
+	#endif
+
+	return 1;
+}
+
+#endif
@@ -0,0 +1,549 @@
+/* this file is released into the public domain */
+
+/* a pool of worker threads for embedding. Every worker owns its own
+interpreter, so nothing but marshalled copies of values ever crosses
+a thread boundary. Needs pthreads */
+
+
+#ifndef STS_PARALLEL_H__
+#define STS_PARALLEL_H__
+
+#ifndef STS_EMBEDDING_EXTRAS_H__
+#include "sts_embedding_extras.h"
+#endif
+
+#include <pthread.h>
+
+
+typedef struct sts_pool_t sts_pool_t;
+typedef struct sts_pool_worker_t sts_pool_worker_t;
+typedef struct sts_pool_job_t sts_pool_job_t;
+typedef void (*sts_pool_job_func_t)(sts_pool_worker_t *worker, void *data);
+
+struct sts_pool_job_t
+{
+	sts_pool_job_t *next;
+	sts_pool_job_func_t func;
+	void *data;
+};
+
+struct sts_pool_worker_t
+{
+	sts_pool_t *pool;
+	pthread_t thread;
+	unsigned int id;
+	sts_script_t *script; /* only created once a job asks for it */
+	void *scratch; /* memory that jobs can reuse between runs on this worker */
+	unsigned long scratch_size;
+	sts_value_t **released; /* values of the worker script other threads are done with. The worker lets them go before its next job */
+	unsigned int released_length, released_allocated;
+};
+
+struct sts_pool_t
+{
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	sts_pool_job_t *head, *tail;
+	sts_pool_worker_t *workers;
+	unsigned int worker_count, shutdown;
+	sts_script_t template; /* the router and file callbacks every worker script starts with */
+};
+
+
+/* starts a pool of threads. 0 workers uses the amount of online cpus. The script is only used as a template */
+sts_pool_t *sts_pool_create(sts_script_t *script, unsigned int workers);
+
+/* runs whatever is still queued, then joins and frees every worker */
+void sts_pool_destroy(sts_pool_t *pool);
+
+/* queues a job. Jobs run in submission order but finish in any order */
+int sts_pool_submit(sts_pool_t *pool, sts_pool_job_func_t func, void *data);
+
+/* the interpreter that belongs to a worker. Only use it from inside a job running on that worker */
+sts_script_t *sts_pool_worker_script(sts_pool_worker_t *worker);
+
+/* grows and returns the worker scratch memory. Only use it from inside a job running on that worker */
+void *sts_pool_worker_scratch(sts_pool_worker_t *worker, unsigned long size);
+
+/* hands a value that belongs to the worker script back to the worker, which decrements it on its own thread. Can be used from any thread */
+int sts_pool_worker_release(sts_pool_worker_t *worker, sts_value_t *value);
+
+/* calls function on every member of array across the pool and returns an array of the results in order.
+Global functions of the script are copied into the workers so the function can call them */
+sts_value_t *sts_parallel_map(sts_pool_t *pool, sts_script_t *script, sts_value_t *function, sts_value_t *array, unsigned int workers);
+
+#endif /* end STS_PARALLEL_H__ */
+
+#ifdef STS_PARALLEL_IMPLEMENTATION
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef STS_PARALLEL_CHUNKS_PER_WORKER
+	#define STS_PARALLEL_CHUNKS_PER_WORKER 8 /* smaller chunks balance uneven work, bigger ones lock less */
+#endif
+
+
+typedef struct
+{
+	pthread_mutex_t lock;
+	pthread_cond_t done;
+	unsigned int next, chunk, running, failed;
+	sts_script_t *script;
+	sts_value_t *function, *array, **results;
+	sts_pool_worker_t **owners; /* the worker whose script each result belongs to */
+} sts_parallel_map_t;
+
+
+/* decrements what other threads released, since only this thread may touch the worker script */
+void sts_pool_worker_collect(sts_pool_worker_t *worker)
+{
+	sts_value_t **released = NULL;
+	unsigned int length, i;
+
+
+	pthread_mutex_lock(&worker->pool->lock);
+	released = worker->released;
+	length = worker->released_length;
+	worker->released = NULL;
+	worker->released_length = worker->released_allocated = 0;
+	pthread_mutex_unlock(&worker->pool->lock);
+
+	for(i = 0; i < length; ++i)
+		if(!sts_value_reference_decrement(worker->script, released[i]))
+			STS_ERROR_SIMPLE("could not decrement references for a released worker value");
+
+	if(released)
+		free(released);
+}
+
+void *sts_pool_thread(void *data)
+{
+	sts_pool_worker_t *worker = data;
+	sts_pool_t *pool = worker->pool;
+	sts_pool_job_t *job = NULL;
+
+
+	while(1)
+	{
+		pthread_mutex_lock(&pool->lock);
+
+		while(!pool->head && !pool->shutdown)
+			pthread_cond_wait(&pool->wake, &pool->lock);
+
+		if(!(job = pool->head)) /* only happens when shutting down */
+		{
+			pthread_mutex_unlock(&pool->lock);
+			break;
+		}
+
+		if(!(pool->head = job->next))
+			pool->tail = NULL;
+
+		pthread_mutex_unlock(&pool->lock);
+
+		sts_pool_worker_collect(worker);
+
+		job->func(worker, job->data);
+		free(job);
+
+		/* whatever a job printed shows up once it is done instead of when the pool goes away */
+		if(worker->script)
+			sts_output_flush(worker->script);
+	}
+
+	sts_pool_worker_collect(worker);
+
+	if(worker->script)
+	{
+		if(!sts_destroy(worker->script))
+			STS_ERROR_SIMPLE("could not clean up worker script");
+		free(worker->script);
+	}
+
+	if(worker->scratch)
+		free(worker->scratch);
+
+
+	return NULL;
+}
+
+sts_pool_t *sts_pool_create(sts_script_t *script, unsigned int workers)
+{
+	sts_pool_t *ret = NULL;
+	long cpus;
+	unsigned int i;
+
+
+	if(!workers)
+	{
+		cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		workers = cpus > 0 ? (unsigned int)cpus : 1;
+	}
+
+	if(!(ret = calloc(1, sizeof(sts_pool_t))) || !(ret->workers = calloc(workers, sizeof(sts_pool_worker_t))))
+	{
+		STS_ERROR_SIMPLE("could not allocate thread pool");
+		if(ret) free(ret);
+		return NULL;
+	}
+
+	ret->template.router = script->router;
+	ret->template.read_file = script->read_file;
+	ret->template.import_file = script->import_file;
+	ret->template.output.mode = script->output.mode;
+	ret->template.output.size = script->output.size;
+	ret->template.output.write = script->output.write; /* called from the worker threads */
+
+	pthread_mutex_init(&ret->lock, NULL);
+	pthread_cond_init(&ret->wake, NULL);
+
+	for(i = 0; i < workers; ++i)
+	{
+		ret->workers[i].pool = ret;
+		ret->workers[i].id = i;
+
+		if(pthread_create(&ret->workers[i].thread, NULL, &sts_pool_thread, &ret->workers[i]))
+		{
+			STS_ERROR_SIMPLE("could not start worker thread");
+			break;
+		}
+
+		ret->worker_count++;
+	}
+
+	if(!ret->worker_count)
+	{
+		sts_pool_destroy(ret);
+		return NULL;
+	}
+
+
+	return ret;
+}
+
+void sts_pool_destroy(sts_pool_t *pool)
+{
+	unsigned int i;
+
+
+	if(!pool)
+		return;
+
+	pthread_mutex_lock(&pool->lock);
+	pool->shutdown = 1;
+	pthread_cond_broadcast(&pool->wake);
+	pthread_mutex_unlock(&pool->lock);
+
+	for(i = 0; i < pool->worker_count; ++i)
+		pthread_join(pool->workers[i].thread, NULL);
+
+	pthread_cond_destroy(&pool->wake);
+	pthread_mutex_destroy(&pool->lock);
+
+	free(pool->workers);
+	free(pool);
+}
+
+int sts_pool_submit(sts_pool_t *pool, sts_pool_job_func_t func, void *data)
+{
+	sts_pool_job_t *job = NULL;
+
+
+	if(!(job = calloc(1, sizeof(sts_pool_job_t))))
+	{
+		STS_ERROR_SIMPLE("could not allocate pool job");
+		return 0;
+	}
+
+	job->func = func;
+	job->data = data;
+
+	pthread_mutex_lock(&pool->lock);
+
+	if(pool->tail)
+		pool->tail->next = job;
+	else
+		pool->head = job;
+	pool->tail = job;
+
+	pthread_cond_signal(&pool->wake);
+	pthread_mutex_unlock(&pool->lock);
+
+
+	return 1;
+}
+
+sts_script_t *sts_pool_worker_script(sts_pool_worker_t *worker)
+{
+	if(!worker->script)
+	{
+		if(!(worker->script = calloc(1, sizeof(sts_script_t))))
+		{
+			STS_ERROR_SIMPLE("could not allocate worker script");
+			return NULL;
+		}
+
+		/* userdata stays empty so the router knows it is on a worker */
+		worker->script->router = worker->pool->template.router;
+		worker->script->read_file = worker->pool->template.read_file;
+		worker->script->import_file = worker->pool->template.import_file;
+		worker->script->output.mode = worker->pool->template.output.mode;
+		worker->script->output.size = worker->pool->template.output.size;
+		worker->script->output.write = worker->pool->template.output.write;
+	}
+
+	return worker->script;
+}
+
+void *sts_pool_worker_scratch(sts_pool_worker_t *worker, unsigned long size)
+{
+	void *temp = NULL;
+
+
+	if(size > worker->scratch_size)
+	{
+		if(!(temp = realloc(worker->scratch, size)))
+		{
+			STS_ERROR_SIMPLE("could not grow worker scratch memory");
+			return NULL;
+		}
+
+		worker->scratch = temp;
+		worker->scratch_size = size;
+	}
+
+	return worker->scratch;
+}
+
+int sts_pool_worker_release(sts_pool_worker_t *worker, sts_value_t *value)
+{
+	sts_value_t **temp = NULL;
+
+
+	pthread_mutex_lock(&worker->pool->lock);
+
+	if(worker->released_length + 1 > worker->released_allocated)
+	{
+		if(!(temp = realloc(worker->released, (worker->released_allocated * 2 + 8) * sizeof(sts_value_t *))))
+		{
+			pthread_mutex_unlock(&worker->pool->lock);
+			STS_ERROR_SIMPLE("could not grow worker release list");
+			return 0;
+		}
+
+		worker->released = temp;
+		worker->released_allocated = worker->released_allocated * 2 + 8;
+	}
+
+	worker->released[worker->released_length++] = value;
+
+	pthread_mutex_unlock(&worker->pool->lock);
+
+	return 1;
+}
+
+/* replaces the worker globals with copies of the caller's global functions */
+int sts_parallel_prepare(sts_script_t *worker_script, sts_script_t *script)
+{
+	sts_map_row_t *row = NULL, *new_row = NULL;
+	sts_value_t *temp = NULL;
+
+
+	if(worker_script->globals)
+		STS_SCOPE_POP(worker_script->globals, {STS_ERROR_SIMPLE("could not clear worker globals"); return 0;});
+
+	STS_SCOPE_PUSH(worker_script->globals, {return 0;});
+
+	if(!script->globals)
+		return 1;
+
+	for(row = script->globals->locals; row; row = row->next)
+	{
+		if(row->type != STS_ROW_VALUE || !row->value || ((sts_value_t *)row->value)->type != STS_FUNCTION)
+			continue;
+
+		if(!(temp = sts_value_marshal(worker_script, row->value)))
+		{
+			STS_ERROR_SIMPLE("could not copy global function into worker");
+			return 0;
+		}
+
+		/* rows only keep the hash of their name, so the row is copied directly */
+		if(!STS_CREATE_ROW(new_row))
+		{
+			STS_ERROR_SIMPLE("could not create global row in worker");
+			sts_value_reference_decrement(worker_script, temp);
+			return 0;
+		}
+
+		new_row->hash = row->hash;
+		new_row->value = temp;
+		new_row->next = worker_script->globals->locals;
+		worker_script->globals->locals = new_row;
+	}
+
+	return 1;
+}
+
+void sts_parallel_map_job(sts_pool_worker_t *worker, void *data)
+{
+	sts_parallel_map_t *map = data;
+	sts_script_t *worker_script = NULL;
+	sts_value_t *function = NULL, *arguments = NULL, *argument = NULL;
+	unsigned int i, start, end;
+
+
+	if(!(worker_script = sts_pool_worker_script(worker)) || !sts_parallel_prepare(worker_script, map->script) || !(function = sts_value_marshal(worker_script, map->function)) || !(arguments = sts_value_create(worker_script, STS_ARRAY)))
+	{
+		STS_ERROR_SIMPLE("could not prepare worker for parallel map");
+		if(function) sts_value_reference_decrement(worker_script, function);
+		pthread_mutex_lock(&map->lock);
+		map->failed = 1;
+		goto finish;
+	}
+
+	while(1)
+	{
+		pthread_mutex_lock(&map->lock);
+
+		if(map->failed || map->next >= map->array->array.length)
+			break;
+
+		start = map->next;
+		end = start + map->chunk > map->array->array.length ? map->array->array.length : start + map->chunk;
+		map->next = end;
+
+		pthread_mutex_unlock(&map->lock);
+
+		for(i = start; i < end; ++i)
+		{
+			if(!(argument = sts_value_marshal(worker_script, map->array->array.data[i])))
+			{
+				STS_ERROR_SIMPLE("could not marshal parallel map argument");
+				pthread_mutex_lock(&map->lock);
+				map->failed = 1;
+				pthread_mutex_unlock(&map->lock);
+				break;
+			}
+
+			sts_array_append_insert(worker_script, arguments, argument, 0);
+
+			if(!(map->results[i] = sts_function_call(worker_script, function, arguments)))
+				STS_ERROR_SIMPLE("function failed in parallel map");
+
+			map->owners[i] = worker;
+
+			if(!sts_array_remove(worker_script, arguments, 0))
+				STS_ERROR_SIMPLE("could not remove parallel map argument");
+		}
+	}
+
+	/* still locked from the loop */
+	sts_value_reference_decrement(worker_script, arguments);
+	sts_value_reference_decrement(worker_script, function);
+finish:
+	if(!--map->running)
+		pthread_cond_signal(&map->done);
+	pthread_mutex_unlock(&map->lock);
+}
+
+sts_value_t *sts_parallel_map(sts_pool_t *pool, sts_script_t *script, sts_value_t *function, sts_value_t *array, unsigned int workers)
+{
+	sts_parallel_map_t map;
+	sts_value_t *ret = NULL, *temp = NULL;
+	unsigned int i, jobs = 0;
+
+
+	if(!function || function->type != STS_FUNCTION || !array || array->type != STS_ARRAY)
+	{
+		STS_ERROR_SIMPLE("parallel map requires a function and an array");
+		return NULL;
+	}
+
+	if(!(ret = sts_value_create(script, STS_ARRAY)))
+		return NULL;
+
+	if(!array->array.length)
+		return ret;
+
+	if(!workers || workers > pool->worker_count)
+		workers = pool->worker_count;
+	if(workers > array->array.length)
+		workers = array->array.length;
+
+	memset(&map, 0, sizeof(map));
+	map.script = script;
+	map.function = function;
+	map.array = array;
+	map.chunk = array->array.length / (workers * STS_PARALLEL_CHUNKS_PER_WORKER);
+	if(!map.chunk)
+		map.chunk = 1;
+
+	if(!(map.results = calloc(array->array.length, sizeof(sts_value_t *))) || !(map.owners = calloc(array->array.length, sizeof(sts_pool_worker_t *))))
+	{
+		STS_ERROR_SIMPLE("could not allocate parallel map results");
+		if(map.results) free(map.results);
+		sts_value_reference_decrement(script, ret);
+		return NULL;
+	}
+
+	pthread_mutex_init(&map.lock, NULL);
+	pthread_cond_init(&map.done, NULL);
+
+	/* the caller does nothing but wait, so the workers can safely read its values */
+	pthread_mutex_lock(&map.lock);
+	for(i = 0; i < workers; ++i)
+	{
+		map.running++;
+		if(!sts_pool_submit(pool, &sts_parallel_map_job, &map))
+		{
+			map.running--;
+			break;
+		}
+		jobs++;
+	}
+
+	while(map.running)
+		pthread_cond_wait(&map.done, &map.lock);
+	pthread_mutex_unlock(&map.lock);
+
+	if(!jobs)
+		map.failed = 1;
+
+	/* bring the results back, then hand the worker copies back to be let go on their own threads. Another caller
+	may already have the workers busy again, so they can't be decremented from here */
+	for(i = 0; i < array->array.length; ++i)
+	{
+		if(!map.failed && map.results[i])
+		{
+			if(!(temp = sts_value_marshal(script, map.results[i])))
+				map.failed = 1;
+			else
+				sts_array_append_insert(script, ret, temp, ret->array.length);
+		}
+		else
+			map.failed = 1;
+
+		if(map.results[i] && !sts_pool_worker_release(map.owners[i], map.results[i]))
+			STS_ERROR_SIMPLE("could not release a worker result");
+	}
+
+	pthread_cond_destroy(&map.done);
+	pthread_mutex_destroy(&map.lock);
+	free(map.results);
+	free(map.owners);
+
+	if(map.failed)
+	{
+		sts_value_reference_decrement(script, ret);
+		return NULL;
+	}
+
+
+	return ret;
+}
+
+#endif